@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    BenchmarkMain.cpp
+    Created: 17 Oct 2026 11:59:31pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "EngineBenchmark.h"
+#include <iostream>
+
+// runs the engine benchmarks without a window or an audio device and prints the results as JSON, or writes them
+// to --output=results.json, at --sample-rate=44100 in blocks of --block-size=512. --benchmark-track=song.mp3 adds
+// a real track to the load and seek benchmarks, and can be repeated. --checks-only runs just the benchmarks whose
+// results are checked. the exit code is 1 if the benchmarks could not run and 2 if a check failed
+int main(int argc, char* argv[])
+{
+    // the engine hands loaded tracks over on the message thread, so there needs to be one even with nothing to show
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::String outputPath;
+    juce::StringArray tracks;
+    bool checksOnly = false;
+    double sampleRate = 44100;
+    int blockSize = 512;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String argument(argv[i]);
+
+        if (argument.startsWith("--output="))
+        {
+            outputPath = argument.fromFirstOccurrenceOf("=", false, false).unquoted();
+        }
+
+        if (argument.startsWith("--benchmark-track="))
+        {
+            tracks.add(argument.fromFirstOccurrenceOf("=", false, false).unquoted());
+        }
+
+        if (argument.startsWith("--sample-rate="))
+        {
+            sampleRate = juce::jlimit(8000.0, 384000.0, argument.fromFirstOccurrenceOf("=", false, false).getDoubleValue());
+        }
+
+        if (argument == "--checks-only")
+        {
+            checksOnly = true;
+        }
+
+        if (argument.startsWith("--block-size="))
+        {
+            blockSize = juce::jlimit(16, 8192, argument.fromFirstOccurrenceOf("=", false, false).getIntValue());
+        }
+    }
+
+    EngineBenchmark benchmark(sampleRate, blockSize);
+    benchmark.setChecksOnly(checksOnly);
+
+    for (auto& track : tracks)
+    {
+        benchmark.addTrack(juce::File::getCurrentWorkingDirectory().getChildFile(track));
+    }
+
+    juce::var results;
+    juce::String error;
+
+    if (benchmark.run(results, error) == false)
+    {
+        std::cerr << "otodecks-bench: " << error << std::endl;
+        return 1;
+    }
+
+    juce::String json = juce::JSON::toString(results);
+
+    if (outputPath.isEmpty())
+    {
+        std::cout << json << std::endl;
+    }
+
+    else
+    {
+        juce::File output = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath);
+
+        if (output.replaceWithText(json) == false)
+        {
+            std::cerr << "otodecks-bench: cannot write " << output.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    for (auto& failure : benchmark.getFailedChecks())
+    {
+        std::cerr << "otodecks-bench: check failed, " << failure << std::endl;
+    }
+
+    return benchmark.getFailedChecks().isEmpty() ? 0 : 2;
+}
\ No newline at end of file
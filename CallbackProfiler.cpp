@@ -0,0 +1,303 @@
+/*
+  ==============================================================================
+
+    CallbackProfiler.cpp
+    Created: 17 Oct 2026 7:02:41pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "CallbackProfiler.h"
+#include <fstream>
+
+CallbackProfiler::CallbackProfiler(int _maxDecks) :
+                                   decks((size_t) juce::jmax(1, _maxDecks)),
+                                   startTicks(juce::Time::getHighResolutionTicks()),
+                                   misses(maxMisses),
+                                   missDeckLoads((size_t) (maxMisses * juce::jmax(1, _maxDecks))),
+                                   actions(maxActions),
+                                   commands(maxCommands)
+{
+    for (auto& count : histogram)
+    {
+        count = 0;
+    }
+}
+
+CallbackProfiler::~CallbackProfiler()
+{
+
+}
+
+void CallbackProfiler::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    juce::ignoreUnused(samplesPerBlockExpected);
+    sampleRate = newSampleRate;
+    lastCallbackTicks = 0;
+}
+
+juce::int64 CallbackProfiler::startCallback()
+{
+    return juce::Time::getHighResolutionTicks();
+}
+
+void CallbackProfiler::endCallback(juce::int64 callbackStartTicks, int numSamples)
+{
+    if (sampleRate <= 0 || numSamples <= 0)
+    {
+        return;
+    }
+
+    juce::int64 endTicks = juce::Time::getHighResolutionTicks();
+    juce::int64 blockTicks = juce::Time::secondsToHighResolutionTicks(numSamples / sampleRate);
+    float load = (float) (endTicks - callbackStartTicks) / (float) juce::jmax((juce::int64) 1, blockTicks);
+
+    // the device has dropped audio when a callback starts much later than the last block ran out
+    bool xrun = lastCallbackTicks > 0 && callbackStartTicks - lastCallbackTicks > (juce::int64) ((double) lastBlockTicks * xrunGap);
+    lastCallbackTicks = callbackStartTicks;
+    lastBlockTicks = blockTicks;
+
+    juce::int64 callback = numCallbacks++;
+    lastLoad = load;
+    peakLoad = juce::jmax(peakLoad.load(), load);
+    totalLoad = totalLoad + load;
+    histogram[juce::jlimit(0, numHistogramBins - 1, (int) (load / binWidth))]++;
+
+    if (load > 1.0f)
+    {
+        numDeadlineMisses++;
+    }
+
+    if (xrun)
+    {
+        numXruns++;
+    }
+
+    // hand each deck's time for this callback over to its load
+    int maxDecks = getMaxDecks();
+    int missIndex = numMisses % maxMisses;
+
+    for (int i = 0; i < maxDecks; ++i)
+    {
+        auto& deck = decks[(size_t) i];
+        float deckLoad = (float) deck.blockTicks.exchange(0) / (float) juce::jmax((juce::int64) 1, blockTicks);
+        deck.load = deckLoad;
+        deck.peakLoad = juce::jmax(deck.peakLoad.load(), deckLoad);
+    }
+
+    // only a miss takes a slot, so a full ring keeps the loads of the miss it holds until the next one replaces it
+    if (load > 1.0f || xrun)
+    {
+        for (int i = 0; i < maxDecks; ++i)
+        {
+            missDeckLoads[(size_t) (missIndex * maxDecks + i)] = decks[(size_t) i].load;
+        }
+
+        auto& miss = misses[(size_t) missIndex];
+        miss.time = getTime(callbackStartTicks);
+        miss.callback = callback;
+        miss.load = load;
+        miss.xrun = xrun;
+        numMisses++;
+    }
+}
+
+void CallbackProfiler::addDeckTime(int deck, juce::int64 deckStartTicks, juce::int64 deckEndTicks)
+{
+    if (juce::isPositiveAndBelow(deck, getMaxDecks()))
+    {
+        decks[(size_t) deck].blockTicks += deckEndTicks - deckStartTicks;
+    }
+}
+
+void CallbackProfiler::logAction(int deck, const juce::String& description)
+{
+    const juce::ScopedLock lock(actionLock);
+
+    auto& action = actions[(size_t) (numActions % maxActions)];
+    action.time = getTime(juce::Time::getHighResolutionTicks());
+    action.deck = deck;
+    action.description = description;
+    numActions++;
+}
+
+void CallbackProfiler::logCommand(int deck, const char* name, double value)
+{
+    juce::int64 index = numCommands++;
+    auto& command = commands[(size_t) (index % maxCommands)];
+
+    // mark the slot as being written before any of it changes, as in a sequence lock
+    command.sequence.store(-1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    command.ticks.store(juce::Time::getHighResolutionTicks(), std::memory_order_relaxed);
+    command.deck.store(deck, std::memory_order_relaxed);
+    command.name.store(name, std::memory_order_relaxed);
+    command.value.store(value, std::memory_order_relaxed);
+    command.sequence.store(index, std::memory_order_release);
+}
+
+juce::int64 CallbackProfiler::getNumCallbacks()
+{
+    return numCallbacks;
+}
+
+int CallbackProfiler::getNumDeadlineMisses()
+{
+    return numDeadlineMisses;
+}
+
+int CallbackProfiler::getNumXruns()
+{
+    return numXruns;
+}
+
+float CallbackProfiler::getLastLoad()
+{
+    return lastLoad;
+}
+
+float CallbackProfiler::getAverageLoad()
+{
+    juce::int64 callbacks = numCallbacks;
+
+    return callbacks > 0 ? (float) (totalLoad / (double) callbacks) : 0.0f;
+}
+
+float CallbackProfiler::getPeakLoad()
+{
+    return peakLoad;
+}
+
+float CallbackProfiler::getDeckLoad(int deck)
+{
+    return juce::isPositiveAndBelow(deck, getMaxDecks()) ? decks[(size_t) deck].load.load() : 0.0f;
+}
+
+float CallbackProfiler::getDeckPeakLoad(int deck)
+{
+    return juce::isPositiveAndBelow(deck, getMaxDecks()) ? decks[(size_t) deck].peakLoad.load() : 0.0f;
+}
+
+int CallbackProfiler::getMaxDecks()
+{
+    return (int) decks.size();
+}
+
+int CallbackProfiler::getHistogramCount(int bin)
+{
+    return juce::isPositiveAndBelow(bin, numHistogramBins) ? histogram[bin].load() : 0;
+}
+
+void CallbackProfiler::resetPeaks()
+{
+    peakLoad = 0;
+
+    for (auto& deck : decks)
+    {
+        deck.peakLoad = 0;
+    }
+}
+
+bool CallbackProfiler::writeLog(const juce::File& file)
+{
+    std::ofstream log(file.getFullPathName().toStdString());
+
+    if (log.is_open() == false)
+    {
+        DBG("CallbackProfiler::writeLog could not open " << file.getFullPathName());
+        return false;
+    }
+
+    log << "callbacks " << getNumCallbacks() << ", deadline misses " << getNumDeadlineMisses() << ", xruns " << getNumXruns() << "\n";
+    log << "load average " << getAverageLoad() << ", peak " << getPeakLoad() << "\n";
+
+    for (int i = 0; i < getMaxDecks(); ++i)
+    {
+        if (getDeckPeakLoad(i) > 0)
+        {
+            log << "deck " << i + 1 << " load peak " << getDeckPeakLoad(i) << "\n";
+        }
+    }
+
+    log << "\nload histogram\n";
+
+    for (int bin = 0; bin < numHistogramBins; ++bin)
+    {
+        int percent = juce::roundToInt((float) bin * binWidth * 100);
+        log << percent << (bin == numHistogramBins - 1 ? "%+ " : "% ") << getHistogramCount(bin) << "\n";
+    }
+
+    // merge the misses with the actions and commands around them into one timeline, oldest first
+    std::vector<std::pair<double, juce::String>> timeline;
+    int maxDecks = getMaxDecks();
+    int missCount = numMisses;
+
+    for (int i = juce::jmax(0, missCount - maxMisses); i < missCount; ++i)
+    {
+        auto& miss = misses[(size_t) (i % maxMisses)];
+        juce::String line = juce::String(miss.xrun ? "XRUN" : "MISS") + " callback " + juce::String(miss.callback)
+                            + " load " + juce::String(miss.load) + ", decks";
+
+        for (int deck = 0; deck < maxDecks; ++deck)
+        {
+            line << " " << missDeckLoads[(size_t) ((i % maxMisses) * maxDecks + deck)];
+        }
+
+        timeline.push_back({ miss.time, line });
+    }
+
+    {
+        const juce::ScopedLock lock(actionLock);
+
+        for (int i = juce::jmax(0, numActions - maxActions); i < numActions; ++i)
+        {
+            auto& action = actions[(size_t) (i % maxActions)];
+            timeline.push_back({ action.time, getSubject(action.deck) + action.description });
+        }
+    }
+
+    juce::int64 commandCount = numCommands;
+
+    for (juce::int64 i = juce::jmax((juce::int64) 0, commandCount - maxCommands); i < commandCount; ++i)
+    {
+        auto& command = commands[(size_t) (i % maxCommands)];
+        juce::int64 sequence = command.sequence.load(std::memory_order_acquire);
+        juce::int64 ticks = command.ticks.load(std::memory_order_relaxed);
+        int deck = command.deck.load(std::memory_order_relaxed);
+        const char* name = command.name.load(std::memory_order_relaxed);
+        double value = command.value.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // skip a command that has not finished being written, or whose slot was reused while it was read
+        if (sequence != i || command.sequence.load(std::memory_order_relaxed) != i || name == nullptr)
+        {
+            continue;
+        }
+
+        timeline.push_back({ getTime(ticks), getSubject(deck) + name + " " + juce::String(value, 3) });
+    }
+
+    std::stable_sort(timeline.begin(), timeline.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    log << "\ntimeline in seconds since start\n";
+
+    for (auto& entry : timeline)
+    {
+        log << juce::String(entry.first, 3) << " " << entry.second << "\n";
+    }
+
+    log.close();
+    return true;
+}
+
+juce::String CallbackProfiler::getSubject(int deck)
+{
+    return deck < 0 ? juce::String("engine ") : "deck " + juce::String(deck + 1) + " ";
+}
+
+double CallbackProfiler::getTime(juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks - startTicks);
+}
\ No newline at end of file
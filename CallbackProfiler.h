@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    CallbackProfiler.h
+    Created: 17 Oct 2026 7:02:41pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// always-on timing of every audio callback and of each deck within it, kept in lock-free counters and a
+// histogram of render time as a fraction of the block's budget, with the blocks that missed their deadline
+// and the actions taken on the decks logged side by side so that glitches can be traced back to them
+class CallbackProfiler
+{
+public:
+    CallbackProfiler(int _maxDecks);
+    ~CallbackProfiler();
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    // bracket one audio callback, on the audio thread
+    juce::int64 startCallback();
+    void endCallback(juce::int64 startTicks, int numSamples);
+
+    // add the time a deck spent rendering to the current callback, on whichever thread rendered it
+    void addDeckTime(int deck, juce::int64 startTicks, juce::int64 endTicks);
+
+    // note something done to a deck, on the message thread, or to the whole engine with deck -1
+    void logAction(int deck, const juce::String& description);
+
+    // note a command pushed to a deck, from any thread and without locking or allocating. name must outlive the
+    // profiler, such as a string literal, as it is only read when the log is written
+    void logCommand(int deck, const char* name, double value);
+
+    juce::int64 getNumCallbacks();
+    int getNumDeadlineMisses();
+    int getNumXruns();
+
+    // loads are render time divided by the time the block lasts, so 1 is a missed deadline
+    float getLastLoad();
+    float getAverageLoad();
+    float getPeakLoad();
+    float getDeckLoad(int deck);
+    float getDeckPeakLoad(int deck);
+    int getMaxDecks();
+
+    // the histogram splits loads into binWidth steps, with everything from the last step up in the final bin
+    int getHistogramCount(int bin);
+
+    void resetPeaks();
+
+    // write the summary, histogram and time-ordered misses and actions, once the audio has stopped
+    bool writeLog(const juce::File& file);
+
+    static constexpr int numHistogramBins = 21;
+    static constexpr float binWidth = 0.1f;
+    static constexpr int maxMisses = 512;
+    static constexpr int maxActions = 4096;
+    static constexpr int maxCommands = 4096;
+
+    // a gap between callbacks this many blocks long means the device dropped audio
+    static constexpr double xrunGap = 1.5;
+
+private:
+    struct Deck
+    {
+        std::atomic<juce::int64> blockTicks{ 0 };
+        std::atomic<float> load{ 0 };
+        std::atomic<float> peakLoad{ 0 };
+    };
+
+    struct Miss
+    {
+        double time = 0;
+        juce::int64 callback = 0;
+        float load = 0;
+        bool xrun = false;
+    };
+
+    struct Action
+    {
+        double time = 0;
+        int deck = -1;
+        juce::String description;
+    };
+
+    // sequence is the command's number once it is written and -1 while it is being written, so that the log
+    // can skip a slot that a producer is reusing as it reads it
+    struct Command
+    {
+        std::atomic<juce::int64> sequence{ -1 };
+        std::atomic<juce::int64> ticks{ 0 };
+        std::atomic<int> deck{ -1 };
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<double> value{ 0 };
+    };
+
+    double getTime(juce::int64 ticks);
+    juce::String getSubject(int deck);
+
+    std::vector<Deck> decks;
+    juce::int64 startTicks;
+    double sampleRate = 0;
+
+    std::atomic<juce::int64> numCallbacks{ 0 };
+    std::atomic<int> numDeadlineMisses{ 0 };
+    std::atomic<int> numXruns{ 0 };
+    std::atomic<float> lastLoad{ 0 };
+    std::atomic<float> peakLoad{ 0 };
+    std::atomic<double> totalLoad{ 0 };
+    std::atomic<int> histogram[numHistogramBins];
+    juce::int64 lastCallbackTicks = 0;
+    juce::int64 lastBlockTicks = 0;
+
+    // the audio thread writes misses round a fixed ring along with each deck's load in that block,
+    // and nothing reads them until the audio has stopped
+    std::vector<Miss> misses;
+    std::vector<float> missDeckLoads;
+    std::atomic<int> numMisses{ 0 };
+
+    // actions only come from the message thread, but the lock keeps logAction safe to call from anywhere else
+    std::vector<Action> actions;
+    int numActions = 0;
+    juce::CriticalSection actionLock;
+
+    // commands can come from several controller threads at once, each claiming the next slot of the ring
+    std::vector<Command> commands;
+    std::atomic<juce::int64> numCommands{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CallbackProfiler)
+};
\ No newline at end of file
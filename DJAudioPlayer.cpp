@@ -1,125 +1,1168 @@
-/*
-  ==============================================================================
-
-    DJAudioPlayer.cpp
-    Created: 29 Jan 2023 4:20:02pm
-    Author:  cheng
-
-  ==============================================================================
-*/
-
-#include "DJAudioPlayer.h"
-
-DJAudioPlayer::DJAudioPlayer(juce::AudioFormatManager& _formatManager) : formatManager(_formatManager)
-{
-
-}
-
-DJAudioPlayer::~DJAudioPlayer()
-{
-
-}
-
-void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
-{
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-}
-
-void DJAudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
-{
-    resampleSource.getNextAudioBlock(bufferToFill);
-}
-
-void DJAudioPlayer::releaseResources()
-{
-    transportSource.releaseResources();
-    resampleSource.releaseResources();
-}
-
-void DJAudioPlayer::loadURL(juce::URL audioURL)
-{
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
-
-    if (reader != nullptr)
-    {
-        std::unique_ptr<juce::AudioFormatReaderSource> newSource(new juce::AudioFormatReaderSource(reader, true));
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        readerSource.reset(newSource.release());
-    }
-}
-
-void DJAudioPlayer::setGain(double gain)
-{
-    if (gain < 0 || gain > 2)
-    {
-        DBG("DJAudioPlayer::setGain gain should be between 0 and 2");
-    }
-
-    else
-    {
-        transportSource.setGain(gain);
-    }
-}
-
-void DJAudioPlayer::setSpeed(double ratio)
-{
-    if (ratio <= 0 || ratio > 2)
-    {
-        DBG("DJAudioPlayer::setSpeed ratio should be between 0 and 2");
-    }
-
-    else
-    {
-        resampleSource.setResamplingRatio(ratio);
-    }
-}
-
-void DJAudioPlayer::setPosition(double posInSecs)
-{
-    transportSource.setPosition(posInSecs);
-}
-
-void DJAudioPlayer::setPositionRelative(double pos)
-{
-    if (pos < 0 || pos > 1)
-    {
-        DBG("DJAudioPlayer::setPositionRelative pos should be between 0 and 1");
-    }
-
-    else
-    {
-        double posInSecs = transportSource.getLengthInSeconds() * pos;
-        setPosition(posInSecs);
-    }
-}
-
-bool DJAudioPlayer::isPlaying()
-{
-    return transportSource.isPlaying();
-}
-
-void DJAudioPlayer::start()
-{
-    transportSource.start();
-}
-
-void DJAudioPlayer::stop()
-{
-    transportSource.stop();
-}
-
-double DJAudioPlayer::getPositionRelative()
-{
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
-}
-
-double DJAudioPlayer::getPosition()
-{
-    return transportSource.getCurrentPosition();
-}
-
-double DJAudioPlayer::getLength()
-{
-    return transportSource.getLengthInSeconds();
+/*
+  ==============================================================================
+
+    DJAudioPlayer.cpp
+    Created: 29 Jan 2023 4:20:02pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "DJAudioPlayer.h"
+
+namespace
+{
+    // names of the command types as they appear in the profiler's log, in the order of DeckCommand::Type
+    const char* commandNames[] = { "gain", "speed", "position", "keylock", "loop start", "loop end", "looping",
+                                   "eq low", "eq mid", "eq high", "filter", "bpm", "first beat", "sync",
+                                   "hot cue" };
+}
+
+DJAudioPlayer::DJAudioPlayer(juce::AudioFormatManager& _formatManager,
+                             juce::TimeSliceThread& _readAheadThread) :
+                             formatManager(_formatManager),
+                             readAheadThread(_readAheadThread)
+{
+    gainSmoother.setCurrentAndTargetValue(1.0f);
+    speedSmoother.setCurrentAndTargetValue(1.0);
+
+    for (int i = 0; i < numHotCues; ++i)
+    {
+        hotCues[i] = -1.0;
+        publishedCueSeams[i] = -1;
+    }
+}
+
+DJAudioPlayer::~DJAudioPlayer()
+{
+    // wait for any track still being prepared before its sources are torn down, and stop seams queueing themselves again
+    stopping = true;
+    loaderPool.removeAllJobs(true, 10000);
+}
+
+void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    currentBlockSize = samplesPerBlockExpected;
+    currentSampleRate = sampleRate;
+
+    // ramp gain over 20 ms and speed over 50 ms so that knob movements never step
+    gainSmoother.reset(sampleRate, 0.02);
+    speedSmoother.reset(sampleRate, 0.05);
+    gainRamp.resize((size_t) samplesPerBlockExpected);
+
+    updateResamplingRatio(0);
+    eqSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void DJAudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // apply everything the message thread has queued since the last block
+    commandQueue.drain([this](const DeckCommand& command) { applyCommand(command); });
+    updateLoopSeam();
+    updateBeatClock();
+
+    double startRate = playbackRate;
+    updateResamplingRatio(bufferToFill.numSamples);
+    bool underrun = false;
+
+    // check whether the read-ahead buffer holds every sample this block is about to pull,
+    // never waiting for the lock so that the audio thread is not held up by a track being loaded
+    if (transportSource.isPlaying() && currentSampleRate > 0)
+    {
+        const juce::SpinLock::ScopedTryLockType lock(bufferingSourceLock);
+
+        // while a loop plays from its seam the buffering source is refilling from where the seam ends
+        if (lock.isLocked() && bufferingSource != nullptr && loopingSource->isPlayingFromSeam() == false)
+        {
+            int samplesNeeded = (int) std::ceil(bufferToFill.numSamples * speedRatio.load() * fileSampleRate.load() / currentSampleRate);
+            juce::AudioSourceChannelInfo blockAhead(nullptr, 0, samplesNeeded);
+
+            if (bufferingSource->waitForNextAudioBlockReady(blockAhead, 0) == false)
+            {
+                underrunCount++;
+                underrunSamples += samplesNeeded;
+                underrun = true;
+            }
+        }
+    }
+
+    bool playing = transportSource.isPlaying();
+
+    eqSource.getNextAudioBlock(bufferToFill);
+    applyGain(bufferToFill);
+    advanceBeatClock(bufferToFill.numSamples, startRate, playbackRate);
+
+    // a triggered cue has been heard once a block plays without waiting on the read-ahead buffer
+    if (playing && underrun == false)
+    {
+        recordHotCueLatency();
+    }
+
+    releaseCueSeam();
+}
+
+void DJAudioPlayer::releaseResources()
+{
+    eqSource.releaseResources();
+}
+
+bool DJAudioPlayer::loadURL(juce::URL audioURL)
+{
+    double requestTime = juce::Time::getMillisecondCounterHiRes();
+
+    // a synchronous load supersedes any load still running in the background
+    loadGeneration++;
+    loading = false;
+
+    if (publishTrack(*prepareTrack(audioURL)))
+    {
+        recordLoadLatency(requestTime);
+        return true;
+    }
+
+    return false;
+}
+
+void DJAudioPlayer::loadURLAsync(juce::URL audioURL, std::function<void(bool)> onLoaded)
+{
+    double requestTime = juce::Time::getMillisecondCounterHiRes();
+    int generation = ++loadGeneration;
+    loading = true;
+
+    juce::WeakReference<DJAudioPlayer> weakThis(this);
+
+    loaderPool.addJob([this, weakThis, audioURL, onLoaded, generation, requestTime]
+    {
+        // skip the work if another track has been requested in the meantime
+        if (generation != loadGeneration)
+        {
+            return;
+        }
+
+        std::shared_ptr<PreparedTrack> track(prepareTrack(audioURL).release());
+
+        juce::MessageManager::callAsync([weakThis, track, onLoaded, generation, requestTime]
+        {
+            if (weakThis == nullptr || generation != weakThis->loadGeneration)
+            {
+                return;
+            }
+
+            bool loaded = weakThis->publishTrack(*track);
+            weakThis->loading = false;
+
+            if (loaded)
+            {
+                weakThis->recordLoadLatency(requestTime);
+            }
+
+            if (onLoaded != nullptr)
+            {
+                onLoaded(loaded);
+            }
+        });
+    });
+}
+
+bool DJAudioPlayer::isLoading()
+{
+    return loading;
+}
+
+double DJAudioPlayer::getLastLoadLatency()
+{
+    return lastLoadLatency;
+}
+
+double DJAudioPlayer::getAverageLoadLatency()
+{
+    return numLoads > 0 ? totalLoadLatency / numLoads : 0;
+}
+
+// open the track and fill its read-ahead buffer, safe to call from any thread
+std::unique_ptr<DJAudioPlayer::PreparedTrack> DJAudioPlayer::prepareTrack(juce::URL audioURL)
+{
+    auto track = std::make_unique<PreparedTrack>();
+    track->url = audioURL;
+    juce::AudioFormatReader* reader = nullptr;
+    bool fullyResident = false;
+
+    // the settings can change on other threads while this runs, so each is read once
+    TrackCache* cache = trackCache;
+    int readAhead = readAheadSize;
+    int blockSize = currentBlockSize;
+    double sampleRate = currentSampleRate;
+
+    // read uncompressed files through a memory-mapped window, so blocks come straight from the page cache
+    if (memoryMappingEnabled && audioURL.isLocalFile())
+    {
+        track->mappedReader = MappedTrackReader::createFor(audioURL.getLocalFile());
+        reader = track->mappedReader;
+    }
+
+    // read MP3 files through their frame index, so that a seek never makes the decoder scan up to the target
+    if (reader == nullptr && seekIndexEnabled && audioURL.isLocalFile())
+    {
+        reader = SeekIndexedReader::createFor(audioURL.getLocalFile(), formatManager);
+        track->seekIndexed = reader != nullptr;
+    }
+
+    if (reader == nullptr)
+    {
+        reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+    }
+
+    // read through the track cache so that samples come from RAM as soon as they have been decoded
+    if (reader != nullptr && cache != nullptr && audioURL.isLocalFile())
+    {
+        juce::File file = audioURL.getLocalFile();
+        fullyResident = cache->isFullyResident(file);
+        reader = cache->createReaderFor(file, reader);
+    }
+
+    if (reader != nullptr)
+    {
+        track->sampleRate = reader->sampleRate;
+        track->readerSource.reset(new juce::AudioFormatReaderSource(reader, true));
+
+        // decode ahead of the playhead on the shared read-ahead thread so the audio thread never touches the disk,
+        // unless the whole track is already decoded in RAM
+        if (readAhead > 0 && fullyResident == false)
+        {
+            track->bufferingSource.reset(new juce::BufferingAudioSource(track->readerSource.get(), readAheadThread, false,
+                                                                        readAhead, (int) reader->numChannels, true));
+
+            // prefill the buffer here with the same block size and rate that the transport source
+            // will prepare it with, so that preparing it again on the message thread is a no-op
+            if (sampleRate > 0)
+            {
+                track->bufferingSource->prepareToPlay(blockSize, sampleRate);
+            }
+        }
+
+        juce::PositionableAudioSource* playbackSource = track->bufferingSource != nullptr ? (juce::PositionableAudioSource*) track->bufferingSource.get()
+                                                                                          : (juce::PositionableAudioSource*) track->readerSource.get();
+        track->loopingSource.reset(new LoopingSource(playbackSource, loopState, ++nextTrackId, reader->sampleRate));
+    }
+
+    return track;
+}
+
+// swap a prepared track into the transport source, must be called on the message thread
+bool DJAudioPlayer::publishTrack(PreparedTrack& track)
+{
+    if (track.readerSource == nullptr)
+    {
+        return false;
+    }
+
+    // the rate conversion is done by resampleSource together with the speed change, so the transport source
+    // is not given the file's sample rate to correct for
+    transportSource.setSource(track.loopingSource.get(), 0, nullptr, 0);
+
+    {
+        const juce::SpinLock::ScopedLockType lock(bufferingSourceLock);
+        std::swap(bufferingSource, track.bufferingSource);
+        std::swap(loopingSource, track.loopingSource);
+        fileSampleRate = track.sampleRate;
+    }
+
+    mappedReader = track.mappedReader;
+    seekIndexed = track.seekIndexed;
+    currentURL = track.url;
+    currentTrackId = loopingSource->getTrackId();
+
+    if (profiler != nullptr)
+    {
+        profiler->logAction(deckIndex, "loaded " + currentURL.getFileName());
+    }
+
+    stretchSource.reset();
+    resampleSource.flushBuffers();
+
+    // a new track always starts unlooped and without hot cues, until they are set for it
+    pushCommand({ DeckCommand::Type::setLooping, 0 });
+    clearHotCues();
+
+    // track now holds the previous sources, which must go in the reverse order to how they wrap each other
+    std::swap(readerSource, track.readerSource);
+    track.loopingSource.reset();
+    track.bufferingSource.reset();
+    track.readerSource.reset();
+
+    resetUnderrunCounters();
+    return true;
+}
+
+void DJAudioPlayer::recordLoadLatency(double requestTime)
+{
+    lastLoadLatency = juce::Time::getMillisecondCounterHiRes() - requestTime;
+    totalLoadLatency += lastLoadLatency;
+    numLoads++;
+
+    DBG("DJAudioPlayer::recordLoadLatency track ready after " << lastLoadLatency << " ms");
+}
+
+bool DJAudioPlayer::pushCommand(const DeckCommand& command)
+{
+    if (commandQueue.push(command) == false)
+    {
+        DBG("DJAudioPlayer::pushCommand command queue is full");
+        return false;
+    }
+
+    if (profiler != nullptr)
+    {
+        profiler->logCommand(deckIndex, commandNames[(int) command.type], command.value);
+    }
+
+    return true;
+}
+
+void DJAudioPlayer::setGain(double gain)
+{
+    if (gain < 0 || gain > 2)
+    {
+        DBG("DJAudioPlayer::setGain gain should be between 0 and 2");
+    }
+
+    else
+    {
+        pushCommand({ DeckCommand::Type::setGain, gain });
+    }
+}
+
+void DJAudioPlayer::setSpeed(double ratio)
+{
+    if (ratio <= 0 || ratio > 2)
+    {
+        DBG("DJAudioPlayer::setSpeed ratio should be between 0 and 2");
+    }
+
+    else
+    {
+        speedRatio = ratio;
+        pushCommand({ DeckCommand::Type::setSpeed, ratio });
+    }
+}
+
+void DJAudioPlayer::setPosition(double posInSecs)
+{
+    pushCommand({ DeckCommand::Type::setPosition, posInSecs });
+}
+
+void DJAudioPlayer::setPositionRelative(double pos)
+{
+    if (pos < 0 || pos > 1)
+    {
+        DBG("DJAudioPlayer::setPositionRelative pos should be between 0 and 1");
+    }
+
+    else
+    {
+        double posInSecs = getLength() * pos;
+        setPosition(posInSecs);
+    }
+}
+
+bool DJAudioPlayer::isPlaying()
+{
+    return transportSource.isPlaying();
+}
+
+void DJAudioPlayer::start()
+{
+    transportSource.start();
+
+    if (profiler != nullptr)
+    {
+        profiler->logAction(deckIndex, "play");
+    }
+}
+
+void DJAudioPlayer::stop()
+{
+    transportSource.stop();
+
+    if (profiler != nullptr)
+    {
+        profiler->logAction(deckIndex, "stop");
+    }
+}
+
+double DJAudioPlayer::getPositionRelative()
+{
+    return getPosition() / getLength();
+}
+
+// positions are worked out from the file's sample rate, since the transport source only knows the device rate
+double DJAudioPlayer::getPosition()
+{
+    return fileSampleRate > 0 ? transportSource.getNextReadPosition() / fileSampleRate : 0;
+}
+
+double DJAudioPlayer::getLength()
+{
+    return fileSampleRate > 0 ? transportSource.getTotalLength() / fileSampleRate : 0;
+}
+
+void DJAudioPlayer::setReadAheadSize(int numSamples)
+{
+    if (numSamples < 0)
+    {
+        DBG("DJAudioPlayer::setReadAheadSize numSamples should not be negative");
+    }
+
+    else
+    {
+        readAheadSize = numSamples;
+    }
+}
+
+int DJAudioPlayer::getReadAheadSize()
+{
+    return readAheadSize;
+}
+
+int DJAudioPlayer::getUnderrunCount()
+{
+    return underrunCount;
+}
+
+juce::int64 DJAudioPlayer::getUnderrunSamples()
+{
+    return underrunSamples;
+}
+
+void DJAudioPlayer::resetUnderrunCounters()
+{
+    underrunCount = 0;
+    underrunSamples = 0;
+}
+
+void DJAudioPlayer::setTrackCache(TrackCache* cache)
+{
+    trackCache = cache;
+}
+
+void DJAudioPlayer::setProfiler(CallbackProfiler* _profiler, int _deckIndex)
+{
+    profiler = _profiler;
+    deckIndex = _deckIndex;
+}
+
+void DJAudioPlayer::setMemoryMappingEnabled(bool enabled)
+{
+    memoryMappingEnabled = enabled;
+}
+
+bool DJAudioPlayer::isMemoryMapped()
+{
+    return mappedReader != nullptr;
+}
+
+void DJAudioPlayer::setSeekIndexEnabled(bool enabled)
+{
+    seekIndexEnabled = enabled;
+}
+
+bool DJAudioPlayer::isSeekIndexed()
+{
+    return seekIndexed;
+}
+
+void DJAudioPlayer::setResamplingQuality(PolyphaseResampler::Quality quality)
+{
+    resampleSource.setQuality(quality);
+}
+
+PolyphaseResampler::Quality DJAudioPlayer::getResamplingQuality()
+{
+    return resampleSource.getQuality();
+}
+
+// apply a queued parameter change, called on the audio thread
+void DJAudioPlayer::applyCommand(const DeckCommand& command)
+{
+    switch (command.type)
+    {
+        case DeckCommand::Type::setGain:
+            gainSmoother.setTargetValue((float) command.value);
+            break;
+
+        case DeckCommand::Type::setSpeed:
+            targetSpeed = command.value;
+
+            if (syncLocked == false)
+            {
+                speedSmoother.setTargetValue(command.value);
+            }
+            break;
+
+        case DeckCommand::Type::setPosition:
+            if (fileSampleRate > 0)
+            {
+                jumpTo((juce::int64) (command.value * fileSampleRate));
+            }
+            break;
+
+        case DeckCommand::Type::setKeylock:
+            stretchSource.setEnabled(command.value != 0);
+            break;
+
+        case DeckCommand::Type::setLoopStart:
+            loopState.start = (juce::int64) (command.value * fileSampleRate);
+            break;
+
+        case DeckCommand::Type::setLoopEnd:
+            loopState.end = (juce::int64) (command.value * fileSampleRate);
+            break;
+
+        case DeckCommand::Type::setLooping:
+            loopState.enabled = command.value != 0;
+            looping = loopState.enabled;
+            break;
+
+        case DeckCommand::Type::setEqLow:
+            eqSource.setBandGain(DeckEqualiser::Band::low, (float) command.value);
+            break;
+
+        case DeckCommand::Type::setEqMid:
+            eqSource.setBandGain(DeckEqualiser::Band::mid, (float) command.value);
+            break;
+
+        case DeckCommand::Type::setEqHigh:
+            eqSource.setBandGain(DeckEqualiser::Band::high, (float) command.value);
+            break;
+
+        case DeckCommand::Type::setFilter:
+            eqSource.setFilter((float) command.value);
+            break;
+
+        case DeckCommand::Type::setBeatsPerMinute:
+            beatsPerMinute = command.value;
+            break;
+
+        case DeckCommand::Type::setFirstBeat:
+            firstBeat = command.value;
+            break;
+
+        case DeckCommand::Type::setSync:
+            syncing = command.value != 0;
+            syncIntegral = 0;
+            break;
+
+        case DeckCommand::Type::triggerHotCue:
+            jumpToHotCue((int) command.value);
+            break;
+    }
+}
+
+// move the playhead and restart the stretcher, resampler and beat clock from there, on the audio thread
+void DJAudioPlayer::jumpTo(juce::int64 position)
+{
+    transportSource.setNextReadPosition(position);
+    clockPosition = (double) transportSource.getNextReadPosition();
+    stretchSource.reset();
+    resampleSource.flushBuffers();
+}
+
+// jump to the cue, playing its seam from RAM if one has been decoded for this track, on the audio thread
+void DJAudioPlayer::jumpToHotCue(int index)
+{
+    double position = hotCues[index];
+
+    if (position < 0 || fileSampleRate <= 0)
+    {
+        return;
+    }
+
+    int slot = publishedCueSeams[index];
+    bool buffered = slot >= 0 && cueSeams[index][slot].trackId == currentTrackId;
+
+    // the seam is handed to the looping source before the jump, so that the jump finds it there
+    cueSeamInUse = buffered ? index * 2 + slot : -1;
+    loopState.cueSeam = buffered ? &cueSeams[index][slot] : nullptr;
+    jumpTo(buffered ? cueSeams[index][slot].start : (juce::int64) (position * fileSampleRate));
+
+    hotCuePending = true;
+    hotCueBuffered = buffered;
+}
+
+// let go of the hot cue's seam once the playhead has left it, so the loader is free to fill it again
+void DJAudioPlayer::releaseCueSeam()
+{
+    const LoopSeam* seam = loopState.cueSeam;
+
+    if (seam == nullptr)
+    {
+        return;
+    }
+
+    juce::int64 position = transportSource.getNextReadPosition();
+
+    if (seam->trackId != currentTrackId || position < seam->start || position >= seam->start + seam->numSamples)
+    {
+        loopState.cueSeam = nullptr;
+        cueSeamInUse = -1;
+    }
+}
+
+// time a triggered cue once a block has played its audio, on the audio thread
+void DJAudioPlayer::recordHotCueLatency()
+{
+    if (hotCuePending == false)
+    {
+        return;
+    }
+
+    hotCuePending = false;
+    lastHotCueLatency = juce::Time::getMillisecondCounterHiRes() - hotCueRequestTime;
+    lastHotCueBuffered = hotCueBuffered;
+    totalHotCueLatency = totalHotCueLatency + lastHotCueLatency;
+    numHotCueTriggers++;
+}
+
+// advance the speed ramp across this block and hand its end value to the resampler, which ramps per sample.
+// the resampler converts from the file's rate to the device's rate and applies the speed change in the same
+// pass, unless keylock is on, in which case the speed change is made by the time-stretcher instead
+void DJAudioPlayer::updateResamplingRatio(int numSamples)
+{
+    double speed = numSamples > 0 ? speedSmoother.skip(numSamples) : speedSmoother.getCurrentValue();
+    double rateRatio = currentSampleRate > 0 && fileSampleRate > 0 ? fileSampleRate / currentSampleRate : 1.0;
+    double syncSpeed = getSyncSpeed(numSamples);
+
+    // while synced the leader sets the speed, and once sync is let go it ramps back to the knob's from there
+    if (syncSpeed > 0)
+    {
+        speed = syncSpeed;
+        speedSmoother.setCurrentAndTargetValue(speed);
+        syncLocked = true;
+    }
+
+    else if (syncLocked)
+    {
+        speedSmoother.setTargetValue(targetSpeed);
+        syncLocked = false;
+    }
+
+    playbackRate = speed * rateRatio;
+
+    if (stretchSource.isEnabled())
+    {
+        stretchSource.setTempo(speed);
+        resampleSource.setResamplingRatio(rateRatio);
+    }
+
+    else
+    {
+        stretchSource.setTempo(1.0);
+        resampleSource.setResamplingRatio(speed * rateRatio);
+    }
+}
+
+// the speed that plays this deck's beats at the rate of its leader's, bent by a PI controller on the beat
+// phase error so that the two stay locked, or 0 when the deck is not synced to anything
+double DJAudioPlayer::getSyncSpeed(int numSamples)
+{
+    double referenceRate = syncReferenceRate;
+
+    if (syncing == false || referenceRate <= 0 || beatsPerMinute <= 0 || fileSampleRate <= 0 || currentSampleRate <= 0 || numSamples <= 0)
+    {
+        syncIntegral = 0;
+        return 0;
+    }
+
+    // both positions are where the last block ended, so the error is taken the nearest way round a beat
+    double ownPosition = (clockPosition / fileSampleRate - firstBeat) * beatsPerMinute / 60.0;
+    double error = syncReferencePosition - ownPosition;
+    error -= std::round(error);
+    syncPhaseError = -error;
+
+    double correction = syncProportionalGain * error + syncIntegralGain * syncIntegral;
+
+    // only integrate while the correction is within its limit, so that a big jump in phase does not wind it up
+    if (std::abs(correction) < maxSyncCorrection)
+    {
+        syncIntegral += error * numSamples / currentSampleRate;
+    }
+
+    correction = juce::jlimit(-maxSyncCorrection, maxSyncCorrection, correction);
+
+    double speed = referenceRate * currentSampleRate * 60.0 / beatsPerMinute * (1.0 + correction);
+    return juce::jlimit(0.05, 2.0, speed);
+}
+
+// start the clock from the transport's position whenever a new track has been swapped in, on the audio thread
+void DJAudioPlayer::updateBeatClock()
+{
+    if (clockTrackId != currentTrackId)
+    {
+        clockTrackId = currentTrackId;
+        clockPosition = (double) transportSource.getNextReadPosition();
+    }
+}
+
+// move the clock on by the file samples the resampler stepped through in this block, with its ratio ramping
+// from startRate to endRate the same way, and publish where the beat grid now stands
+void DJAudioPlayer::advanceBeatClock(int numSamples, double startRate, double endRate)
+{
+    bool playing = transportSource.isPlaying();
+
+    if (playing)
+    {
+        clockPosition += numSamples * startRate + (endRate - startRate) * (numSamples - 1) * 0.5;
+    }
+
+    // the looping source wraps the audio back to the loop start, and the clock goes with it
+    if (loopState.enabled && loopState.end > loopState.start && clockPosition >= (double) loopState.end)
+    {
+        clockPosition -= (double) (loopState.end - loopState.start);
+    }
+
+    if (beatsPerMinute > 0 && fileSampleRate > 0)
+    {
+        beatPosition = (clockPosition / fileSampleRate - firstBeat) * beatsPerMinute / 60.0;
+        beatRate = playing ? endRate / fileSampleRate * beatsPerMinute / 60.0 : 0.0;
+    }
+
+    else
+    {
+        beatPosition = 0;
+        beatRate = 0;
+    }
+}
+
+// apply the gain with a per-sample ramp while it is moving
+void DJAudioPlayer::applyGain(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto* buffer = bufferToFill.buffer;
+
+    if (gainSmoother.isSmoothing() && bufferToFill.numSamples <= (int) gainRamp.size())
+    {
+        for (int i = 0; i < bufferToFill.numSamples; ++i)
+        {
+            gainRamp[(size_t) i] = gainSmoother.getNextValue();
+        }
+
+        for (int channel = 0; channel < buffer->getNumChannels(); ++channel)
+        {
+            juce::FloatVectorOperations::multiply(buffer->getWritePointer(channel, bufferToFill.startSample), gainRamp.data(), bufferToFill.numSamples);
+        }
+    }
+
+    else
+    {
+        float startGain = gainSmoother.getCurrentValue();
+        float endGain = gainSmoother.skip(bufferToFill.numSamples);
+
+        if (startGain != endGain)
+        {
+            buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples, startGain, endGain);
+        }
+
+        else if (endGain != 1.0f)
+        {
+            buffer->applyGain(bufferToFill.startSample, bufferToFill.numSamples, endGain);
+        }
+    }
+}
+
+void DJAudioPlayer::setKeylock(bool shouldBeEnabled)
+{
+    pushCommand({ DeckCommand::Type::setKeylock, shouldBeEnabled ? 1.0 : 0.0 });
+}
+
+bool DJAudioPlayer::isKeylockEnabled()
+{
+    return stretchSource.isEnabled();
+}
+
+void DJAudioPlayer::setKeylockMode(TimeStretcher::Mode mode)
+{
+    stretchSource.setMode(mode);
+}
+
+void DJAudioPlayer::setEqGain(DeckEqualiser::Band band, double gain)
+{
+    if (gain < 0 || gain > 2)
+    {
+        DBG("DJAudioPlayer::setEqGain gain should be between 0 and 2");
+    }
+
+    else
+    {
+        auto type = band == DeckEqualiser::Band::low ? DeckCommand::Type::setEqLow
+                                                     : (band == DeckEqualiser::Band::mid ? DeckCommand::Type::setEqMid : DeckCommand::Type::setEqHigh);
+        pushCommand({ type, gain });
+    }
+}
+
+void DJAudioPlayer::setFilter(double position)
+{
+    if (position < -1 || position > 1)
+    {
+        DBG("DJAudioPlayer::setFilter position should be between -1 and 1");
+    }
+
+    else
+    {
+        pushCommand({ DeckCommand::Type::setFilter, position });
+    }
+}
+
+void DJAudioPlayer::setLoopRegion(double startInSecs, double endInSecs)
+{
+    if (startInSecs < 0 || endInSecs <= startInSecs)
+    {
+        DBG("DJAudioPlayer::setLoopRegion loop end should be after a loop start of at least 0");
+    }
+
+    else if (fileSampleRate > 0)
+    {
+        pushCommand({ DeckCommand::Type::setLoopStart, startInSecs });
+        pushCommand({ DeckCommand::Type::setLoopEnd, endInSecs });
+
+        juce::int64 loopStart = (juce::int64) (startInSecs * fileSampleRate);
+        juce::int64 loopEnd = (juce::int64) (endInSecs * fileSampleRate);
+
+        if (mappedReader != nullptr)
+        {
+            mappedReader->setLoopRegion({ loopStart, loopEnd });
+        }
+
+        // decode the audio around loop-in off the audio thread, so the jump back never waits on the read-ahead buffer
+        requestedLoopStart = loopStart;
+        queueLoopSeam(currentURL, currentTrackId, loopStart);
+    }
+}
+
+void DJAudioPlayer::setLooping(bool shouldLoop)
+{
+    pushCommand({ DeckCommand::Type::setLooping, shouldLoop ? 1.0 : 0.0 });
+}
+
+bool DJAudioPlayer::isLooping()
+{
+    return looping;
+}
+
+void DJAudioPlayer::setBeatGrid(double bpm, double firstBeatInSecs)
+{
+    if (bpm < 0)
+    {
+        DBG("DJAudioPlayer::setBeatGrid bpm should not be negative");
+    }
+
+    else
+    {
+        pushCommand({ DeckCommand::Type::setFirstBeat, firstBeatInSecs });
+        pushCommand({ DeckCommand::Type::setBeatsPerMinute, bpm });
+    }
+}
+
+void DJAudioPlayer::setSyncEnabled(bool shouldSync)
+{
+    pushCommand({ DeckCommand::Type::setSync, shouldSync ? 1.0 : 0.0 });
+}
+
+bool DJAudioPlayer::isSyncEnabled()
+{
+    return syncing;
+}
+
+double DJAudioPlayer::getBeatPosition()
+{
+    return beatPosition;
+}
+
+double DJAudioPlayer::getBeatRate()
+{
+    return beatRate;
+}
+
+void DJAudioPlayer::setSyncReference(double referencePosition, double referenceRate)
+{
+    syncReferencePosition = referencePosition;
+    syncReferenceRate = referenceRate;
+}
+
+double DJAudioPlayer::getSyncPhaseError()
+{
+    return syncPhaseError;
+}
+
+void DJAudioPlayer::setHotCue(int index, double posInSecs)
+{
+    if (juce::isPositiveAndBelow(index, numHotCues) == false || posInSecs < 0)
+    {
+        DBG("DJAudioPlayer::setHotCue index should be between 0 and " << numHotCues - 1 << " and posInSecs should not be negative");
+    }
+
+    else
+    {
+        // the seam of the cue's old position must not be jumped to while the new one is decoded
+        hotCues[index] = posInSecs;
+        publishedCueSeams[index] = -1;
+
+        if (hotCueBuffersEnabled && fileSampleRate > 0)
+        {
+            queueCueSeam(currentURL, currentTrackId, index, posInSecs);
+        }
+    }
+}
+
+void DJAudioPlayer::clearHotCue(int index)
+{
+    if (juce::isPositiveAndBelow(index, numHotCues) == false)
+    {
+        DBG("DJAudioPlayer::clearHotCue index should be between 0 and " << numHotCues - 1);
+    }
+
+    else
+    {
+        hotCues[index] = -1.0;
+        publishedCueSeams[index] = -1;
+    }
+}
+
+void DJAudioPlayer::clearHotCues()
+{
+    for (int i = 0; i < numHotCues; ++i)
+    {
+        clearHotCue(i);
+    }
+}
+
+double DJAudioPlayer::getHotCue(int index)
+{
+    return juce::isPositiveAndBelow(index, numHotCues) ? hotCues[index].load() : -1.0;
+}
+
+bool DJAudioPlayer::isHotCueReady(int index)
+{
+    if (juce::isPositiveAndBelow(index, numHotCues) == false)
+    {
+        return false;
+    }
+
+    int slot = publishedCueSeams[index];
+    return slot >= 0 && cueSeams[index][slot].trackId == currentTrackId;
+}
+
+void DJAudioPlayer::triggerHotCue(int index)
+{
+    if (getHotCue(index) < 0)
+    {
+        DBG("DJAudioPlayer::triggerHotCue hot cue " << index << " is not set");
+    }
+
+    else
+    {
+        // the jump is queued before starting, so the first block that plays is already from the cue
+        hotCueRequestTime = juce::Time::getMillisecondCounterHiRes();
+        pushCommand({ DeckCommand::Type::triggerHotCue, (double) index });
+
+        if (isPlaying() == false)
+        {
+            start();
+        }
+    }
+}
+
+void DJAudioPlayer::setHotCueBuffersEnabled(bool enabled)
+{
+    hotCueBuffersEnabled = enabled;
+}
+
+void DJAudioPlayer::setSeamDecodingSynchronous(bool synchronous)
+{
+    seamDecodingSynchronous = synchronous;
+}
+
+double DJAudioPlayer::getLastHotCueLatency()
+{
+    return lastHotCueLatency;
+}
+
+double DJAudioPlayer::getAverageHotCueLatency()
+{
+    return numHotCueTriggers > 0 ? totalHotCueLatency / numHotCueTriggers : 0;
+}
+
+bool DJAudioPlayer::wasLastHotCueBuffered()
+{
+    return lastHotCueBuffered;
+}
+
+// a reader for decoding a seam, separate from the one playing, through the seek index and the track cache
+// where they apply, runs on the loader thread
+juce::AudioFormatReader* DJAudioPlayer::createSeamReader(juce::URL audioURL)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    TrackCache* cache = trackCache;
+
+    if (seekIndexEnabled && audioURL.isLocalFile())
+    {
+        reader.reset(SeekIndexedReader::createFor(audioURL.getLocalFile(), formatManager));
+    }
+
+    if (reader == nullptr)
+    {
+        reader.reset(formatManager.createReaderFor(audioURL.createInputStream(false)));
+    }
+
+    if (reader != nullptr && cache != nullptr && audioURL.isLocalFile())
+    {
+        reader.reset(cache->createResidentReaderFor(audioURL.getLocalFile(), reader.release()));
+    }
+
+    return reader.release();
+}
+
+// decode the loop's seam on the loader thread, queueing it again while both of its slots are taken so that
+// track loads queued behind it are not held up
+void DJAudioPlayer::queueLoopSeam(juce::URL audioURL, int trackId, juce::int64 loopStart)
+{
+    if (seamDecodingSynchronous && decodeLoopSeam(audioURL, trackId, loopStart))
+    {
+        return;
+    }
+
+    loaderPool.addJob([this, audioURL, trackId, loopStart]
+    {
+        if (decodeLoopSeam(audioURL, trackId, loopStart) == false && stopping == false)
+        {
+            juce::Thread::sleep(seamRetryInterval);
+            queueLoopSeam(audioURL, trackId, loopStart);
+        }
+    });
+}
+
+// decode a hot cue's seam on the loader thread, queued again in the same way as the loop's
+void DJAudioPlayer::queueCueSeam(juce::URL audioURL, int trackId, int index, double posInSecs)
+{
+    if (seamDecodingSynchronous && decodeCueSeam(audioURL, trackId, index, posInSecs))
+    {
+        return;
+    }
+
+    loaderPool.addJob([this, audioURL, trackId, index, posInSecs]
+    {
+        if (decodeCueSeam(audioURL, trackId, index, posInSecs) == false && stopping == false)
+        {
+            juce::Thread::sleep(seamRetryInterval);
+            queueCueSeam(audioURL, trackId, index, posInSecs);
+        }
+    });
+}
+
+// read the seam with a reader of its own, runs on the loader thread. returns false without touching either
+// slot if neither is free yet, and true once it is done or no longer wanted
+bool DJAudioPlayer::decodeLoopSeam(juce::URL audioURL, int trackId, juce::int64 loopStart)
+{
+    if (trackId != currentTrackId || loopStart != requestedLoopStart)
+    {
+        return true;
+    }
+
+    // the audio thread only ever moves on to the published seam, so a slot that is neither published nor
+    // in use stays free while it is written. both are taken while the device is stopped between the two
+    int published = publishedSeam;
+    int inUse = seamInUse;
+    int slot = published != 0 && inUse != 0 ? 0 : 1;
+
+    if (slot == published || slot == inUse)
+    {
+        return false;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader(createSeamReader(audioURL));
+
+    if (reader == nullptr)
+    {
+        return true;
+    }
+
+    juce::int64 seamStart = juce::jmax((juce::int64) 0, loopStart - (juce::int64) (reader->sampleRate * LoopingSource::fadeTime));
+    juce::int64 seamEnd = juce::jmin(reader->lengthInSamples, loopStart + (juce::int64) (reader->sampleRate * LoopingSource::seamTime));
+
+    if (seamEnd <= seamStart)
+    {
+        return true;
+    }
+
+    auto& seam = loopSeams[slot];
+    seam.numSamples = (int) (seamEnd - seamStart);
+    seam.samples.setSize((int) reader->numChannels, seam.numSamples, false, false, true);
+    reader->read(&seam.samples, 0, seam.numSamples, seamStart, true, true);
+    seam.start = seamStart;
+    seam.trackId = trackId;
+
+    publishedSeam = slot;
+    return true;
+}
+
+// read the audio after a hot cue with a reader of its own, runs on the loader thread. returns false without
+// touching either slot if neither is free yet, and true once it is done or no longer wanted
+bool DJAudioPlayer::decodeCueSeam(juce::URL audioURL, int trackId, int index, double posInSecs)
+{
+    if (trackId != currentTrackId || hotCues[index] != posInSecs)
+    {
+        return true;
+    }
+
+    // the audio thread holds on to the seam it jumped to until the playhead leaves it, which can be for as long
+    // as the deck stays paused, and only ever jumps to the published one, so the other slot is the one to fill
+    int published = publishedCueSeams[index];
+    int held = cueSeamInUse;
+    int inUse = held >= 0 && held / 2 == index ? held % 2 : -1;
+    int slot = published != 0 && inUse != 0 ? 0 : 1;
+
+    if (slot == published || slot == inUse)
+    {
+        return false;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader(createSeamReader(audioURL));
+
+    if (reader == nullptr)
+    {
+        return true;
+    }
+
+    juce::int64 seamStart = (juce::int64) (posInSecs * reader->sampleRate);
+    juce::int64 seamEnd = juce::jmin(reader->lengthInSamples, seamStart + (juce::int64) (reader->sampleRate * LoopingSource::seamTime));
+
+    if (seamEnd <= seamStart)
+    {
+        return true;
+    }
+
+    auto& seam = cueSeams[index][slot];
+    seam.numSamples = (int) (seamEnd - seamStart);
+    seam.samples.setSize((int) reader->numChannels, seam.numSamples, false, false, true);
+    reader->read(&seam.samples, 0, seam.numSamples, seamStart, true, true);
+    seam.start = seamStart;
+    seam.trackId = trackId;
+
+    // a cue that was moved or cleared while this was decoding is left to the job for its new position
+    if (hotCues[index] == posInSecs)
+    {
+        publishedCueSeams[index] = slot;
+    }
+
+    return true;
+}
+
+// switch to the most recently decoded seam, called on the audio thread
+void DJAudioPlayer::updateLoopSeam()
+{
+    int published = publishedSeam;
+
+    if (published != seamInUse)
+    {
+        seamInUse = published;
+        loopState.seam = published >= 0 ? &loopSeams[published] : nullptr;
+    }
 }
\ No newline at end of file
@@ -1,44 +1,285 @@
-/*
-  ==============================================================================
-
-    DJAudioPlayer.h
-    Created: 29 Jan 2023 4:20:02pm
-    Author:  cheng
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-class DJAudioPlayer : public juce::AudioSource
-{
-public:
-    DJAudioPlayer(juce::AudioFormatManager& _formatManager);
-    ~DJAudioPlayer();
-
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
-    void releaseResources() override;
-
-    void loadURL(juce::URL audioURL);
-    void setGain(double gain);
-    void setSpeed(double ratio);
-    void setPosition(double posInSecs);
-    void setPositionRelative(double pos);
-
-    bool isPlaying();
-    void start();
-    void stop();
-
-    double getPositionRelative();
-    double getPosition();
-    double getLength();
-
-private:
-    juce::AudioFormatManager& formatManager;
-    std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
-    juce::AudioTransportSource transportSource;
-    juce::ResamplingAudioSource resampleSource{ &transportSource, false, 2 };
+/*
+  ==============================================================================
+
+    DJAudioPlayer.h
+    Created: 29 Jan 2023 4:20:02pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackCache.h"
+#include "MappedTrackReader.h"
+#include "SeekIndexedReader.h"
+#include "PolyphaseResampler.h"
+#include "TimeStretcher.h"
+#include "DeckCommandQueue.h"
+#include "LoopingSource.h"
+#include "DeckEqualiser.h"
+#include "CallbackProfiler.h"
+
+class DJAudioPlayer : public juce::AudioSource
+{
+public:
+    DJAudioPlayer(juce::AudioFormatManager& _formatManager,
+                  juce::TimeSliceThread& _readAheadThread);
+    ~DJAudioPlayer();
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    // returns whether the track could be read
+    bool loadURL(juce::URL audioURL);
+
+    // parameter changes are queued for the audio thread, which applies them with per-sample ramps,
+    // other controllers can push their own commands from the message thread the same way
+    bool pushCommand(const DeckCommand& command);
+
+    // open, probe and buffer the track on a background thread, then swap it in on the message thread
+    // and call onLoaded there with whether the track could be read
+    void loadURLAsync(juce::URL audioURL, std::function<void(bool)> onLoaded);
+    bool isLoading();
+
+    // milliseconds between a load being requested and the track being ready to play
+    double getLastLoadLatency();
+    double getAverageLoadLatency();
+
+    void setGain(double gain);
+    void setSpeed(double ratio);
+    void setPosition(double posInSecs);
+    void setPositionRelative(double pos);
+
+    bool isPlaying();
+    void start();
+    void stop();
+
+    double getPositionRelative();
+    double getPosition();
+    double getLength();
+
+    // number of samples buffered ahead of the playhead, applied on the next load (0 reads straight from disk)
+    void setReadAheadSize(int numSamples);
+    int getReadAheadSize();
+
+    // number of blocks (and samples) where the read-ahead buffer had not caught up with the playhead
+    int getUnderrunCount();
+    juce::int64 getUnderrunSamples();
+    void resetUnderrunCounters();
+
+    // play tracks from decoded RAM once the cache holds them, nullptr always streams from the file
+    void setTrackCache(TrackCache* cache);
+
+    // log loads, transport changes and every queued command to the profiler as this deck's actions
+    void setProfiler(CallbackProfiler* _profiler, int _deckIndex);
+
+    // read WAV and AIFF files through a memory-mapped window that follows the playhead, applied on the next load
+    void setMemoryMappingEnabled(bool enabled);
+    bool isMemoryMapped();
+
+    // read MP3 files through a frame index so that seeks jump straight to the nearest frame, applied on the next load
+    void setSeekIndexEnabled(bool enabled);
+    bool isSeekIndexed();
+
+    // trade interpolation quality against CPU for both the speed change and the file to device rate conversion
+    void setResamplingQuality(PolyphaseResampler::Quality quality);
+    PolyphaseResampler::Quality getResamplingQuality();
+
+    // keep the pitch when the speed changes by time-stretching instead of resampling
+    void setKeylock(bool shouldBeEnabled);
+    bool isKeylockEnabled();
+    void setKeylockMode(TimeStretcher::Mode mode);
+
+    // band gains run from 0 (kill) to 2 (+6 dB), and the filter from -1 (low-pass) through 0 (off) to 1 (high-pass)
+    void setEqGain(DeckEqualiser::Band band, double gain);
+    void setFilter(double position);
+
+    // loop between two points of the track, wrapped sample-exactly on the audio thread
+    void setLoopRegion(double startInSecs, double endInSecs);
+    void setLooping(bool shouldLoop);
+    bool isLooping();
+
+    // beat grid of the loaded track, from its tempo and the time of one beat in the file, a bpm of 0 clears it
+    void setBeatGrid(double bpm, double firstBeatInSecs);
+
+    // lock the tempo and beat phase to the leader the engine hands over before each block
+    void setSyncEnabled(bool shouldSync);
+    bool isSyncEnabled();
+
+    // beats since the grid's first beat where the last block ended, and beats per output sample at the
+    // speed it ended on, which is 0 while stopped or without a beat grid, both written by the audio thread
+    double getBeatPosition();
+    double getBeatRate();
+
+    // called by the engine on the audio thread before each block, with the leader's beat position and rate
+    void setSyncReference(double referencePosition, double referenceRate);
+
+    // beats the deck was behind (negative) or ahead of its leader at the start of the last synced block
+    double getSyncPhaseError();
+
+    // hot cues of the loaded track, numbered from 0, each with a short window after it decoded in the background
+    // so that jumping to it plays from RAM on the very next block while the read-ahead buffer catches up
+    void setHotCue(int index, double posInSecs);
+    void clearHotCue(int index);
+    void clearHotCues();
+
+    // in seconds, -1 when the cue is not set
+    double getHotCue(int index);
+
+    // whether the window after the cue has been decoded, jumping to a cue that is not ready still works but seeks
+    bool isHotCueReady(int index);
+
+    // jump to the cue and start playing from it
+    void triggerHotCue(int index);
+
+    // decode a window after each cue as it is set, applied to cues set from then on
+    void setHotCueBuffersEnabled(bool enabled);
+
+    // decode loop and cue seams on the thread that sets them, so that a render driven block by block gets the
+    // same seams whatever the loader thread is doing. a seam whose slots are both held is still left to the loader
+    void setSeamDecodingSynchronous(bool synchronous);
+
+    // milliseconds from a hot cue being triggered to the end of the first block that plays its audio rather than
+    // waiting on the read-ahead buffer, and whether the jump went to the cue's decoded window
+    double getLastHotCueLatency();
+    double getAverageHotCueLatency();
+    bool wasLastHotCueBuffered();
+
+    static constexpr int defaultReadAheadSize = 65536;
+
+    // a phase error of one beat changes the speed by this fraction, and its integral over a second by syncIntegralGain,
+    // while the correction on top of the leader's tempo is held within maxSyncCorrection
+    static constexpr double syncProportionalGain = 0.5;
+    static constexpr double syncIntegralGain = 0.125;
+    static constexpr double maxSyncCorrection = 0.04;
+
+    static constexpr int numHotCues = 8;
+
+    // milliseconds between tries at decoding a seam while both of its slots are taken
+    static constexpr int seamRetryInterval = 10;
+
+private:
+    struct PreparedTrack
+    {
+        std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
+        std::unique_ptr<juce::BufferingAudioSource> bufferingSource;
+        std::unique_ptr<LoopingSource> loopingSource;
+        MappedTrackReader* mappedReader = nullptr;
+        bool seekIndexed = false;
+        double sampleRate = 0;
+        juce::URL url;
+    };
+
+    std::unique_ptr<PreparedTrack> prepareTrack(juce::URL audioURL);
+    bool publishTrack(PreparedTrack& track);
+    void applyCommand(const DeckCommand& command);
+    void jumpTo(juce::int64 position);
+    void jumpToHotCue(int index);
+    void releaseCueSeam();
+    void recordHotCueLatency();
+    void updateResamplingRatio(int numSamples);
+    double getSyncSpeed(int numSamples);
+    void updateBeatClock();
+    void advanceBeatClock(int numSamples, double startRate, double endRate);
+    void applyGain(const juce::AudioSourceChannelInfo& bufferToFill);
+    void recordLoadLatency(double requestTime);
+    juce::AudioFormatReader* createSeamReader(juce::URL audioURL);
+    void queueLoopSeam(juce::URL audioURL, int trackId, juce::int64 loopStart);
+    void queueCueSeam(juce::URL audioURL, int trackId, int index, double posInSecs);
+    bool decodeLoopSeam(juce::URL audioURL, int trackId, juce::int64 loopStart);
+    bool decodeCueSeam(juce::URL audioURL, int trackId, int index, double posInSecs);
+    void updateLoopSeam();
+
+    juce::AudioFormatManager& formatManager;
+    juce::TimeSliceThread& readAheadThread;
+    CallbackProfiler* profiler = nullptr;
+    int deckIndex = 0;
+    MappedTrackReader* mappedReader = nullptr;
+
+    // set on the message thread and by the device, and read by tracks being prepared on the loader thread
+    std::atomic<TrackCache*> trackCache{ nullptr };
+    std::atomic<bool> memoryMappingEnabled{ true };
+    std::atomic<bool> seekIndexEnabled{ true };
+    std::atomic<int> readAheadSize{ defaultReadAheadSize };
+    std::atomic<int> currentBlockSize{ 0 };
+    std::atomic<double> currentSampleRate{ 0 };
+
+    std::atomic<bool> seekIndexed{ false };
+    std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
+    std::unique_ptr<juce::BufferingAudioSource> bufferingSource;
+    std::unique_ptr<LoopingSource> loopingSource;
+    juce::SpinLock bufferingSourceLock;
+    juce::AudioTransportSource transportSource;
+    TimeStretcher stretchSource{ &transportSource, false, 2 };
+    PolyphaseResampler resampleSource{ &stretchSource, false, 2 };
+    DeckEqualiser eqSource{ &resampleSource, false };
+
+    std::atomic<double> fileSampleRate{ 0 };
+    std::atomic<double> speedRatio{ 1.0 };
+    double targetSpeed = 1.0;
+    double playbackRate = 0;
+
+    DeckCommandQueue commandQueue;
+    juce::SmoothedValue<float> gainSmoother;
+    juce::SmoothedValue<double> speedSmoother;
+    std::vector<float> gainRamp;
+    std::atomic<int> underrunCount{ 0 };
+    std::atomic<juce::int64> underrunSamples{ 0 };
+
+    // the loader fills whichever seam the audio thread is not using, then publishes it
+    LoopState loopState;
+    LoopSeam loopSeams[2];
+    std::atomic<int> publishedSeam{ -1 };
+    std::atomic<int> seamInUse{ -1 };
+    std::atomic<juce::int64> requestedLoopStart{ -1 };
+    std::atomic<bool> looping{ false };
+
+    // each hot cue has two seams, filled and published the same way as the loop's, and the audio thread holds
+    // on to the one it jumped to, numbered cue * 2 + slot, until the playhead has moved past it
+    std::atomic<double> hotCues[numHotCues];
+    LoopSeam cueSeams[numHotCues][2];
+    std::atomic<int> publishedCueSeams[numHotCues];
+    std::atomic<int> cueSeamInUse{ -1 };
+    bool hotCueBuffersEnabled = true;
+    std::atomic<bool> seamDecodingSynchronous{ false };
+
+    // set on the message thread when a cue is triggered, and timed on the audio thread once it plays
+    std::atomic<double> hotCueRequestTime{ 0 };
+    bool hotCuePending = false;
+    bool hotCueBuffered = false;
+    std::atomic<double> lastHotCueLatency{ 0 };
+    std::atomic<bool> lastHotCueBuffered{ false };
+    std::atomic<double> totalHotCueLatency{ 0 };
+    std::atomic<int> numHotCueTriggers{ 0 };
+
+    // the beat clock follows the file position the resampler has reached, sample for sample, as the audio thread
+    // renders, so that the phase is measured where the audio is heard rather than where it was read ahead
+    double beatsPerMinute = 0;
+    double firstBeat = 0;
+    double clockPosition = 0;
+    int clockTrackId = -1;
+    std::atomic<double> beatPosition{ 0 };
+    std::atomic<double> beatRate{ 0 };
+    std::atomic<bool> syncing{ false };
+    std::atomic<double> syncReferencePosition{ 0 };
+    std::atomic<double> syncReferenceRate{ 0 };
+    std::atomic<double> syncPhaseError{ 0 };
+    double syncIntegral = 0;
+    bool syncLocked = false;
+    std::atomic<int> nextTrackId{ 0 };
+    std::atomic<int> currentTrackId{ 0 };
+    juce::URL currentURL;
+
+    std::atomic<int> loadGeneration{ 0 };
+    std::atomic<bool> loading{ false };
+    double lastLoadLatency = 0;
+    double totalLoadLatency = 0;
+    int numLoads = 0;
+    std::atomic<bool> stopping{ false };
+    juce::ThreadPool loaderPool{ 1 };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(DJAudioPlayer)
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.cpp
+    Created: 17 Oct 2026 2:41:10pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "DeckCommandQueue.h"
+
+DeckCommandQueue::DeckCommandQueue()
+{
+
+}
+
+bool DeckCommandQueue::push(const DeckCommand& command)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+    {
+        numDropped++;
+        return false;
+    }
+
+    commands[(size_t) (size1 > 0 ? start1 : start2)] = command;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+int DeckCommandQueue::getNumDropped()
+{
+    return numDropped;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.h
+    Created: 17 Oct 2026 2:41:10pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct DeckCommand
+{
+    enum class Type
+    {
+        setGain,
+        setSpeed,
+        setPosition,
+        setKeylock,
+        setLoopStart,
+        setLoopEnd,
+        setLooping,
+        setEqLow,
+        setEqMid,
+        setEqHigh,
+        setFilter,
+        setBeatsPerMinute,
+        setFirstBeat,
+        setSync,
+        triggerHotCue
+    };
+
+    Type type;
+    double value;
+};
+
+// lock-free single-producer/single-consumer queue carrying deck parameter changes from the
+// message thread to the audio thread
+class DeckCommandQueue
+{
+public:
+    DeckCommandQueue();
+
+    // producer side, returns false and counts the command as dropped if the queue is full
+    bool push(const DeckCommand& command);
+
+    // consumer side, hands every queued command to handleCommand in the order they were pushed
+    template <typename Handler>
+    void drain(Handler&& handleCommand)
+    {
+        int numReady = fifo.getNumReady();
+
+        if (numReady == 0)
+        {
+            return;
+        }
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+        {
+            handleCommand(commands[(size_t) (start1 + i)]);
+        }
+
+        for (int i = 0; i < size2; ++i)
+        {
+            handleCommand(commands[(size_t) (start2 + i)]);
+        }
+
+        fifo.finishedRead(size1 + size2);
+    }
+
+    int getNumDropped();
+
+    static constexpr int capacity = 256;
+
+private:
+    juce::AbstractFifo fifo{ capacity };
+    std::array<DeckCommand, capacity> commands;
+    std::atomic<int> numDropped{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckCommandQueue)
+};
\ No newline at end of file
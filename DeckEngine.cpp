@@ -0,0 +1,249 @@
+/*
+  ==============================================================================
+
+    DeckEngine.cpp
+    Created: 17 Oct 2026 4:05:18pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "DeckEngine.h"
+
+namespace
+{
+    // pad each channel to a whole number of cache lines, so neighbouring decks never share one
+    const int floatsPerCacheLine = 16;
+}
+
+DeckEngine::DeckEngine(juce::AudioFormatManager& _formatManager, int _maxDecks) :
+                       formatManager(_formatManager),
+                       trackCache(_formatManager),
+                       mixer(juce::jmax(1, _maxDecks)),
+                       profiler(juce::jmax(1, _maxDecks))
+{
+    jassert(_maxDecks > 0);
+
+    // start the thread shared by every deck to read audio ahead of the playhead
+    readAheadThread.startThread();
+
+    for (int i = 0; i < juce::jmax(1, _maxDecks); ++i)
+    {
+        auto* deck = decks.add(new DJAudioPlayer(formatManager, readAheadThread));
+        deck->setTrackCache(&trackCache);
+        deck->setProfiler(&profiler, i);
+    }
+
+    deckViews.resize((size_t) decks.size());
+    numDecks = juce::jmin(2, decks.size());
+    renderJob = [this](int index) { renderDeck(index); };
+}
+
+DeckEngine::~DeckEngine()
+{
+    renderPool.reset();
+
+    // the players' buffering sources must be gone before the thread that services them stops
+    decks.clear();
+    readAheadThread.stopThread(2000);
+}
+
+void DeckEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    for (auto* deck : decks)
+    {
+        deck->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+
+    allocateDeckBuffers(samplesPerBlockExpected);
+    mixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    profiler.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void DeckEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    int numDecksToRender = numDecks;
+
+    if (deckBufferSize == 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    // hosts can occasionally deliver a bigger block than they asked to be prepared for, which is rendered
+    // in pieces rather than reallocating on the audio thread
+    for (int offset = 0; offset < bufferToFill.numSamples; offset += deckBufferSize)
+    {
+        int numSamples = juce::jmin(deckBufferSize, bufferToFill.numSamples - offset);
+        updateSync(numDecksToRender);
+        renderDecks(numDecksToRender, numSamples);
+        mixer.process(deckViews.data(), numDecksToRender, juce::AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample + offset, numSamples));
+    }
+}
+
+void DeckEngine::releaseResources()
+{
+    for (auto* deck : decks)
+    {
+        deck->releaseResources();
+    }
+}
+
+void DeckEngine::setNumDecks(int newNumDecks)
+{
+    if (newNumDecks < 1 || newNumDecks > decks.size())
+    {
+        DBG("DeckEngine::setNumDecks numDecks should be between 1 and " << decks.size());
+    }
+
+    else
+    {
+        numDecks = newNumDecks;
+        profiler.logAction(-1, "decks in use " + juce::String(newNumDecks));
+    }
+}
+
+int DeckEngine::getNumDecks()
+{
+    return numDecks;
+}
+
+int DeckEngine::getMaxDecks()
+{
+    return decks.size();
+}
+
+DJAudioPlayer* DeckEngine::getDeck(int index)
+{
+    return decks[index];
+}
+
+TrackCache& DeckEngine::getTrackCache()
+{
+    return trackCache;
+}
+
+MixerStage& DeckEngine::getMixer()
+{
+    return mixer;
+}
+
+CallbackProfiler& DeckEngine::getProfiler()
+{
+    return profiler;
+}
+
+// size the shared block for every deck, not just the ones in use, so enabling a deck later needs nothing new
+void DeckEngine::allocateDeckBuffers(int numSamples)
+{
+    int channelSize = (numSamples + floatsPerCacheLine - 1) / floatsPerCacheLine * floatsPerCacheLine;
+    deckSamples.setSize(decks.size() * numDeckChannels, channelSize);
+    deckBufferSize = numSamples;
+
+    for (int i = 0; i < decks.size(); ++i)
+    {
+        deckViews[(size_t) i].setDataToReferTo(deckSamples.getArrayOfWritePointers() + i * numDeckChannels, numDeckChannels, numSamples);
+    }
+}
+
+// hand every synced deck where its leader's beat grid stood at the end of the last block, before any deck
+// renders, so that the decks can still render in any order on any thread, the leader being the first deck
+// in use that plays with a beat grid and is not synced itself
+void DeckEngine::updateSync(int numDecksToRender)
+{
+    DJAudioPlayer* leader = nullptr;
+
+    for (int i = 0; i < numDecksToRender && leader == nullptr; ++i)
+    {
+        auto* deck = decks.getUnchecked(i);
+
+        if (deck->isSyncEnabled() == false && deck->getBeatRate() > 0)
+        {
+            leader = deck;
+        }
+    }
+
+    for (int i = 0; i < numDecksToRender; ++i)
+    {
+        auto* deck = decks.getUnchecked(i);
+
+        if (deck->isSyncEnabled())
+        {
+            deck->setSyncReference(leader != nullptr ? leader->getBeatPosition() : 0.0, leader != nullptr ? leader->getBeatRate() : 0.0);
+        }
+    }
+}
+
+void DeckEngine::renderDecks(int numDecksToRender, int numSamples)
+{
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    bool parallel = parallelRendering && numDecksToRender > 1;
+    renderNumSamples = numSamples;
+
+    // every deck writes only to its own channels, so they can render on any thread in any order
+    if (parallel)
+    {
+        renderPool->run(numDecksToRender, renderJob);
+    }
+
+    else
+    {
+        for (int i = 0; i < numDecksToRender; ++i)
+        {
+            renderDeck(i);
+        }
+    }
+
+    auto& timing = renderTimings[parallel ? 1 : 0];
+    timing.totalTicks += juce::Time::getHighResolutionTicks() - startTicks;
+    timing.numBlocks++;
+}
+
+void DeckEngine::renderDeck(int index)
+{
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    decks.getUnchecked(index)->getNextAudioBlock(juce::AudioSourceChannelInfo(&deckViews[(size_t) index], 0, renderNumSamples));
+    profiler.addDeckTime(index, startTicks, juce::Time::getHighResolutionTicks());
+}
+
+void DeckEngine::setRenderThreads(int numWorkers)
+{
+    if (numWorkers < 0)
+    {
+        DBG("DeckEngine::setRenderThreads numWorkers should not be negative");
+        return;
+    }
+
+    if (numWorkers == 0)
+    {
+        parallelRendering = false;
+        return;
+    }
+
+    // the audio thread may be using the pool, so it is never replaced once created
+    if (renderPool == nullptr)
+    {
+        renderPool.reset(new DeckRenderPool(juce::jmin(numWorkers, DeckRenderPool::maxJobs)));
+    }
+
+    renderPool->start();
+    parallelRendering = true;
+}
+
+int DeckEngine::getRenderThreads()
+{
+    return parallelRendering ? renderPool->getNumWorkers() : 0;
+}
+
+double DeckEngine::getAverageRenderTime(bool parallel)
+{
+    auto& timing = renderTimings[parallel ? 1 : 0];
+    int numBlocks = timing.numBlocks;
+
+    return numBlocks > 0 ? juce::Time::highResolutionTicksToSeconds(timing.totalTicks) * 1000.0 / numBlocks : 0;
+}
+
+const juce::AudioBuffer<float>& DeckEngine::getDeckOutput(int index)
+{
+    return deckViews[(size_t) juce::jlimit(0, decks.size() - 1, index)];
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    DeckEngine.h
+    Created: 17 Oct 2026 4:05:18pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "TrackCache.h"
+#include "DeckRenderPool.h"
+#include "MixerStage.h"
+#include "CallbackProfiler.h"
+
+// owns every deck's player along with the read-ahead thread and track cache they share, and mixes the
+// decks in use into the output
+class DeckEngine : public juce::AudioSource
+{
+public:
+    DeckEngine(juce::AudioFormatManager& _formatManager, int _maxDecks = defaultMaxDecks);
+    ~DeckEngine() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    // all decks are created and prepared up front, so changing how many are in use never allocates
+    void setNumDecks(int newNumDecks);
+    int getNumDecks();
+    int getMaxDecks();
+
+    DJAudioPlayer* getDeck(int index);
+    TrackCache& getTrackCache();
+    MixerStage& getMixer();
+    CallbackProfiler& getProfiler();
+
+    // render the decks on this many pinned real-time worker threads alongside the audio thread, or all
+    // on the audio thread with 0, the worker count is fixed the first time it is set above 0
+    void setRenderThreads(int numWorkers);
+    int getRenderThreads();
+
+    // average milliseconds spent rendering the decks of one block, on the audio thread alone or in parallel
+    double getAverageRenderTime(bool parallel);
+
+    // what a deck rendered in the last block, before the mixer, for measuring it headless
+    const juce::AudioBuffer<float>& getDeckOutput(int index);
+
+    static constexpr int defaultMaxDecks = 8;
+    static constexpr int numDeckChannels = 2;
+
+private:
+    void allocateDeckBuffers(int numSamples);
+    void updateSync(int numDecksToRender);
+    void renderDecks(int numDecksToRender, int numSamples);
+    void renderDeck(int index);
+
+    juce::AudioFormatManager& formatManager;
+    juce::TimeSliceThread readAheadThread{ "Deck read-ahead" };
+    TrackCache trackCache;
+
+    juce::OwnedArray<DJAudioPlayer> decks;
+    std::atomic<int> numDecks{ 0 };
+    MixerStage mixer;
+    CallbackProfiler profiler;
+
+    // one block holds every deck's output, each deck's channels one after another, and deckViews refer into it
+    juce::AudioBuffer<float> deckSamples;
+    std::vector<juce::AudioBuffer<float>> deckViews;
+    int deckBufferSize = 0;
+    int renderNumSamples = 0;
+
+    std::unique_ptr<DeckRenderPool> renderPool;
+    std::atomic<bool> parallelRendering{ false };
+    std::function<void(int)> renderJob;
+
+    struct RenderTiming
+    {
+        std::atomic<juce::int64> totalTicks{ 0 };
+        std::atomic<int> numBlocks{ 0 };
+    };
+
+    RenderTiming renderTimings[2];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckEngine)
+};
\ No newline at end of file
@@ -0,0 +1,318 @@
+/*
+  ==============================================================================
+
+    DeckEqualiser.cpp
+    Created: 17 Oct 2026 6:14:52pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "DeckEqualiser.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define OTODECKS_EQUALISER_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+ #include <arm_neon.h>
+ #define OTODECKS_EQUALISER_NEON 1
+#endif
+
+namespace
+{
+    // the filter's cutoff is recalculated this often while its knob is moving
+    const int coefficientUpdateInterval = 16;
+    const float filterDeadZone = 0.01f;
+    const double filterResonance = 0.8;
+    const double butterworthQ = 0.7071067811865476;
+
+    enum class FilterShape
+    {
+        lowPass,
+        highPass,
+        allPass
+    };
+
+    // RBJ cookbook filter as b0, b1, b2, a1, a2 normalised by a0
+    void makeCoefficients(double* coefficients, FilterShape shape, double frequency, double q, double sampleRate)
+    {
+        double w0 = juce::MathConstants<double>::twoPi * juce::jlimit(10.0, sampleRate * 0.45, frequency) / sampleRate;
+        double cosW0 = std::cos(w0);
+        double alpha = std::sin(w0) / (2.0 * q);
+        double a0 = 1.0 + alpha;
+
+        if (shape == FilterShape::allPass)
+        {
+            coefficients[0] = (1.0 - alpha) / a0;
+            coefficients[1] = -2.0 * cosW0 / a0;
+            coefficients[2] = 1.0;
+        }
+
+        else
+        {
+            double b1 = shape == FilterShape::highPass ? -(1.0 + cosW0) : 1.0 - cosW0;
+            coefficients[0] = std::abs(b1) / 2.0 / a0;
+            coefficients[1] = b1 / a0;
+            coefficients[2] = std::abs(b1) / 2.0 / a0;
+        }
+
+        coefficients[3] = -2.0 * cosW0 / a0;
+        coefficients[4] = (1.0 - alpha) / a0;
+    }
+
+    // one sample through four biquads at once, in transposed direct form II
+    template <typename BiquadType>
+    inline void processLanes(BiquadType& f, float* lanes)
+    {
+       #if OTODECKS_EQUALISER_SSE
+        __m128 x = _mm_load_ps(lanes);
+        __m128 y = _mm_add_ps(_mm_mul_ps(_mm_load_ps(f.b0), x), _mm_load_ps(f.z1));
+        _mm_store_ps(f.z1, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_load_ps(f.b1), x), _mm_mul_ps(_mm_load_ps(f.a1), y)), _mm_load_ps(f.z2)));
+        _mm_store_ps(f.z2, _mm_sub_ps(_mm_mul_ps(_mm_load_ps(f.b2), x), _mm_mul_ps(_mm_load_ps(f.a2), y)));
+        _mm_store_ps(lanes, y);
+       #elif OTODECKS_EQUALISER_NEON
+        float32x4_t x = vld1q_f32(lanes);
+        float32x4_t y = vmlaq_f32(vld1q_f32(f.z1), vld1q_f32(f.b0), x);
+        vst1q_f32(f.z1, vaddq_f32(vmlsq_f32(vmulq_f32(vld1q_f32(f.b1), x), vld1q_f32(f.a1), y), vld1q_f32(f.z2)));
+        vst1q_f32(f.z2, vmlsq_f32(vmulq_f32(vld1q_f32(f.b2), x), vld1q_f32(f.a2), y));
+        vst1q_f32(lanes, y);
+       #else
+        for (int i = 0; i < 4; ++i)
+        {
+            float x = lanes[i];
+            float y = f.b0[i] * x + f.z1[i];
+            f.z1[i] = f.b1[i] * x - f.a1[i] * y + f.z2[i];
+            f.z2[i] = f.b2[i] * x - f.a2[i] * y;
+            lanes[i] = y;
+        }
+       #endif
+    }
+}
+
+DeckEqualiser::DeckEqualiser(juce::AudioSource* _input, bool _deleteInputWhenDeleted) :
+                             input(_input, _deleteInputWhenDeleted)
+{
+    jassert(input != nullptr);
+
+    for (auto& gain : bandGains)
+    {
+        gain.setCurrentAndTargetValue(1.0f);
+    }
+
+    filterPosition.setCurrentAndTargetValue(0.0f);
+}
+
+DeckEqualiser::~DeckEqualiser()
+{
+
+}
+
+void DeckEqualiser::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    input->prepareToPlay(samplesPerBlockExpected, newSampleRate);
+
+    // the crossovers never move, so their coefficients are only worked out here
+    prepareCrossovers(lowSplit, highSplit, sampleRate);
+
+    // the mid and high bands together are an allpass at the high crossover, so the low band is passed
+    // through the same allpass to keep every band in phase
+    double allPass[5];
+    makeCoefficients(allPass, FilterShape::allPass, highCrossover, butterworthQ, sampleRate);
+    lowAllpass.setCoefficients(0, 4, allPass);
+    lowAllpass.reset();
+
+    // ramp the band gains over 20 ms and the filter sweep over 50 ms
+    for (auto& gain : bandGains)
+    {
+        gain.reset(sampleRate, 0.02);
+    }
+
+    filterPosition.reset(sampleRate, 0.05);
+    filterType = 0;
+    updateFilter(filterPosition.getCurrentValue());
+}
+
+void DeckEqualiser::releaseResources()
+{
+    input->releaseResources();
+}
+
+void DeckEqualiser::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    input->getNextAudioBlock(bufferToFill);
+
+    auto& buffer = *bufferToFill.buffer;
+
+    if (buffer.getNumChannels() == 0)
+    {
+        return;
+    }
+
+    float* left = buffer.getWritePointer(0, bufferToFill.startSample);
+    float* right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1, bufferToFill.startSample) : nullptr;
+    alignas(16) float bands[4];
+    alignas(16) float low[4] = {};
+    alignas(16) float output[4] = {};
+
+    for (int start = 0; start < bufferToFill.numSamples; start += coefficientUpdateInterval)
+    {
+        int numSamples = juce::jmin(coefficientUpdateInterval, bufferToFill.numSamples - start);
+
+        if (filterPosition.isSmoothing())
+        {
+            updateFilter(filterPosition.skip(numSamples));
+        }
+
+        for (int i = start; i < start + numSamples; ++i)
+        {
+            float l = left[i];
+            float r = right != nullptr ? right[i] : l;
+
+            // split into low and the rest, then split the rest into mid and high
+            bands[0] = l;
+            bands[1] = r;
+            bands[2] = l;
+            bands[3] = r;
+            processLanes(lowSplit[0], bands);
+            processLanes(lowSplit[1], bands);
+
+            low[0] = bands[0];
+            low[1] = bands[1];
+            bands[0] = bands[2];
+            bands[1] = bands[3];
+            processLanes(highSplit[0], bands);
+            processLanes(highSplit[1], bands);
+            processLanes(lowAllpass, low);
+
+            float lowGain = bandGains[0].getNextValue();
+            float midGain = bandGains[1].getNextValue();
+            float highGain = bandGains[2].getNextValue();
+
+            output[0] = lowGain * low[0] + midGain * bands[0] + highGain * bands[2];
+            output[1] = lowGain * low[1] + midGain * bands[1] + highGain * bands[3];
+
+            if (filterType != 0)
+            {
+                processLanes(filter, output);
+            }
+
+            left[i] = output[0];
+
+            if (right != nullptr)
+            {
+                right[i] = output[1];
+            }
+        }
+    }
+}
+
+void DeckEqualiser::setBandGain(Band band, float gain)
+{
+    bandGains[(int) band].setTargetValue(juce::jlimit(0.0f, 2.0f, gain));
+}
+
+void DeckEqualiser::setFilter(float position)
+{
+    filterPosition.setTargetValue(juce::jlimit(-1.0f, 1.0f, position));
+}
+
+// map the knob to a cutoff on a log scale, 20 kHz down to 100 Hz for the low-pass and 20 Hz up to
+// 10 kHz for the high-pass, with the filter out of the signal path around the centre
+void DeckEqualiser::updateFilter(float position)
+{
+    int newType = position < -filterDeadZone ? -1 : (position > filterDeadZone ? 1 : 0);
+
+    // start from silence whenever the filter comes in or changes type, rather than from stale state
+    if (newType != filterType)
+    {
+        filter.reset();
+        filterType = newType;
+    }
+
+    if (filterType == 0)
+    {
+        return;
+    }
+
+    double coefficients[5];
+    double frequency = filterType < 0 ? 20000.0 * std::pow(100.0 / 20000.0, (double) -position)
+                                      : 20.0 * std::pow(10000.0 / 20.0, (double) position);
+    makeCoefficients(coefficients, filterType > 0 ? FilterShape::highPass : FilterShape::lowPass, frequency, filterResonance, sampleRate);
+    filter.setCoefficients(0, 4, coefficients);
+}
+
+void DeckEqualiser::prepareCrossovers(Biquad* lowStages, Biquad* highStages, double sampleRate)
+{
+    double lowPass[5], highPass[5];
+
+    for (int split = 0; split < 2; ++split)
+    {
+        double frequency = split == 0 ? lowCrossover : highCrossover;
+        makeCoefficients(lowPass, FilterShape::lowPass, frequency, butterworthQ, sampleRate);
+        makeCoefficients(highPass, FilterShape::highPass, frequency, butterworthQ, sampleRate);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            Biquad& stage = split == 0 ? lowStages[i] : highStages[i];
+            stage.setCoefficients(0, 2, lowPass);
+            stage.setCoefficients(2, 2, highPass);
+            stage.reset();
+        }
+    }
+}
+
+void DeckEqualiser::Biquad::setCoefficients(int firstLane, int numLanes, const double* coefficients)
+{
+    for (int lane = firstLane; lane < firstLane + numLanes; ++lane)
+    {
+        b0[lane] = (float) coefficients[0];
+        b1[lane] = (float) coefficients[1];
+        b2[lane] = (float) coefficients[2];
+        a1[lane] = (float) coefficients[3];
+        a2[lane] = (float) coefficients[4];
+    }
+}
+
+void DeckEqualiser::Biquad::reset()
+{
+    std::fill(std::begin(z1), std::end(z1), 0.0f);
+    std::fill(std::begin(z2), std::end(z2), 0.0f);
+}
+
+void DeckEqualiser::BandSplitter::prepare(double sampleRate)
+{
+    prepareCrossovers(lowSplit, highSplit, sampleRate);
+}
+
+// the same splits as getNextAudioBlock, without the allpass since only the power of each band is wanted
+void DeckEqualiser::BandSplitter::process(const float* left, const float* right, int numSamples,
+                                          float* lowPower, float* midPower, float* highPower)
+{
+    alignas(16) float bands[4];
+    float lowL, lowR;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float l = left[i];
+        float r = right != nullptr ? right[i] : 0.0f;
+
+        bands[0] = l;
+        bands[1] = r;
+        bands[2] = l;
+        bands[3] = r;
+        processLanes(lowSplit[0], bands);
+        processLanes(lowSplit[1], bands);
+
+        lowL = bands[0];
+        lowR = bands[1];
+        bands[0] = bands[2];
+        bands[1] = bands[3];
+        processLanes(highSplit[0], bands);
+        processLanes(highSplit[1], bands);
+
+        lowPower[i] = lowL * lowL + lowR * lowR;
+        midPower[i] = bands[0] * bands[0] + bands[1] * bands[1];
+        highPower[i] = bands[2] * bands[2] + bands[3] * bands[3];
+    }
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    DeckEqualiser.h
+    Created: 17 Oct 2026 6:14:52pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// three band isolator EQ with kills followed by a bipolar low-pass/high-pass filter, built from biquads
+// that run four lanes at a time, so both channels of a crossover's low-pass and high-pass share one SIMD register
+class DeckEqualiser : public juce::AudioSource
+{
+public:
+    enum class Band
+    {
+        low,
+        mid,
+        high
+    };
+
+    DeckEqualiser(juce::AudioSource* _input, bool _deleteInputWhenDeleted);
+    ~DeckEqualiser() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    // linear gain of a band, 0 kills it and 2 boosts it by 6 dB, called on the audio thread
+    void setBandGain(Band band, float gain);
+
+    // -1 sweeps a low-pass all the way down, 0 is off and 1 sweeps a high-pass all the way up,
+    // called on the audio thread
+    void setFilter(float position);
+
+    static constexpr double lowCrossover = 300.0;
+    static constexpr double highCrossover = 3000.0;
+
+    class BandSplitter;
+
+private:
+    struct Biquad
+    {
+        alignas(16) float b0[4] = {};
+        alignas(16) float b1[4] = {};
+        alignas(16) float b2[4] = {};
+        alignas(16) float a1[4] = {};
+        alignas(16) float a2[4] = {};
+        alignas(16) float z1[4] = {};
+        alignas(16) float z2[4] = {};
+
+        void setCoefficients(int firstLane, int numLanes, const double* coefficients);
+        void reset();
+    };
+
+    // set both stages of the low and high crossovers, low-pass in lanes 0 and 1 and high-pass in lanes 2 and 3
+    static void prepareCrossovers(Biquad* lowStages, Biquad* highStages, double sampleRate);
+
+    void updateFilter(float position);
+
+    juce::OptionalScopedPointer<juce::AudioSource> input;
+    double sampleRate = 44100;
+
+    // each crossover stage runs the low-pass for the left and right channels in lanes 0 and 1 and the
+    // high-pass in lanes 2 and 3, and two stages in a row make a fourth order Linkwitz-Riley split,
+    // the high split divides what is above the low one into mid and high
+    Biquad lowSplit[2];
+    Biquad highSplit[2];
+    Biquad lowAllpass;
+    Biquad filter;
+    int filterType = 0;
+
+    juce::SmoothedValue<float> bandGains[3];
+    juce::SmoothedValue<float> filterPosition;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckEqualiser)
+};
+
+// the EQ's crossovers without its gains, for analysis off the audio thread, giving the power of each band
+// at every sample so that a track can be shown by how much low, mid and high it has
+class DeckEqualiser::BandSplitter
+{
+public:
+    void prepare(double sampleRate);
+
+    // the low, mid and high power of each sample, summed over left and right, right is nullptr for mono
+    void process(const float* left, const float* right, int numSamples, float* lowPower, float* midPower, float* highPower);
+
+private:
+    Biquad lowSplit[2];
+    Biquad highSplit[2];
+};
\ No newline at end of file
@@ -1,323 +1,669 @@
-/*
-  ==============================================================================
-
-    DeckGUI.cpp
-    Created: 31 Jan 2023 4:32:33pm
-    Author:  cheng
-
-  ==============================================================================
-*/
-
-#include "DeckGUI.h"
-#include <iostream>
-#include <fstream>
-
-DeckGUI::DeckGUI(DJAudioPlayer* _player,
-                 juce::AudioFormatManager& formatManagerToUse,
-                 juce::AudioThumbnailCache& cacheToUse) :
-                 player(_player),
-                 waveformDisplay(formatManagerToUse, cacheToUse)
-{
-    // add and make visible labels, waveform display, sliders and buttons
-    addAndMakeVisible(trackTitle);
-    addAndMakeVisible(trackPosition);
-    addAndMakeVisible(trackLength);
-    addAndMakeVisible(waveformDisplay);
-    addAndMakeVisible(posSlider);
-    addAndMakeVisible(rewindButton);
-    addAndMakeVisible(playPauseButton);
-    addAndMakeVisible(stopButton);
-    addAndMakeVisible(forwardButton);
-    addAndMakeVisible(loopButton);
-    addAndMakeVisible(volSlider);
-    addAndMakeVisible(volSliderLabel);
-    addAndMakeVisible(speedSlider);
-    addAndMakeVisible(speedSliderLabel);
-
-    // add listeners to sliders and buttons
-    posSlider.addListener(this);
-    rewindButton.addListener(this);
-    playPauseButton.addListener(this);
-    stopButton.addListener(this);
-    forwardButton.addListener(this);
-    loopButton.addListener(this);
-    volSlider.addListener(this);
-    speedSlider.addListener(this);
-
-    // set style for trackTitle
-    trackTitle.setFont(18.0);
-
-    // set style of trackPosition
-    trackPosition.setFont(17.0);
-    trackPosition.setJustificationType(juce::Justification::centredRight);
-    trackPosition.setText("--:--:--", juce::NotificationType::dontSendNotification);
-
-    // set style of trackLength
-    trackLength.setFont(17.0);
-    trackLength.setJustificationType(juce::Justification::centredRight);
-    trackLength.setText("--:--:--", juce::NotificationType::dontSendNotification);
-
-    // set range of posSlider
-    posSlider.setRange(0.0, 1.0);
-
-    // set posSlider as transparent and overlay above the waveform display
-    // this allows the user to click on the waveform display directly to adjust the track position
-    posSlider.setSliderStyle(juce::Slider::LinearBar);
-    posSlider.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
-    posSlider.setColour(juce::Slider::trackColourId, juce::Colours::transparentWhite);
-
-    // set images of buttons
-    rewindButton.setImages(true, true, true, rewindImage, 0.5f, juce::Colours::transparentBlack, rewindImage, 1.0f, juce::Colours::transparentBlack, rewindImage, 0.5f, juce::Colours::transparentBlack);
-    playPauseButton.setImages(true, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
-    stopButton.setImages(true, true, true, stopImage, 0.5f, juce::Colours::transparentBlack, stopImage, 1.0f, juce::Colours::transparentBlack, stopImage, 0.5f, juce::Colours::transparentBlack);
-    forwardButton.setImages(true, true, true, forwardImage, 0.5f, juce::Colours::transparentBlack, forwardImage, 1.0f, juce::Colours::transparentBlack, forwardImage, 0.5f, juce::Colours::transparentBlack);
-    loopButton.setImages(true, true, true, loopImage, 0.5f, juce::Colours::transparentBlack, loopImage, 1.0f, juce::Colours::transparentBlack, loopImage, 0.5f, juce::Colours::transparentBlack);
-
-    // set range and values of volSlider
-    volSlider.setRange(0.0, 2.0);
-    volSlider.setValue(1.0);
-    volSlider.setDoubleClickReturnValue(true, 1.0);
-
-    // set style of volSlider
-    volSlider.setSliderStyle(juce::Slider::Rotary);
-    volSlider.setColour(juce::Slider::rotarySliderFillColourId, juce::Colour(11, 174, 244));
-    volSlider.setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colour(93, 96, 107));
-    volSlider.setColour(juce::Slider::thumbColourId, juce::Colours::white);
-    volSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
-    volSlider.setColour(juce::Slider::textBoxOutlineColourId, juce::Colour(35, 47, 52));
-
-    // attach label to volSlider
-    volSliderLabel.setText("VOLUME", juce::NotificationType::dontSendNotification);
-    volSliderLabel.attachToComponent(&volSlider, false);
-    volSliderLabel.setJustificationType(juce::Justification::centred);
-
-    // set range and values of speedSlider
-    speedSlider.setRange(0.0, 2.0);
-    speedSlider.setValue(1.0);
-    speedSlider.setDoubleClickReturnValue(true, 1.0);
-
-    // set style of speedSlider
-    speedSlider.setSliderStyle(juce::Slider::Rotary);
-    speedSlider.setColour(juce::Slider::rotarySliderFillColourId, juce::Colour(8, 227, 169));
-    speedSlider.setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colour(93, 96, 107));
-    speedSlider.setColour(juce::Slider::thumbColourId, juce::Colours::white);
-    speedSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
-    speedSlider.setColour(juce::Slider::textBoxOutlineColourId, juce::Colour(35, 47, 52));
-
-    // attach label to speedSlider
-    speedSliderLabel.setText("SPEED", juce::NotificationType::dontSendNotification);
-    speedSliderLabel.attachToComponent(&speedSlider, false);
-    speedSliderLabel.setJustificationType(juce::Justification::centred);
-
-    // timer loops every 10 milliseconds
-    startTimer(10);
-}
-
-DeckGUI::~DeckGUI()
-{
-    stopTimer();
-}
-
-void DeckGUI::paint(juce::Graphics& g)
-{
-    // set background colour
-    g.fillAll(juce::Colour(35, 47, 52));
-
-    // draw border around deck
-    g.setColour(juce::Colours::grey);
-    g.drawRect(getLocalBounds(), 1);
-}
-
-void DeckGUI::resized()
-{
-    double rowH = getHeight() / 10;
-    trackTitle.setBounds(0, 0, getWidth() * 0.75, rowH * 2);
-    trackPosition.setBounds(getWidth() * 0.75, 0, getWidth() * 0.25, rowH);
-    trackLength.setBounds(getWidth() * 0.75, rowH, getWidth() * 0.25, rowH);
-    waveformDisplay.setBounds(0, rowH * 2, getWidth(), rowH * 3);
-    posSlider.setBounds(0, rowH * 2, getWidth(), rowH * 3);
-    stopButton.setBounds(0, rowH * 5.25, getWidth() * 0.2, rowH / 2);
-    rewindButton.setBounds(getWidth() * 0.2, rowH * 5.25, getWidth() * 0.2, rowH / 2);
-    playPauseButton.setBounds(getWidth() * 0.4, rowH * 5.25, getWidth() * 0.2, rowH / 2);
-    forwardButton.setBounds(getWidth() * 0.6, rowH * 5.25, getWidth() * 0.2, rowH / 2);
-    loopButton.setBounds(getWidth() * 0.8, rowH * 5.25, getWidth() * 0.2, rowH / 2);
-    volSlider.setBounds(0, rowH * 6.75, getWidth() / 2, rowH * 3);
-    speedSlider.setBounds(getWidth() / 2, rowH * 6.75, getWidth() / 2, rowH * 3);
-}
-
-void DeckGUI::buttonClicked(juce::Button* button)
-{
-    // if rewind button is clicked, -1 second to track position
-    if (button == &rewindButton)
-    {
-        DBG("Rewind button was clicked");
-        player->setPosition(player->getPosition() - 1);
-    }
-
-    // if play/pause button is clicked, start/stop the audio file accordingly
-    if (button == &playPauseButton)
-    {
-        DBG("Play/pause button was clicked");
-
-        if (player->isPlaying() && trackTitle.getText() != "") // pause track, change to play button
-        {
-            player->stop();
-            playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
-        }
-
-        else if (player->isPlaying() == false && trackTitle.getText() != "") // play track, change to pause button
-        {
-            player->start();
-            playPauseButton.setImages(false, true, true, pauseImage, 0.5f, juce::Colours::transparentBlack, pauseImage, 1.0f, juce::Colours::transparentBlack, pauseImage, 0.5f, juce::Colours::transparentBlack);
-        }
-    }
-
-    // if stop button is clicked, stop the audio file and set position relative to 0
-    if (button == &stopButton)
-    {
-        DBG("Stop button was clicked");
-        player->stop();
-        player->setPositionRelative(0);
-        playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
-    }
-
-    // if forward button is clicked, +1 second to track position
-    if (button == &forwardButton)
-    {
-        DBG("Forward button was clicked");
-        player->setPosition(player->getPosition() + 1);
-    }
-
-    // if loop button is clicked, set isLooping to true/false accordingly
-    if (button == &loopButton)
-    {
-        DBG("Loop button was clicked");
-
-        if (isLooping && trackTitle.getText() != "")
-        {
-            isLooping = false;
-            loopButton.setImages(false, true, true, loopImage, 0.5f, juce::Colours::transparentBlack, loopImage, 1.0f, juce::Colours::transparentBlack, loopImage, 0.5f, juce::Colours::transparentBlack);
-        }
-
-        else if (isLooping == false && trackTitle.getText() != "")
-        {
-            isLooping = true;
-            loopButton.setImages(false, true, true, loopImage, 0.5f, juce::Colour(8, 227, 169), loopImage, 1.0f, juce::Colour(8, 227, 169), loopImage, 0.5f, juce::Colour(8, 227, 169));
-        }
-    }
-}
-
-void DeckGUI::sliderValueChanged(juce::Slider* slider)
-{
-    // if volume slider is moved, set volume to slider value
-    if (slider == &volSlider)
-    {
-        DBG("Vol slider moved " << slider->getValue());
-        player->setGain(slider->getValue());
-    }
-
-    // if speed slider is moved, set speed to slider value
-    if (slider == &speedSlider)
-    {
-        DBG("Speed slider moved " << slider->getValue());
-        player->setSpeed(slider->getValue());
-    }
-
-    // if position slider is moved, set position relative to slider value
-    if (slider == &posSlider)
-    {
-        DBG("Pos slider moved " << slider->getValue());
-        player->setPositionRelative(slider->getValue());
-    }
-}
-
-void DeckGUI::timerCallback()
-{
-    // update position on trackPosition and waveform display
-    if (trackTitle.getText() != "")
-    {
-        trackPosition.setText(formatTime(player->getPosition()), juce::NotificationType::dontSendNotification);
-        waveformDisplay.setPositionRelative(player->getPositionRelative());
-    }
-
-    // when track reaches the end, check if loop is enabled
-    if (player->getPositionRelative() >= 1)
-    {
-        if (isLooping)
-        {
-            player->setPositionRelative(0);
-            player->start();
-        }
-
-        else if (isLooping == false)
-        {
-            player->setPositionRelative(0);
-            player->stop();
-            playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
-        }
-    }
-}
-
-// load track onto deck
-void DeckGUI::loadTrack(juce::String filePath)
-{
-    juce::File file = juce::File(filePath);
-    player->loadURL(juce::URL(file));
-    waveformDisplay.loadURL(juce::URL(file));
-    trackTitle.setText(file.getFileName(), juce::NotificationType::dontSendNotification);
-    trackPosition.setText(formatTime(player->getPosition()), juce::NotificationType::dontSendNotification);
-    trackLength.setText(formatTime(player->getLength()), juce::NotificationType::dontSendNotification);
-    playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
-    isLooping = false;
-    loopButton.setImages(false, true, true, loopImage, 0.5f, juce::Colours::transparentBlack, loopImage, 1.0f, juce::Colours::transparentBlack, loopImage, 0.5f, juce::Colours::transparentBlack);
-    volSlider.setValue(1.0);
-    speedSlider.setValue(1.0);
-}
-
-// format time from seconds to hh:mm:ss
-juce::String DeckGUI::formatTime(double time)
-{
-    juce::String seconds, minutes, hours;
-    if (int(time) % 60 < 10) seconds = "0" + juce::String(int(time) % 60);
-    else seconds = juce::String(int(time) % 60);
-    if (int(time) / 60 % 60 < 10) minutes = "0" + juce::String(int(time) / 60 % 60);
-    else minutes = juce::String(int(time) / 60 % 60);
-    if (int(time) / 3600 < 10) hours = "0" + juce::String(int(time) / 3600);
-    else hours = juce::String(int(time) / 3600);
-
-    return hours + ":" + minutes + ":" + seconds;
-}
-
-// clear deck when track is deleted from playlist
-void DeckGUI::clearDeck()
-{
-    trackTitle.setText("", juce::NotificationType::dontSendNotification);
-    trackPosition.setText("--:--:--", juce::NotificationType::dontSendNotification);
-    trackLength.setText("--:--:--", juce::NotificationType::dontSendNotification);
-    waveformDisplay.fileLoaded = false;
-    waveformDisplay.repaint();
-    player->stop();
-    playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
-    isLooping = false;
-    loopButton.setImages(false, true, true, loopImage, 0.5f, juce::Colours::transparentBlack, loopImage, 1.0f, juce::Colours::transparentBlack, loopImage, 0.5f, juce::Colours::transparentBlack);
-    volSlider.setValue(1.0);
-    speedSlider.setValue(1.0);
-}
-
-std::vector<double> DeckGUI::getSliderValues()
-{
-    std::vector<double> sliderValues;
-
-    sliderValues.push_back(posSlider.getValue());
-    sliderValues.push_back(volSlider.getValue());
-    sliderValues.push_back(speedSlider.getValue());
-
-    return sliderValues;
-}
-
-void DeckGUI::setSliderValues(double position, double volume, double speed)
-{
-    posSlider.setValue(position);
-    volSlider.setValue(volume);
-    speedSlider.setValue(speed);
+/*
+  ==============================================================================
+
+    DeckGUI.cpp
+    Created: 31 Jan 2023 4:32:33pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "DeckGUI.h"
+#include <iostream>
+#include <fstream>
+
+DeckGUI::DeckGUI(DJAudioPlayer* _player,
+                 juce::AudioFormatManager& formatManagerToUse,
+                 WaveformCache& cacheToUse) :
+                 player(_player),
+                 waveformDisplay(formatManagerToUse, cacheToUse),
+                 zoomedWaveform(_player)
+{
+    // add and make visible labels, waveform display, sliders and buttons
+    addAndMakeVisible(trackTitle);
+    addAndMakeVisible(trackPosition);
+    addAndMakeVisible(trackLength);
+    addAndMakeVisible(waveformDisplay);
+    addAndMakeVisible(zoomedWaveform);
+    addAndMakeVisible(posSlider);
+    addAndMakeVisible(rewindButton);
+    addAndMakeVisible(playPauseButton);
+    addAndMakeVisible(stopButton);
+    addAndMakeVisible(forwardButton);
+    addAndMakeVisible(loopButton);
+    addAndMakeVisible(volSlider);
+    addAndMakeVisible(volSliderLabel);
+    addAndMakeVisible(speedSlider);
+    addAndMakeVisible(speedSliderLabel);
+    addAndMakeVisible(lowSlider);
+    addAndMakeVisible(midSlider);
+    addAndMakeVisible(highSlider);
+    addAndMakeVisible(filterSlider);
+    addAndMakeVisible(keylockButton);
+    addAndMakeVisible(syncButton);
+    addAndMakeVisible(loopInButton);
+    addAndMakeVisible(loopOutButton);
+
+    // create a pad for each hot cue, numbered from 1
+    for (int i = 0; i < DJAudioPlayer::numHotCues; ++i)
+    {
+        hotCueButtons.add(new juce::TextButton(juce::String(i + 1)));
+        addAndMakeVisible(hotCueButtons[i]);
+    }
+
+    // add listeners to sliders and buttons
+    posSlider.addListener(this);
+    rewindButton.addListener(this);
+    playPauseButton.addListener(this);
+    stopButton.addListener(this);
+    forwardButton.addListener(this);
+    loopButton.addListener(this);
+    volSlider.addListener(this);
+    speedSlider.addListener(this);
+    lowSlider.addListener(this);
+    midSlider.addListener(this);
+    highSlider.addListener(this);
+    filterSlider.addListener(this);
+    keylockButton.addListener(this);
+    syncButton.addListener(this);
+    loopInButton.addListener(this);
+    loopOutButton.addListener(this);
+
+    for (auto* hotCueButton : hotCueButtons)
+    {
+        hotCueButton->addListener(this);
+    }
+
+    // set style for trackTitle
+    trackTitle.setFont(18.0);
+
+    // set style of trackPosition
+    trackPosition.setFont(17.0);
+    trackPosition.setJustificationType(juce::Justification::centredRight);
+    trackPosition.setText("--:--:--", juce::NotificationType::dontSendNotification);
+
+    // set style of trackLength
+    trackLength.setFont(17.0);
+    trackLength.setJustificationType(juce::Justification::centredRight);
+    trackLength.setText("--:--:--", juce::NotificationType::dontSendNotification);
+
+    // set range of posSlider
+    posSlider.setRange(0.0, 1.0);
+
+    // set posSlider as transparent and overlay above the waveform display
+    // this allows the user to click on the waveform display directly to adjust the track position
+    posSlider.setSliderStyle(juce::Slider::LinearBar);
+    posSlider.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
+    posSlider.setColour(juce::Slider::trackColourId, juce::Colours::transparentWhite);
+
+    // set images of buttons
+    rewindButton.setImages(true, true, true, rewindImage, 0.5f, juce::Colours::transparentBlack, rewindImage, 1.0f, juce::Colours::transparentBlack, rewindImage, 0.5f, juce::Colours::transparentBlack);
+    playPauseButton.setImages(true, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
+    stopButton.setImages(true, true, true, stopImage, 0.5f, juce::Colours::transparentBlack, stopImage, 1.0f, juce::Colours::transparentBlack, stopImage, 0.5f, juce::Colours::transparentBlack);
+    forwardButton.setImages(true, true, true, forwardImage, 0.5f, juce::Colours::transparentBlack, forwardImage, 1.0f, juce::Colours::transparentBlack, forwardImage, 0.5f, juce::Colours::transparentBlack);
+    loopButton.setImages(true, true, true, loopImage, 0.5f, juce::Colours::transparentBlack, loopImage, 1.0f, juce::Colours::transparentBlack, loopImage, 0.5f, juce::Colours::transparentBlack);
+
+    // set range and values of volSlider
+    volSlider.setRange(0.0, 2.0);
+    volSlider.setValue(1.0);
+    volSlider.setDoubleClickReturnValue(true, 1.0);
+
+    // set style of volSlider
+    volSlider.setSliderStyle(juce::Slider::Rotary);
+    volSlider.setColour(juce::Slider::rotarySliderFillColourId, juce::Colour(11, 174, 244));
+    volSlider.setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colour(93, 96, 107));
+    volSlider.setColour(juce::Slider::thumbColourId, juce::Colours::white);
+    volSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
+    volSlider.setColour(juce::Slider::textBoxOutlineColourId, juce::Colour(35, 47, 52));
+
+    // attach label to volSlider
+    volSliderLabel.setText("VOLUME", juce::NotificationType::dontSendNotification);
+    volSliderLabel.attachToComponent(&volSlider, false);
+    volSliderLabel.setJustificationType(juce::Justification::centred);
+
+    // set range and values of speedSlider
+    speedSlider.setRange(0.0, 2.0);
+    speedSlider.setValue(1.0);
+    speedSlider.setDoubleClickReturnValue(true, 1.0);
+
+    // set style of speedSlider
+    speedSlider.setSliderStyle(juce::Slider::Rotary);
+    speedSlider.setColour(juce::Slider::rotarySliderFillColourId, juce::Colour(8, 227, 169));
+    speedSlider.setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colour(93, 96, 107));
+    speedSlider.setColour(juce::Slider::thumbColourId, juce::Colours::white);
+    speedSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
+    speedSlider.setColour(juce::Slider::textBoxOutlineColourId, juce::Colour(35, 47, 52));
+
+    // attach label to speedSlider
+    speedSliderLabel.setText("SPEED", juce::NotificationType::dontSendNotification);
+    speedSliderLabel.attachToComponent(&speedSlider, false);
+    speedSliderLabel.setJustificationType(juce::Justification::centred);
+
+    // set range and values of the EQ sliders, where 0 kills the band, and the filter slider, which is off in the centre
+    lowSlider.setRange(0.0, 2.0);
+    midSlider.setRange(0.0, 2.0);
+    highSlider.setRange(0.0, 2.0);
+    filterSlider.setRange(-1.0, 1.0);
+
+    juce::Slider* eqSliders[] = { &lowSlider, &midSlider, &highSlider, &filterSlider };
+    juce::Label* eqSliderLabels[] = { &lowSliderLabel, &midSliderLabel, &highSliderLabel, &filterSliderLabel };
+    const char* eqSliderNames[] = { "LOW", "MID", "HIGH", "FILTER" };
+
+    for (int i = 0; i < 4; ++i)
+    {
+        double defaultValue = eqSliders[i] == &filterSlider ? 0.0 : 1.0;
+        eqSliders[i]->setValue(defaultValue);
+        eqSliders[i]->setDoubleClickReturnValue(true, defaultValue);
+
+        // set style of the slider
+        eqSliders[i]->setSliderStyle(juce::Slider::Rotary);
+        eqSliders[i]->setColour(juce::Slider::rotarySliderFillColourId, juce::Colour(248, 197, 58));
+        eqSliders[i]->setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colour(93, 96, 107));
+        eqSliders[i]->setColour(juce::Slider::thumbColourId, juce::Colours::white);
+        eqSliders[i]->setTextBoxStyle(juce::Slider::TextBoxBelow, false, 50, 20);
+        eqSliders[i]->setColour(juce::Slider::textBoxOutlineColourId, juce::Colour(35, 47, 52));
+
+        // attach label to the slider
+        eqSliderLabels[i]->setText(eqSliderNames[i], juce::NotificationType::dontSendNotification);
+        eqSliderLabels[i]->attachToComponent(eqSliders[i], false);
+        eqSliderLabels[i]->setJustificationType(juce::Justification::centred);
+    }
+
+    // set style of keylockButton, which stays lit while keylock is on
+    keylockButton.setClickingTogglesState(true);
+    keylockButton.setColour(juce::TextButton::buttonColourId, juce::Colour(35, 47, 52));
+    keylockButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(8, 227, 169));
+
+    // set style of syncButton, which stays lit while the deck follows the other deck's beat
+    syncButton.setClickingTogglesState(true);
+    syncButton.setColour(juce::TextButton::buttonColourId, juce::Colour(35, 47, 52));
+    syncButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(248, 197, 58));
+
+    // set style of loopInButton and loopOutButton
+    loopInButton.setColour(juce::TextButton::buttonColourId, juce::Colour(35, 47, 52));
+    loopOutButton.setColour(juce::TextButton::buttonColourId, juce::Colour(35, 47, 52));
+
+    // set style of the hot cue pads, which are lit while their cue is set
+    for (auto* hotCueButton : hotCueButtons)
+    {
+        hotCueButton->setColour(juce::TextButton::buttonColourId, juce::Colour(35, 47, 52));
+        hotCueButton->setColour(juce::TextButton::buttonOnColourId, juce::Colour(11, 174, 244));
+    }
+
+    hotCues.assign(DJAudioPlayer::numHotCues, -1.0);
+
+    // the zoomed view scrolls over the same pyramid the overview is drawn from
+    waveformDisplay.onPyramidChanged = [this](std::shared_ptr<WaveformPyramid> newPyramid)
+    {
+        zoomedWaveform.setPyramid(newPyramid);
+    };
+
+    // timer loops every 10 milliseconds
+    startTimer(10);
+}
+
+DeckGUI::~DeckGUI()
+{
+    stopTimer();
+}
+
+void DeckGUI::paint(juce::Graphics& g)
+{
+    // set background colour
+    g.fillAll(juce::Colour(35, 47, 52));
+
+    // draw border around deck
+    g.setColour(juce::Colours::grey);
+    g.drawRect(getLocalBounds(), 1);
+}
+
+void DeckGUI::resized()
+{
+    double rowH = getHeight() / 10;
+    trackTitle.setBounds(0, 0, getWidth() * 0.75, rowH * 2);
+    trackPosition.setBounds(getWidth() * 0.75, 0, getWidth() * 0.25, rowH);
+    trackLength.setBounds(getWidth() * 0.75, rowH, getWidth() * 0.25, rowH);
+    waveformDisplay.setBounds(0, rowH * 2, getWidth(), rowH * 1.5);
+    posSlider.setBounds(0, rowH * 2, getWidth(), rowH * 1.5);
+    zoomedWaveform.setBounds(0, rowH * 3.5, getWidth(), rowH * 1.5);
+    stopButton.setBounds(0, rowH * 5.25, getWidth() * 0.2, rowH / 2);
+    rewindButton.setBounds(getWidth() * 0.2, rowH * 5.25, getWidth() * 0.2, rowH / 2);
+    playPauseButton.setBounds(getWidth() * 0.4, rowH * 5.25, getWidth() * 0.2, rowH / 2);
+    forwardButton.setBounds(getWidth() * 0.6, rowH * 5.25, getWidth() * 0.2, rowH / 2);
+    loopButton.setBounds(getWidth() * 0.8, rowH * 5.25, getWidth() * 0.2, rowH / 2);
+    volSlider.setBounds(0, rowH * 6.75, getWidth() / 6, rowH * 2.5);
+    lowSlider.setBounds(getWidth() * 1/6, rowH * 6.75, getWidth() / 6, rowH * 2.5);
+    midSlider.setBounds(getWidth() * 2/6, rowH * 6.75, getWidth() / 6, rowH * 2.5);
+    highSlider.setBounds(getWidth() * 3/6, rowH * 6.75, getWidth() / 6, rowH * 2.5);
+    filterSlider.setBounds(getWidth() * 4/6, rowH * 6.75, getWidth() / 6, rowH * 2.5);
+    speedSlider.setBounds(getWidth() * 5/6, rowH * 6.75, getWidth() / 6, rowH * 2.5);
+    syncButton.setBounds(getWidth() * 0.70, rowH * 9.25, getWidth() * 0.13, rowH * 0.5);
+    keylockButton.setBounds(getWidth() * 0.85, rowH * 9.25, getWidth() * 0.13, rowH * 0.5);
+    loopInButton.setBounds(getWidth() * 0.02, rowH * 9.25, getWidth() * 0.08, rowH * 0.5);
+    loopOutButton.setBounds(getWidth() * 0.11, rowH * 9.25, getWidth() * 0.08, rowH * 0.5);
+
+    for (int i = 0; i < hotCueButtons.size(); ++i)
+    {
+        hotCueButtons[i]->setBounds(getWidth() * (0.21 + i * 0.059), rowH * 9.25, getWidth() * 0.05, rowH * 0.5);
+    }
+}
+
+void DeckGUI::buttonClicked(juce::Button* button)
+{
+    // if rewind button is clicked, -1 second to track position
+    if (button == &rewindButton)
+    {
+        DBG("Rewind button was clicked");
+        player->setPosition(player->getPosition() - 1);
+    }
+
+    // if play/pause button is clicked, start/stop the audio file accordingly
+    if (button == &playPauseButton)
+    {
+        DBG("Play/pause button was clicked");
+
+        if (player->isPlaying() && trackTitle.getText() != "") // pause track, change to play button
+        {
+            player->stop();
+            playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
+        }
+
+        else if (player->isPlaying() == false && trackTitle.getText() != "") // play track, change to pause button
+        {
+            player->start();
+            playPauseButton.setImages(false, true, true, pauseImage, 0.5f, juce::Colours::transparentBlack, pauseImage, 1.0f, juce::Colours::transparentBlack, pauseImage, 0.5f, juce::Colours::transparentBlack);
+        }
+    }
+
+    // if stop button is clicked, stop the audio file and set position relative to 0
+    if (button == &stopButton)
+    {
+        DBG("Stop button was clicked");
+        player->stop();
+        player->setPositionRelative(0);
+        playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
+    }
+
+    // if forward button is clicked, +1 second to track position
+    if (button == &forwardButton)
+    {
+        DBG("Forward button was clicked");
+        player->setPosition(player->getPosition() + 1);
+    }
+
+    // if loop button is clicked, loop the marked region, or the whole track if no region is marked
+    if (button == &loopButton)
+    {
+        DBG("Loop button was clicked");
+
+        if (isLooping && trackTitle.getText() != "")
+        {
+            setLooping(false);
+        }
+
+        else if (isLooping == false && trackTitle.getText() != "")
+        {
+            if (loopIn >= 0 && loopOut > loopIn)
+            {
+                player->setLoopRegion(loopIn, loopOut);
+            }
+
+            else
+            {
+                player->setLoopRegion(0, player->getLength());
+            }
+
+            setLooping(true);
+        }
+    }
+
+    // if loop in button is clicked, mark the loop-in point at the current position
+    if (button == &loopInButton && trackTitle.getText() != "")
+    {
+        DBG("Loop in button was clicked");
+        loopIn = player->getPosition();
+        loopOut = -1;
+    }
+
+    // if loop out button is clicked, mark the loop-out point and start looping straight away
+    if (button == &loopOutButton && trackTitle.getText() != "")
+    {
+        DBG("Loop out button was clicked");
+
+        if (loopIn >= 0 && player->getPosition() > loopIn)
+        {
+            loopOut = player->getPosition();
+            player->setLoopRegion(loopIn, loopOut);
+            setLooping(true);
+        }
+    }
+
+    // if keylock button is clicked, keep the pitch when the speed changes
+    if (button == &keylockButton)
+    {
+        DBG("Keylock button was clicked");
+        player->setKeylock(keylockButton.getToggleState());
+    }
+
+    // if sync button is clicked, lock the tempo and beat phase to the other deck
+    if (button == &syncButton)
+    {
+        DBG("Sync button was clicked");
+        player->setSyncEnabled(syncButton.getToggleState());
+    }
+
+    // if a hot cue pad is clicked, jump to its cue and play, or set the cue at the current position if it is
+    // not set yet, and shift-click clears it
+    int hotCue = hotCueButtons.indexOf(dynamic_cast<juce::TextButton*>(button));
+
+    if (hotCue >= 0 && trackTitle.getText() != "" && player->isLoading() == false)
+    {
+        DBG("Hot cue " << hotCue + 1 << " was clicked");
+
+        if (juce::ModifierKeys::currentModifiers.isShiftDown())
+        {
+            hotCues[hotCue] = -1;
+            player->clearHotCue(hotCue);
+        }
+
+        else if (hotCues[hotCue] < 0)
+        {
+            hotCues[hotCue] = player->getPosition();
+            player->setHotCue(hotCue, hotCues[hotCue]);
+        }
+
+        else
+        {
+            player->triggerHotCue(hotCue);
+            playPauseButton.setImages(false, true, true, pauseImage, 0.5f, juce::Colours::transparentBlack, pauseImage, 1.0f, juce::Colours::transparentBlack, pauseImage, 0.5f, juce::Colours::transparentBlack);
+        }
+
+        updateHotCueButtons();
+    }
+}
+
+void DeckGUI::sliderValueChanged(juce::Slider* slider)
+{
+    // if volume slider is moved, set volume to slider value
+    if (slider == &volSlider)
+    {
+        DBG("Vol slider moved " << slider->getValue());
+        player->setGain(slider->getValue());
+    }
+
+    // if speed slider is moved, set speed to slider value
+    if (slider == &speedSlider)
+    {
+        DBG("Speed slider moved " << slider->getValue());
+        player->setSpeed(slider->getValue());
+    }
+
+    // if an EQ slider is moved, set the gain of its band
+    if (slider == &lowSlider)
+    {
+        DBG("Low slider moved " << slider->getValue());
+        player->setEqGain(DeckEqualiser::Band::low, slider->getValue());
+    }
+
+    if (slider == &midSlider)
+    {
+        DBG("Mid slider moved " << slider->getValue());
+        player->setEqGain(DeckEqualiser::Band::mid, slider->getValue());
+    }
+
+    if (slider == &highSlider)
+    {
+        DBG("High slider moved " << slider->getValue());
+        player->setEqGain(DeckEqualiser::Band::high, slider->getValue());
+    }
+
+    // if filter slider is moved, sweep the low-pass or high-pass filter
+    if (slider == &filterSlider)
+    {
+        DBG("Filter slider moved " << slider->getValue());
+        player->setFilter(slider->getValue());
+    }
+
+    // if position slider is moved, set position relative to slider value
+    if (slider == &posSlider)
+    {
+        DBG("Pos slider moved " << slider->getValue());
+        player->setPositionRelative(slider->getValue());
+    }
+}
+
+void DeckGUI::timerCallback()
+{
+    // update position on trackPosition and waveform display
+    if (trackTitle.getText() != "" && player->isLoading() == false)
+    {
+        trackPosition.setText(formatTime(player->getPosition()), juce::NotificationType::dontSendNotification);
+        waveformDisplay.setPositionRelative(player->getPositionRelative());
+    }
+
+    // loops are wrapped by the player, so the track only reaches the end when it is not looping
+    if (player->getPositionRelative() >= 1)
+    {
+        player->setPositionRelative(0);
+        player->stop();
+        playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
+    }
+}
+
+// load track onto deck, showing the loading state until the player has prepared the track in the background
+void DeckGUI::loadTrack(juce::String filePath)
+{
+    juce::File file = juce::File(filePath);
+    player->stop();
+    waveformDisplay.loadURL(juce::URL(file));
+    trackTitle.setText(file.getFileName(), juce::NotificationType::dontSendNotification);
+    trackPosition.setText("--:--:--", juce::NotificationType::dontSendNotification);
+    trackLength.setText("LOADING", juce::NotificationType::dontSendNotification);
+    playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
+    setLooping(false);
+    loopIn = -1;
+    loopOut = -1;
+    volSlider.setValue(1.0);
+    speedSlider.setValue(1.0);
+    lowSlider.setValue(1.0);
+    midSlider.setValue(1.0);
+    highSlider.setValue(1.0);
+    filterSlider.setValue(0.0);
+    setBeatGrid(0, 0);
+    resetHotCues();
+    pendingPosition = -1;
+
+    juce::Component::SafePointer<DeckGUI> safeThis(this);
+
+    player->loadURLAsync(juce::URL(file), [safeThis](bool loaded)
+    {
+        if (safeThis == nullptr)
+        {
+            return;
+        }
+
+        // apply a position that was restored while the track was still loading
+        if (loaded && safeThis->pendingPosition >= 0)
+        {
+            safeThis->player->setPositionRelative(safeThis->pendingPosition);
+        }
+
+        // and the hot cues that were handed over while it was loading
+        if (loaded && safeThis->hotCuesPending)
+        {
+            safeThis->applyHotCues();
+        }
+
+        safeThis->hotCuesPending = false;
+
+        safeThis->pendingPosition = -1;
+        safeThis->trackPosition.setText(loaded ? safeThis->formatTime(safeThis->player->getPosition()) : "--:--:--", juce::NotificationType::dontSendNotification);
+        safeThis->trackLength.setText(loaded ? safeThis->formatTime(safeThis->player->getLength()) : "--:--:--", juce::NotificationType::dontSendNotification);
+    });
+}
+
+// format time from seconds to hh:mm:ss
+juce::String DeckGUI::formatTime(double time)
+{
+    juce::String seconds, minutes, hours;
+    if (int(time) % 60 < 10) seconds = "0" + juce::String(int(time) % 60);
+    else seconds = juce::String(int(time) % 60);
+    if (int(time) / 60 % 60 < 10) minutes = "0" + juce::String(int(time) / 60 % 60);
+    else minutes = juce::String(int(time) / 60 % 60);
+    if (int(time) / 3600 < 10) hours = "0" + juce::String(int(time) / 3600);
+    else hours = juce::String(int(time) / 3600);
+
+    return hours + ":" + minutes + ":" + seconds;
+}
+
+// clear deck when track is deleted from playlist
+void DeckGUI::clearDeck()
+{
+    trackTitle.setText("", juce::NotificationType::dontSendNotification);
+    trackPosition.setText("--:--:--", juce::NotificationType::dontSendNotification);
+    trackLength.setText("--:--:--", juce::NotificationType::dontSendNotification);
+    waveformDisplay.fileLoaded = false;
+    waveformDisplay.fileLoading = false;
+    waveformDisplay.repaint();
+    zoomedWaveform.setPyramid(nullptr);
+    player->stop();
+    playPauseButton.setImages(false, true, true, playImage, 0.5f, juce::Colours::transparentBlack, playImage, 1.0f, juce::Colours::transparentBlack, playImage, 0.5f, juce::Colours::transparentBlack);
+    setLooping(false);
+    loopIn = -1;
+    loopOut = -1;
+    volSlider.setValue(1.0);
+    speedSlider.setValue(1.0);
+    lowSlider.setValue(1.0);
+    midSlider.setValue(1.0);
+    highSlider.setValue(1.0);
+    filterSlider.setValue(0.0);
+    setBeatGrid(0, 0);
+    resetHotCues();
+}
+
+bool DeckGUI::isPlaying()
+{
+    return player->isPlaying();
+}
+
+void DeckGUI::setBeatGrid(double bpm, double firstBeat)
+{
+    if (bpm != gridBpm || firstBeat != gridFirstBeat)
+    {
+        gridBpm = bpm;
+        gridFirstBeat = firstBeat;
+        player->setBeatGrid(bpm, firstBeat);
+        zoomedWaveform.setBeatGrid(bpm, firstBeat);
+    }
+}
+
+void DeckGUI::setHotCues(const juce::String& filePath, const std::vector<double>& positions)
+{
+    hotCueTrack = filePath;
+    hotCues.assign(DJAudioPlayer::numHotCues, -1.0);
+
+    for (int i = 0; i < (int) positions.size() && i < DJAudioPlayer::numHotCues; ++i)
+    {
+        hotCues[i] = positions[i];
+    }
+
+    // the player drops the hot cues of the previous track when the new one is swapped in, so wait for that
+    if (player->isLoading())
+    {
+        hotCuesPending = true;
+    }
+
+    else
+    {
+        applyHotCues();
+    }
+
+    updateHotCueButtons();
+}
+
+std::vector<double> DeckGUI::getHotCues()
+{
+    return hotCues;
+}
+
+juce::String DeckGUI::getHotCueTrack()
+{
+    return hotCueTrack;
+}
+
+std::vector<double> DeckGUI::getSliderValues()
+{
+    std::vector<double> sliderValues;
+
+    sliderValues.push_back(posSlider.getValue());
+    sliderValues.push_back(volSlider.getValue());
+    sliderValues.push_back(speedSlider.getValue());
+
+    return sliderValues;
+}
+
+void DeckGUI::setSliderValues(double position, double volume, double speed)
+{
+    // the player cannot seek until the track has loaded, so keep the position until then
+    if (player->isLoading())
+    {
+        pendingPosition = position;
+    }
+
+    posSlider.setValue(position);
+    volSlider.setValue(volume);
+    speedSlider.setValue(speed);
+}
+
+// light the loop button and tell the player whether to wrap at the loop-out point
+void DeckGUI::setLooping(bool shouldLoop)
+{
+    isLooping = shouldLoop;
+    player->setLooping(shouldLoop);
+
+    if (shouldLoop)
+    {
+        loopButton.setImages(false, true, true, loopImage, 0.5f, juce::Colour(8, 227, 169), loopImage, 1.0f, juce::Colour(8, 227, 169), loopImage, 0.5f, juce::Colour(8, 227, 169));
+    }
+
+    else
+    {
+        loopButton.setImages(false, true, true, loopImage, 0.5f, juce::Colours::transparentBlack, loopImage, 1.0f, juce::Colours::transparentBlack, loopImage, 0.5f, juce::Colours::transparentBlack);
+    }
+}
+
+// hand every set hot cue to the player, which decodes the audio after each one in the background
+void DeckGUI::applyHotCues()
+{
+    for (int i = 0; i < DJAudioPlayer::numHotCues; ++i)
+    {
+        if (hotCues[i] >= 0)
+        {
+            player->setHotCue(i, hotCues[i]);
+        }
+
+        else
+        {
+            player->clearHotCue(i);
+        }
+    }
+}
+
+// forget the hot cues of the previous track, the playlist hands over the new track's
+void DeckGUI::resetHotCues()
+{
+    hotCues.assign(DJAudioPlayer::numHotCues, -1.0);
+    hotCueTrack = "";
+    hotCuesPending = false;
+    player->clearHotCues();
+    updateHotCueButtons();
+}
+
+// light the pads of the hot cues that are set
+void DeckGUI::updateHotCueButtons()
+{
+    for (int i = 0; i < hotCueButtons.size(); ++i)
+    {
+        hotCueButtons[i]->setToggleState(hotCues[i] >= 0, juce::NotificationType::dontSendNotification);
+    }
 }
\ No newline at end of file
@@ -1,71 +1,118 @@
-/*
-  ==============================================================================
-
-    DeckGUI.h
-    Created: 31 Jan 2023 4:32:33pm
-    Author:  cheng
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "DJAudioPlayer.h"
-#include "WaveformDisplay.h"
-
-class DeckGUI : public juce::Component,
-                public juce::Button::Listener,
-                public juce::Slider::Listener,
-                public juce::Timer
-{
-public:
-    DeckGUI(DJAudioPlayer* player,
-            juce::AudioFormatManager & formatManagerToUse,
-            juce::AudioThumbnailCache & cacheToUse);
-    ~DeckGUI();
-
-    void paint(juce::Graphics& g) override;
-    void resized() override;
-
-    void buttonClicked(juce::Button* button) override;
-    void sliderValueChanged(juce::Slider* slider) override;
-
-    void timerCallback() override;
-
-    void loadTrack(juce::String filePath);
-
-    juce::String formatTime(double time);
-
-    void clearDeck();
-
-    std::vector<double> getSliderValues();
-    void setSliderValues(double position, double volume, double speed);
-
-private:
-    juce::Label trackTitle;
-    juce::Label trackPosition;
-    juce::Label trackLength;
-    juce::Slider posSlider;
-    juce::Image rewindImage{ juce::ImageFileFormat::loadFrom(BinaryData::rewindbutton_png, BinaryData::rewindbutton_pngSize) };
-    juce::ImageButton rewindButton;
-    juce::Image playImage{ juce::ImageFileFormat::loadFrom(BinaryData::playbutton_png, BinaryData::playbutton_pngSize) };
-    juce::Image pauseImage{ juce::ImageFileFormat::loadFrom(BinaryData::pausebutton_png, BinaryData::pausebutton_pngSize) };
-    juce::ImageButton playPauseButton;
-    juce::Image stopImage{ juce::ImageFileFormat::loadFrom(BinaryData::stopbutton_png, BinaryData::stopbutton_pngSize) };
-    juce::ImageButton stopButton;
-    juce::Image forwardImage{ juce::ImageFileFormat::loadFrom(BinaryData::forwardbutton_png, BinaryData::forwardbutton_pngSize) };
-    juce::ImageButton forwardButton;
-    juce::Image loopImage{ juce::ImageFileFormat::loadFrom(BinaryData::loopbutton_png, BinaryData::loopbutton_pngSize) };
-    juce::ImageButton loopButton;
-    bool isLooping = false;
-    juce::Slider volSlider;
-    juce::Label volSliderLabel;
-    juce::Slider speedSlider;
-    juce::Label speedSliderLabel;
-
-    DJAudioPlayer* player;
-    WaveformDisplay waveformDisplay;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckGUI)
+/*
+  ==============================================================================
+
+    DeckGUI.h
+    Created: 31 Jan 2023 4:32:33pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "WaveformDisplay.h"
+#include "ScrollingWaveform.h"
+
+class DeckGUI : public juce::Component,
+                public juce::Button::Listener,
+                public juce::Slider::Listener,
+                public juce::Timer
+{
+public:
+    DeckGUI(DJAudioPlayer* player,
+            juce::AudioFormatManager & formatManagerToUse,
+            WaveformCache & cacheToUse);
+    ~DeckGUI();
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    void buttonClicked(juce::Button* button) override;
+    void sliderValueChanged(juce::Slider* slider) override;
+
+    void timerCallback() override;
+
+    void loadTrack(juce::String filePath);
+
+    juce::String formatTime(double time);
+
+    void clearDeck();
+    bool isPlaying();
+
+    // hand the player the beat grid of the loaded track once it has been analysed, only passed on when it changes
+    void setBeatGrid(double bpm, double firstBeat);
+
+    // hot cues of the track in filePath in seconds, -1 for a cue that is not set, handed over by the playlist
+    // which keeps them in the library, and applied once the track has loaded
+    void setHotCues(const juce::String& filePath, const std::vector<double>& positions);
+    std::vector<double> getHotCues();
+
+    // the track the hot cues were last handed over for, empty after loading another track
+    juce::String getHotCueTrack();
+
+    std::vector<double> getSliderValues();
+    void setSliderValues(double position, double volume, double speed);
+
+private:
+    void setLooping(bool shouldLoop);
+    void applyHotCues();
+    void resetHotCues();
+    void updateHotCueButtons();
+
+    juce::Label trackTitle;
+    juce::Label trackPosition;
+    juce::Label trackLength;
+    juce::Slider posSlider;
+    juce::Image rewindImage{ juce::ImageFileFormat::loadFrom(BinaryData::rewindbutton_png, BinaryData::rewindbutton_pngSize) };
+    juce::ImageButton rewindButton;
+    juce::Image playImage{ juce::ImageFileFormat::loadFrom(BinaryData::playbutton_png, BinaryData::playbutton_pngSize) };
+    juce::Image pauseImage{ juce::ImageFileFormat::loadFrom(BinaryData::pausebutton_png, BinaryData::pausebutton_pngSize) };
+    juce::ImageButton playPauseButton;
+    juce::Image stopImage{ juce::ImageFileFormat::loadFrom(BinaryData::stopbutton_png, BinaryData::stopbutton_pngSize) };
+    juce::ImageButton stopButton;
+    juce::Image forwardImage{ juce::ImageFileFormat::loadFrom(BinaryData::forwardbutton_png, BinaryData::forwardbutton_pngSize) };
+    juce::ImageButton forwardButton;
+    juce::Image loopImage{ juce::ImageFileFormat::loadFrom(BinaryData::loopbutton_png, BinaryData::loopbutton_pngSize) };
+    juce::ImageButton loopButton;
+    bool isLooping = false;
+    juce::Slider volSlider;
+    juce::Label volSliderLabel;
+    juce::Slider speedSlider;
+    juce::Label speedSliderLabel;
+    juce::Slider lowSlider;
+    juce::Label lowSliderLabel;
+    juce::Slider midSlider;
+    juce::Label midSliderLabel;
+    juce::Slider highSlider;
+    juce::Label highSliderLabel;
+    juce::Slider filterSlider;
+    juce::Label filterSliderLabel;
+    juce::TextButton keylockButton{ "KEYLOCK" };
+    juce::TextButton syncButton{ "SYNC" };
+    juce::TextButton loopInButton{ "IN" };
+    juce::TextButton loopOutButton{ "OUT" };
+    juce::OwnedArray<juce::TextButton> hotCueButtons;
+
+    // loop points marked with the IN and OUT buttons, in seconds, -1 when not marked
+    double loopIn = -1;
+    double loopOut = -1;
+
+    double pendingPosition = -1;
+
+    // hot cue positions in seconds, -1 when not set, and the track they belong to
+    std::vector<double> hotCues;
+    juce::String hotCueTrack;
+    bool hotCuesPending = false;
+
+    // the beat grid last handed to the player, 0 bpm for none
+    double gridBpm = 0;
+    double gridFirstBeat = 0;
+
+    DJAudioPlayer* player;
+    WaveformDisplay waveformDisplay;
+    ScrollingWaveform zoomedWaveform;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckGUI)
 };
\ No newline at end of file
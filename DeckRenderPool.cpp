@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    DeckRenderPool.cpp
+    Created: 17 Oct 2026 4:48:33pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "DeckRenderPool.h"
+
+namespace
+{
+    // a ticket is the generation in the top 32 bits, the number of jobs in the next 8 and the job index below
+    const int numJobsShift = 24;
+    const juce::uint64 indexMask = (1 << numJobsShift) - 1;
+
+    juce::uint64 getGeneration(juce::uint64 ticket)
+    {
+        return ticket >> 32;
+    }
+
+    int getNumJobs(juce::uint64 ticket)
+    {
+        return (int) ((ticket >> numJobsShift) & 0xff);
+    }
+
+    int getIndex(juce::uint64 ticket)
+    {
+        return (int) (ticket & indexMask);
+    }
+}
+
+DeckRenderPool::DeckRenderPool(int _numWorkers)
+{
+    for (int i = 0; i < _numWorkers; ++i)
+    {
+        workers.add(new Worker(*this, i));
+    }
+}
+
+DeckRenderPool::~DeckRenderPool()
+{
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->wake();
+    }
+
+    for (auto* worker : workers)
+    {
+        worker->stopThread(1000);
+    }
+}
+
+bool DeckRenderPool::start()
+{
+    if (running)
+    {
+        return true;
+    }
+
+    int numCpus = juce::SystemStats::getNumCpus();
+    bool anyRealtime = false;
+
+    for (int i = 0; i < workers.size(); ++i)
+    {
+        // pin each worker to its own core, leaving the first one to the device's callback thread
+        if (numCpus > 1)
+        {
+            workers[i]->setAffinityMask((juce::uint32) 1 << ((i + 1) % juce::jmin(numCpus, 32)));
+        }
+
+        if (workers[i]->startRealtimeThread(juce::Thread::RealtimeOptions{}))
+        {
+            anyRealtime = true;
+        }
+
+        else
+        {
+            DBG("DeckRenderPool::start worker " << i << " could not get real-time priority");
+            workers[i]->startThread(juce::Thread::Priority::highest);
+        }
+    }
+
+    running = true;
+    return anyRealtime;
+}
+
+bool DeckRenderPool::isRunning()
+{
+    return running;
+}
+
+int DeckRenderPool::getNumWorkers()
+{
+    return workers.size();
+}
+
+void DeckRenderPool::run(int numJobs, const std::function<void(int)>& renderJob)
+{
+    jassert(numJobs <= maxJobs);
+    numJobs = juce::jmin(numJobs, maxJobs);
+
+    if (numJobs <= 0)
+    {
+        return;
+    }
+
+    // fork: publish the jobs with a fresh generation, and wake any worker that has gone to sleep. the publish
+    // is sequentially consistent so that it pairs with a worker going to sleep, see Worker::run
+    job.store(&renderJob, std::memory_order_relaxed);
+    numRemaining.store(numJobs, std::memory_order_relaxed);
+
+    juce::uint64 generation = getGeneration(jobCounter.load(std::memory_order_relaxed)) + 1;
+    jobCounter.store((generation << 32) | ((juce::uint64) numJobs << numJobsShift), std::memory_order_seq_cst);
+
+    for (auto* worker : workers)
+    {
+        worker->wake();
+    }
+
+    // join: take jobs alongside the workers, then spin until the ones they took are finished
+    work();
+
+    while (numRemaining.load(std::memory_order_acquire) > 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+// take tickets until the current block runs out of jobs
+void DeckRenderPool::work()
+{
+    while (true)
+    {
+        juce::uint64 ticket = jobCounter.fetch_add(1, std::memory_order_acq_rel);
+
+        if (getIndex(ticket) >= getNumJobs(ticket))
+        {
+            return;
+        }
+
+        (*job.load(std::memory_order_relaxed))(getIndex(ticket));
+        numRemaining.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+DeckRenderPool::Worker::Worker(DeckRenderPool& _pool, int _index) :
+                               juce::Thread("Deck render " + juce::String(_index + 1)),
+                               pool(_pool)
+{
+
+}
+
+// spin on the job counter while blocks keep arriving, and sleep once they stop
+void DeckRenderPool::Worker::run()
+{
+    juce::ScopedNoDenormals noDenormals;
+    juce::uint64 seenGeneration = getGeneration(pool.jobCounter.load(std::memory_order_acquire));
+    double lastWorkTime = juce::Time::getMillisecondCounterHiRes();
+
+    while (threadShouldExit() == false)
+    {
+        juce::uint64 generation = getGeneration(pool.jobCounter.load(std::memory_order_acquire));
+
+        if (generation != seenGeneration)
+        {
+            seenGeneration = generation;
+            pool.work();
+            lastWorkTime = juce::Time::getMillisecondCounterHiRes();
+        }
+
+        else if (juce::Time::getMillisecondCounterHiRes() - lastWorkTime < spinTimeMs)
+        {
+            std::this_thread::yield();
+        }
+
+        else
+        {
+            // check the counter again after saying we are asleep, so that a block published in between
+            // is never missed. both sides store then load, this side sleeping then the counter and run() the
+            // counter then sleeping, and only with all four sequentially consistent is at least one of the
+            // loads sure to see the other side's store, so either this sees the block or wake() sees us asleep
+            sleeping.store(true, std::memory_order_seq_cst);
+
+            if (getGeneration(pool.jobCounter.load(std::memory_order_seq_cst)) == seenGeneration)
+            {
+                wakeEvent.wait(100);
+            }
+
+            sleeping = false;
+            lastWorkTime = juce::Time::getMillisecondCounterHiRes();
+        }
+    }
+}
+
+// only signal a worker that is actually waiting, so a running pool never touches the event
+void DeckRenderPool::Worker::wake()
+{
+    if (sleeping.load(std::memory_order_seq_cst) || threadShouldExit())
+    {
+        wakeEvent.signal();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    DeckRenderPool.h
+    Created: 17 Oct 2026 4:48:33pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// a small pool of pinned real-time threads that share out the decks of each audio block with the
+// audio thread, which joins in and then waits on a lock-free counter until every deck is done
+class DeckRenderPool
+{
+public:
+    DeckRenderPool(int _numWorkers);
+    ~DeckRenderPool();
+
+    // start the workers, from the message thread, returns false if none could be given real-time priority
+    bool start();
+    bool isRunning();
+    int getNumWorkers();
+
+    // call renderJob(i) for every i below numJobs, spread over the workers and the calling thread,
+    // returning once all of them have finished, renderJob must outlive the pool
+    void run(int numJobs, const std::function<void(int)>& renderJob);
+
+    // workers spin this long after their last block before going to sleep
+    static constexpr double spinTimeMs = 5.0;
+    static constexpr int maxJobs = 255;
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(DeckRenderPool& _pool, int _index);
+        void run() override;
+        void wake();
+
+    private:
+        DeckRenderPool& pool;
+        std::atomic<bool> sleeping{ false };
+        juce::WaitableEvent wakeEvent;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+    };
+
+    void work();
+
+    juce::OwnedArray<Worker> workers;
+    bool running = false;
+
+    // every ticket taken from jobCounter carries the block's generation, its number of jobs and the
+    // index of the job it hands out, so a worker still finishing one block can never miscount the next
+    std::atomic<const std::function<void(int)>*> job{ nullptr };
+    std::atomic<juce::uint64> jobCounter{ 0 };
+    std::atomic<int> numRemaining{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckRenderPool)
+};
\ No newline at end of file
@@ -0,0 +1,1327 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+    Created: 17 Oct 2026 8:41:09pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "EngineBenchmark.h"
+
+namespace
+{
+    const int numRuns = 5;
+    const int numWarmUpBlocks = 50;
+    const int numMeasuredBlocks = 200;
+
+    // plays the same block over and over, so that mixing can be measured without the cost of making its inputs
+    class BlockSource : public juce::AudioSource
+    {
+    public:
+        BlockSource(const juce::AudioBuffer<float>& _block) :
+                    block(_block)
+        {
+
+        }
+
+        void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override
+        {
+            for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+            {
+                bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample, block, channel % block.getNumChannels(), 0, bufferToFill.numSamples);
+            }
+        }
+
+    private:
+        const juce::AudioBuffer<float>& block;
+    };
+
+    // finds where each click of a click track starts in a deck's output, to a fraction of a sample, from where
+    // the pulse's rising edge crosses half its height
+    class OnsetDetector
+    {
+    public:
+        OnsetDetector(double _sampleRate) :
+                      sampleRate(_sampleRate)
+        {
+
+        }
+
+        void process(const float* samples, int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float sample = std::abs(samples[i]);
+
+                if (lastSample < threshold && sample >= threshold && position + i - lastOnsetSample > (juce::int64) (sampleRate * 0.1))
+                {
+                    double fraction = (threshold - lastSample) / (sample - lastSample);
+                    onsets.push_back((position + i - 1 + fraction) / sampleRate);
+                    lastOnsetSample = position + i;
+                }
+
+                lastSample = sample;
+            }
+
+            position += numSamples;
+        }
+
+        std::vector<double> onsets;
+        static constexpr float threshold = 0.4f;
+
+    private:
+        double sampleRate;
+        juce::int64 position = 0;
+        juce::int64 lastOnsetSample = -(1 << 30);
+        float lastSample = 0;
+    };
+
+    juce::var makeResult(std::initializer_list<std::pair<const char*, juce::var>> properties)
+    {
+        auto* result = new juce::DynamicObject();
+
+        for (auto& property : properties)
+        {
+            result->setProperty(property.first, property.second);
+        }
+
+        return juce::var(result);
+    }
+}
+
+EngineBenchmark::EngineBenchmark(double _sampleRate, int _blockSize) :
+                                 sampleRate(_sampleRate),
+                                 blockSize(_blockSize)
+{
+    formatManager.registerBasicFormats();
+    readAheadThread.startThread();
+
+    testDirectory = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("otodecks-benchmark");
+    wavFile = testDirectory.getChildFile("test.wav");
+    flacFile = testDirectory.getChildFile("test.flac");
+}
+
+EngineBenchmark::~EngineBenchmark()
+{
+    readAheadThread.stopThread(2000);
+    testDirectory.deleteRecursively();
+}
+
+void EngineBenchmark::addTrack(const juce::File& track)
+{
+    extraTracks.add(track);
+}
+
+bool EngineBenchmark::run(juce::var& results, juce::String& error)
+{
+    if (createTestFiles() == false)
+    {
+        error = "cannot write test files to " + testDirectory.getFullPathName();
+        return false;
+    }
+
+    auto* object = new juce::DynamicObject();
+    results = juce::var(object);
+
+    object->setProperty("system", makeResult({ { "cpu", juce::SystemStats::getCpuModel() },
+                                               { "cpuMHz", juce::SystemStats::getCpuSpeedInMegahertz() },
+                                               { "logicalCpus", juce::SystemStats::getNumCpus() },
+                                               { "physicalCpus", juce::SystemStats::getNumPhysicalCpus() },
+                                               { "os", juce::SystemStats::getOperatingSystemName() },
+                                              #if JUCE_DEBUG
+                                               { "build", "debug" },
+                                              #else
+                                               { "build", "release" },
+                                              #endif
+                                               { "sampleRate", sampleRate },
+                                               { "blockSize", blockSize },
+                                               { "blockMs", getBlockTime() * 1000.0 } }));
+
+    failedChecks.clear();
+
+    juce::var sync = benchmarkSync();
+    object->setProperty("sync", sync);
+
+    if ((bool) sync["heldUnder1ms"] == false)
+    {
+        failedChecks.add("sync: max phase error " + juce::String((double) sync["maxErrorMs"], 3) + " ms over "
+                         + juce::String(syncTestLength) + " s, should be under " + juce::String(maxSyncErrorMs) + " ms");
+    }
+
+    object->setProperty("failedChecks", failedChecks);
+
+    if (checksOnly)
+    {
+        return true;
+    }
+
+    object->setProperty("load", benchmarkLoad());
+    object->setProperty("seek", benchmarkSeek());
+    object->setProperty("deckRender", benchmarkDeckRender());
+    object->setProperty("keylockBudget", benchmarkKeylockBudget());
+    object->setProperty("resampler", benchmarkResampler());
+    object->setProperty("stretcher", benchmarkStretcher());
+    object->setProperty("equaliser", benchmarkEqualiser());
+    object->setProperty("mixer", benchmarkMixer());
+    object->setProperty("decksPerCore", benchmarkDecksPerCore());
+    object->setProperty("hotCues", benchmarkHotCues());
+    object->setProperty("recorder", benchmarkRecorder());
+    object->setProperty("waveform", benchmarkWaveform());
+    object->setProperty("waveformCache", benchmarkWaveformCache());
+    object->setProperty("waveformFrame", benchmarkWaveformFrame());
+    object->setProperty("scrollingWaveform", benchmarkScrollingWaveform());
+
+    return true;
+}
+
+void EngineBenchmark::setChecksOnly(bool shouldOnlyCheck)
+{
+    checksOnly = shouldOnlyCheck;
+}
+
+const juce::StringArray& EngineBenchmark::getFailedChecks()
+{
+    return failedChecks;
+}
+
+bool EngineBenchmark::createTestFiles()
+{
+    testDirectory.createDirectory();
+
+    return writeTestFile(wavFile) && writeTestFile(flacFile);
+}
+
+// a logarithmic sweep from 50 Hz to 10 kHz on the left and the same with noise on the right, so that
+// compressed formats have something realistic to decode
+bool EngineBenchmark::writeTestFile(const juce::File& file)
+{
+    auto* format = formatManager.findFormatForFileExtension(file.getFileExtension());
+    std::unique_ptr<juce::FileOutputStream> stream = file.createOutputStream();
+
+    if (format == nullptr || stream == nullptr)
+    {
+        return false;
+    }
+
+    stream->setPosition(0);
+    stream->truncate();
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate, 2, 24, {}, 0));
+
+    if (writer == nullptr)
+    {
+        return false;
+    }
+
+    // the writer owns the stream from here on
+    stream.release();
+
+    juce::AudioBuffer<float> buffer(2, 4096);
+    juce::Random random(1);
+    juce::int64 numSamples = (juce::int64) (testFileLength * sampleRate);
+    double phase = 0;
+
+    for (juce::int64 start = 0; start < numSamples; start += buffer.getNumSamples())
+    {
+        int blockLength = (int) juce::jmin((juce::int64) buffer.getNumSamples(), numSamples - start);
+
+        for (int i = 0; i < blockLength; ++i)
+        {
+            double frequency = 50.0 * std::pow(200.0, (double) (start + i) / (double) numSamples);
+            phase += juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            float sample = 0.5f * (float) std::sin(phase);
+            buffer.setSample(0, i, sample);
+            buffer.setSample(1, i, sample + 0.1f * (random.nextFloat() * 2.0f - 1.0f));
+        }
+
+        if (writer->writeFromAudioSampleBuffer(buffer, 0, blockLength) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// a mono click track with a raised cosine pulse, 0.5 ms wide, on every beat from firstBeat, placed to a fraction
+// of a sample so that the grid it is given is exact
+bool EngineBenchmark::writeClickTrack(const juce::File& file, double bpm, double firstBeat, double length)
+{
+    auto* format = formatManager.findFormatForFileExtension(file.getFileExtension());
+    std::unique_ptr<juce::FileOutputStream> stream = file.createOutputStream();
+
+    if (format == nullptr || stream == nullptr)
+    {
+        return false;
+    }
+
+    stream->setPosition(0);
+    stream->truncate();
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate, 1, 24, {}, 0));
+
+    if (writer == nullptr)
+    {
+        return false;
+    }
+
+    // the writer owns the stream from here on
+    stream.release();
+
+    const double pulseWidth = 0.0005;
+    double beatLength = 60.0 / bpm;
+    juce::AudioBuffer<float> buffer(1, 4096);
+    juce::int64 numSamples = (juce::int64) (length * sampleRate);
+
+    for (juce::int64 start = 0; start < numSamples; start += buffer.getNumSamples())
+    {
+        int blockLength = (int) juce::jmin((juce::int64) buffer.getNumSamples(), numSamples - start);
+
+        for (int i = 0; i < blockLength; ++i)
+        {
+            double time = (start + i) / sampleRate;
+            double sincePulse = time - firstBeat - std::floor((time - firstBeat) / beatLength) * beatLength;
+            float sample = 0;
+
+            if (time >= firstBeat && sincePulse < pulseWidth)
+            {
+                sample = 0.4f * (1.0f - (float) std::cos(juce::MathConstants<double>::twoPi * sincePulse / pulseWidth));
+            }
+
+            buffer.setSample(0, i, sample);
+        }
+
+        if (writer->writeFromAudioSampleBuffer(buffer, 0, blockLength) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// milliseconds from asking for a track to it being ready to play, including the read-ahead prefill
+juce::var EngineBenchmark::benchmarkLoad()
+{
+    juce::Array<juce::var> results;
+
+    for (auto& testCase : getFileCases())
+    {
+        auto player = createPlayer(testCase, DJAudioPlayer::defaultReadAheadSize);
+        juce::URL url(testCase.file);
+        double seconds = measure(numRuns, 4, [&] { player->loadURL(url); });
+
+        results.add(makeResult({ { "file", testCase.file.getFileName() },
+                                 { "memoryMapped", player->isMemoryMapped() },
+                                 { "seekIndexed", player->isSeekIndexed() },
+                                 { "ms", seconds * 1000.0 } }));
+    }
+
+    return results;
+}
+
+// milliseconds to jump to a random point of the track and render the first block from there
+juce::var EngineBenchmark::benchmarkSeek()
+{
+    juce::Array<juce::var> results;
+
+    for (auto& testCase : getFileCases())
+    {
+        auto player = createPlayer(testCase, 0);
+        player->loadURL(juce::URL(testCase.file));
+        player->start();
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::AudioSourceChannelInfo info(&buffer, 0, blockSize);
+        juce::Random random(2);
+
+        double seconds = measure(numRuns, 20, [&]
+        {
+            player->setPosition(random.nextDouble() * juce::jmax(0.0, player->getLength() - 1.0));
+            player->getNextAudioBlock(info);
+        });
+
+        results.add(makeResult({ { "file", testCase.file.getFileName() },
+                                 { "memoryMapped", player->isMemoryMapped() },
+                                 { "seekIndexed", player->isSeekIndexed() },
+                                 { "ms", seconds * 1000.0 } }));
+    }
+
+    return results;
+}
+
+// one deck's cost per block, reading straight from the file so that the read-ahead thread is not hiding any of it
+juce::var EngineBenchmark::benchmarkDeckRender()
+{
+    struct RenderCase
+    {
+        const char* name;
+        bool flac;
+        bool memoryMapped;
+        double speed;
+        int keylock;
+    };
+
+    const RenderCase cases[] = { { "wav mapped", false, true, 1.0, -1 },
+                                 { "wav streamed", false, false, 1.0, -1 },
+                                 { "flac", true, false, 1.0, -1 },
+                                 { "wav mapped +8%", false, true, 1.08, -1 },
+                                 { "wav mapped +8% keylock live", false, true, 1.08, (int) TimeStretcher::Mode::live },
+                                 { "wav mapped +8% keylock high quality", false, true, 1.08, (int) TimeStretcher::Mode::highQuality } };
+
+    juce::Array<juce::var> results;
+
+    for (auto& testCase : cases)
+    {
+        auto player = createPlayer({ testCase.flac ? flacFile : wavFile, testCase.memoryMapped, true }, 0);
+        player->loadURL(juce::URL(testCase.flac ? flacFile : wavFile));
+        player->setSpeed(testCase.speed);
+
+        if (testCase.keylock >= 0)
+        {
+            player->setKeylockMode((TimeStretcher::Mode) testCase.keylock);
+            player->setKeylock(true);
+        }
+
+        player->start();
+
+        double nsPerSample = measureSource(*player);
+        double blockSeconds = nsPerSample * blockSize / 1.0e9;
+
+        results.add(makeResult({ { "case", testCase.name },
+                                 { "usPerBlock", blockSeconds * 1.0e6 },
+                                 { "blockLoad", blockSeconds / getBlockTime() } }));
+    }
+
+    return results;
+}
+
+// two decks through the engine on the audio thread alone, both keylocked in high quality at speeds either side
+// of 1 with EQ and filter on, at 48 kHz in 128-sample blocks. every block is timed on its own, since the slowest
+// block rather than the average is what decides whether the callback keeps up, and it passes if that block
+// fits the buffer. decks read straight from the file, so decoding is counted too
+juce::var EngineBenchmark::benchmarkKeylockBudget()
+{
+    const double speeds[] = { 1.08, 0.94 };
+    const double filters[] = { 0.3, -0.3 };
+
+    DeckEngine engine(formatManager, 2);
+    engine.setNumDecks(2);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        auto* deck = engine.getDeck(i);
+        deck->setTrackCache(nullptr);
+        deck->setReadAheadSize(0);
+    }
+
+    engine.prepareToPlay(keylockBudgetBlockSize, keylockBudgetSampleRate);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        auto* deck = engine.getDeck(i);
+        deck->loadURL(juce::URL(i == 0 ? wavFile : flacFile));
+        deck->setSpeed(speeds[i]);
+        deck->setKeylockMode(TimeStretcher::Mode::highQuality);
+        deck->setKeylock(true);
+        deck->setEqGain(DeckEqualiser::Band::low, 1.5);
+        deck->setEqGain(DeckEqualiser::Band::mid, 0.7);
+        deck->setEqGain(DeckEqualiser::Band::high, 1.2);
+        deck->setFilter(filters[i]);
+        deck->start();
+    }
+
+    juce::AudioBuffer<float> output(DeckEngine::numDeckChannels, keylockBudgetBlockSize);
+    juce::AudioSourceChannelInfo info(&output, 0, keylockBudgetBlockSize);
+
+    for (int i = 0; i < numWarmUpBlocks; ++i)
+    {
+        engine.getNextAudioBlock(info);
+    }
+
+    int numBlocks = (int) (keylockBudgetLength * keylockBudgetSampleRate / keylockBudgetBlockSize);
+    double totalSeconds = 0;
+    double worstSeconds = 0;
+
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+        engine.getNextAudioBlock(info);
+        double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        totalSeconds += seconds;
+        worstSeconds = juce::jmax(worstSeconds, seconds);
+    }
+
+    engine.releaseResources();
+
+    double budgetSeconds = keylockBudgetBlockSize / keylockBudgetSampleRate;
+
+    return makeResult({ { "sampleRate", keylockBudgetSampleRate },
+                        { "blockSize", keylockBudgetBlockSize },
+                        { "decks", 2 },
+                        { "budgetUs", budgetSeconds * 1.0e6 },
+                        { "averageUs", totalSeconds / numBlocks * 1.0e6 },
+                        { "worstBlockUs", worstSeconds * 1.0e6 },
+                        { "worstBlockLoad", worstSeconds / budgetSeconds },
+                        { "passed", worstSeconds < budgetSeconds } });
+}
+
+// nanoseconds per output frame of each quality tier at speeds from half to double, and of the tone
+// generator that feeds it on its own
+juce::var EngineBenchmark::benchmarkResampler()
+{
+    const double ratios[] = { 0.5, 0.92, 1.0, 1.08, 1.5, 2.0 };
+    const char* qualityNames[] = { "low", "medium", "high" };
+
+    juce::ToneGeneratorAudioSource tone;
+    tone.setFrequency(440.0);
+    PolyphaseResampler resampler(&tone, false, 2);
+    resampler.prepareToPlay(blockSize, sampleRate);
+
+    juce::Array<juce::var> results;
+    tone.prepareToPlay(blockSize, sampleRate);
+    results.add(makeResult({ { "quality", "source only" }, { "ratio", 1.0 }, { "nsPerSample", measureSource(tone) } }));
+
+    for (int quality = 0; quality < 3; ++quality)
+    {
+        resampler.setQuality((PolyphaseResampler::Quality) quality);
+
+        for (double ratio : ratios)
+        {
+            resampler.setResamplingRatio(ratio);
+
+            results.add(makeResult({ { "quality", qualityNames[quality] },
+                                     { "ratio", ratio },
+                                     { "nsPerSample", measureSource(resampler) } }));
+        }
+    }
+
+    resampler.releaseResources();
+    return results;
+}
+
+// nanoseconds per output frame of each mode at tempos either side of 1, and the slowest block, which is where a
+// frame's search would land if it were not spread over the blocks before it
+juce::var EngineBenchmark::benchmarkStretcher()
+{
+    const double tempos[] = { 0.8, 0.92, 1.08, 1.25 };
+    const char* modeNames[] = { "live", "highQuality" };
+
+    juce::ToneGeneratorAudioSource tone;
+    tone.setFrequency(440.0);
+    TimeStretcher stretcher(&tone, false, 2);
+    stretcher.prepareToPlay(blockSize, sampleRate);
+    stretcher.setEnabled(true);
+
+    juce::Array<juce::var> results;
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        stretcher.setMode((TimeStretcher::Mode) mode);
+
+        for (double tempo : tempos)
+        {
+            stretcher.setTempo(tempo);
+
+            results.add(makeResult({ { "mode", modeNames[mode] },
+                                     { "tempo", tempo },
+                                     { "nsPerSample", measureSource(stretcher) },
+                                     { "worstBlockUs", measureWorstBlock(stretcher) } }));
+        }
+    }
+
+    stretcher.releaseResources();
+    return results;
+}
+
+// the EQ's own cost with the tone generator feeding it taken away, in nanoseconds and estimated cycles
+juce::var EngineBenchmark::benchmarkEqualiser()
+{
+    juce::ToneGeneratorAudioSource tone;
+    tone.setFrequency(440.0);
+    tone.prepareToPlay(blockSize, sampleRate);
+    double sourceNs = measureSource(tone);
+
+    DeckEqualiser equaliser(&tone, false);
+    equaliser.prepareToPlay(blockSize, sampleRate);
+
+    juce::Array<juce::var> results;
+    double cpuGHz = juce::SystemStats::getCpuSpeedInMegahertz() / 1000.0;
+
+    for (int setting = 0; setting < 3; ++setting)
+    {
+        // flat, then the low band killed, then the low-pass filter swept halfway down as well
+        equaliser.setBandGain(DeckEqualiser::Band::low, setting == 0 ? 1.0f : 0.0f);
+        equaliser.setFilter(setting == 2 ? -0.5f : 0.0f);
+
+        double nsPerSample = juce::jmax(0.0, measureSource(equaliser) - sourceNs);
+
+        results.add(makeResult({ { "setting", setting == 0 ? "flat" : (setting == 1 ? "low kill" : "low kill and filter") },
+                                 { "nsPerSample", nsPerSample },
+                                 { "cyclesPerSample", nsPerSample * cpuGHz } }));
+    }
+
+    equaliser.releaseResources();
+    return results;
+}
+
+// microseconds per block to mix 2, 4 and 8 inputs, through MixerStage and through juce::MixerAudioSource,
+// with the same copy of each input into place on both sides
+juce::var EngineBenchmark::benchmarkMixer()
+{
+    juce::AudioBuffer<float> block(DeckEngine::numDeckChannels, blockSize);
+    juce::Random random(3);
+
+    for (int channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            block.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+        }
+    }
+
+    juce::AudioBuffer<float> output(DeckEngine::numDeckChannels, blockSize);
+    juce::AudioSourceChannelInfo info(&output, 0, blockSize);
+    juce::Array<juce::var> results;
+
+    for (int numInputs : { 2, 4, 8 })
+    {
+        MixerStage mixer(numInputs);
+        mixer.prepareToPlay(blockSize, sampleRate);
+        std::vector<juce::AudioBuffer<float>> inputs((size_t) numInputs, juce::AudioBuffer<float>(DeckEngine::numDeckChannels, blockSize));
+
+        double mixerStageSeconds = measure(numRuns, numMeasuredBlocks * 10, [&]
+        {
+            for (auto& input : inputs)
+            {
+                for (int channel = 0; channel < input.getNumChannels(); ++channel)
+                {
+                    input.copyFrom(channel, 0, block, channel, 0, blockSize);
+                }
+            }
+
+            mixer.process(inputs.data(), numInputs, info);
+        });
+
+        juce::OwnedArray<BlockSource> sources;
+        juce::MixerAudioSource mixerSource;
+
+        for (int i = 0; i < numInputs; ++i)
+        {
+            mixerSource.addInputSource(sources.add(new BlockSource(block)), false);
+        }
+
+        mixerSource.prepareToPlay(blockSize, sampleRate);
+
+        double mixerSourceSeconds = measure(numRuns, numMeasuredBlocks * 10, [&] { mixerSource.getNextAudioBlock(info); });
+
+        mixerSource.removeAllInputs();
+
+        results.add(makeResult({ { "inputs", numInputs },
+                                 { "mixerStageUs", mixerStageSeconds * 1.0e6 },
+                                 { "mixerAudioSourceUs", mixerSourceSeconds * 1.0e6 } }));
+    }
+
+    return results;
+}
+
+// the whole engine with every deck playing at +3%, rendered on the audio thread alone for 1 to 8 decks and
+// then on every core, giving how many decks fit in one core's share of each block
+juce::var EngineBenchmark::benchmarkDecksPerCore()
+{
+    DeckEngine engine(formatManager, DeckEngine::defaultMaxDecks);
+
+    for (int i = 0; i < engine.getMaxDecks(); ++i)
+    {
+        auto* deck = engine.getDeck(i);
+        deck->setTrackCache(nullptr);
+        deck->setReadAheadSize(0);
+    }
+
+    engine.prepareToPlay(blockSize, sampleRate);
+
+    for (int i = 0; i < engine.getMaxDecks(); ++i)
+    {
+        auto* deck = engine.getDeck(i);
+        deck->loadURL(juce::URL(wavFile));
+        deck->setSpeed(1.03);
+        deck->start();
+    }
+
+    juce::AudioBuffer<float> output(DeckEngine::numDeckChannels, blockSize);
+    juce::AudioSourceChannelInfo info(&output, 0, blockSize);
+
+    auto measureDecks = [&](int numDecks)
+    {
+        engine.setNumDecks(numDecks);
+
+        // start each run from the top, so that no deck reaches the end of the track while being measured
+        for (int i = 0; i < numDecks; ++i)
+        {
+            engine.getDeck(i)->setPosition(0);
+        }
+
+        for (int i = 0; i < numWarmUpBlocks; ++i)
+        {
+            engine.getNextAudioBlock(info);
+        }
+
+        return measure(numRuns, numMeasuredBlocks / 2, [&] { engine.getNextAudioBlock(info); });
+    };
+
+    juce::Array<juce::var> serial;
+    double eightDeckSeconds = 0;
+
+    for (int numDecks = 1; numDecks <= engine.getMaxDecks(); ++numDecks)
+    {
+        double seconds = measureDecks(numDecks);
+        eightDeckSeconds = seconds;
+        serial.add(makeResult({ { "decks", numDecks }, { "usPerBlock", seconds * 1.0e6 }, { "blockLoad", seconds / getBlockTime() } }));
+    }
+
+    juce::Array<juce::var> parallel;
+    int numWorkers = juce::SystemStats::getNumCpus() - 1;
+
+    if (numWorkers > 0)
+    {
+        engine.setRenderThreads(numWorkers);
+
+        for (int numDecks : { 2, 4, 8 })
+        {
+            double seconds = measureDecks(numDecks);
+            parallel.add(makeResult({ { "decks", numDecks }, { "renderThreads", numWorkers }, { "usPerBlock", seconds * 1.0e6 },
+                                      { "blockLoad", seconds / getBlockTime() } }));
+        }
+    }
+
+    engine.releaseResources();
+
+    double secondsPerDeck = eightDeckSeconds / engine.getMaxDecks();
+
+    return makeResult({ { "serial", serial },
+                        { "parallel", parallel },
+                        { "decksPerCore", secondsPerDeck > 0 ? getBlockTime() / secondsPerDeck : 0.0 } });
+}
+
+// a follower deck with a click every beat at one tempo synced to a leader with clicks at another, started
+// off the beat, then the time between each of its clicks and the leader's nearest one measured in what the
+// two decks actually rendered, which after locking on should stay well under a millisecond
+juce::var EngineBenchmark::benchmarkSync()
+{
+    const double leaderBpm = 124.0;
+    const double followerBpm = 127.0;
+    const double leaderFirstBeat = 0.5;
+    const double followerFirstBeat = 0.8;
+    const double followerStart = 10.3;
+    double renderLength = syncSettleTime + syncTestLength;
+
+    juce::File leaderFile = testDirectory.getChildFile("sync leader.flac");
+    juce::File followerFile = testDirectory.getChildFile("sync follower.flac");
+
+    if (writeClickTrack(leaderFile, leaderBpm, leaderFirstBeat, renderLength + 10.0) == false
+        || writeClickTrack(followerFile, followerBpm, followerFirstBeat, followerStart + renderLength + 10.0) == false)
+    {
+        return makeResult({ { "error", "cannot write click tracks" } });
+    }
+
+    DeckEngine engine(formatManager, 2);
+
+    for (int i = 0; i < engine.getMaxDecks(); ++i)
+    {
+        engine.getDeck(i)->setTrackCache(nullptr);
+        engine.getDeck(i)->setReadAheadSize(0);
+    }
+
+    engine.prepareToPlay(blockSize, sampleRate);
+
+    auto* leader = engine.getDeck(0);
+    auto* follower = engine.getDeck(1);
+
+    if (leader->loadURL(juce::URL(leaderFile)) == false || follower->loadURL(juce::URL(followerFile)) == false)
+    {
+        return makeResult({ { "error", "cannot load click tracks" } });
+    }
+
+    leader->setBeatGrid(leaderBpm, leaderFirstBeat);
+    follower->setBeatGrid(followerBpm, followerFirstBeat);
+    follower->setPosition(followerStart);
+    follower->setSyncEnabled(true);
+    leader->start();
+    follower->start();
+
+    juce::AudioBuffer<float> output(DeckEngine::numDeckChannels, blockSize);
+    juce::AudioSourceChannelInfo info(&output, 0, blockSize);
+    OnsetDetector leaderOnsets(sampleRate);
+    OnsetDetector followerOnsets(sampleRate);
+    juce::int64 numBlocks = (juce::int64) (renderLength * sampleRate / blockSize);
+    juce::int64 settleBlocks = (juce::int64) (syncSettleTime * sampleRate / blockSize);
+    double clockMaxError = 0;
+
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+    for (juce::int64 block = 0; block < numBlocks; ++block)
+    {
+        engine.getNextAudioBlock(info);
+        leaderOnsets.process(engine.getDeckOutput(0).getReadPointer(0), blockSize);
+        followerOnsets.process(engine.getDeckOutput(1).getReadPointer(0), blockSize);
+
+        if (block >= settleBlocks)
+        {
+            clockMaxError = juce::jmax(clockMaxError, std::abs(follower->getSyncPhaseError()));
+        }
+    }
+
+    double elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    engine.releaseResources();
+
+    // pair every click of the follower with the leader's nearest one
+    std::vector<double>& leaderTimes = leaderOnsets.onsets;
+    size_t nearest = 0;
+    double maxError = 0;
+    double sumSquares = 0;
+    double lockedAfter = 0;
+    int numBeats = 0;
+
+    for (double time : followerOnsets.onsets)
+    {
+        while (nearest + 1 < leaderTimes.size() && std::abs(leaderTimes[nearest + 1] - time) < std::abs(leaderTimes[nearest] - time))
+        {
+            nearest++;
+        }
+
+        if (leaderTimes.empty())
+        {
+            break;
+        }
+
+        double error = (time - leaderTimes[nearest]) * 1000.0;
+
+        if (std::abs(error) >= 1.0)
+        {
+            lockedAfter = time;
+        }
+
+        if (time >= syncSettleTime)
+        {
+            maxError = juce::jmax(maxError, std::abs(error));
+            sumSquares += error * error;
+            numBeats++;
+        }
+    }
+
+    return makeResult({ { "leaderBpm", leaderBpm },
+                        { "followerBpm", followerBpm },
+                        { "seconds", syncTestLength },
+                        { "beats", numBeats },
+                        { "maxErrorMs", maxError },
+                        { "rmsErrorMs", numBeats > 0 ? std::sqrt(sumSquares / numBeats) : 0.0 },
+                        { "clockMaxErrorMs", clockMaxError * 60.0 / leaderBpm * 1000.0 },
+                        { "lockedAfterSeconds", lockedAfter },
+                        { "heldUnder1ms", numBeats > 0 && maxError < maxSyncErrorMs },
+                        { "realtimeFactor", elapsedSeconds > 0 ? renderLength / elapsedSeconds : 0.0 } });
+}
+
+// a deck playing through its read-ahead buffer jumps to random hot cues, with each cue's window decoded and
+// without, giving the milliseconds from the trigger to the first block of its audio and how many blocks
+// came out silent before it, rendering at the pace of a device so the read-ahead thread has its usual time
+juce::var EngineBenchmark::benchmarkHotCues()
+{
+    const int numTriggers = 16;
+    const int blocksBetweenTriggers = 10;
+    const int maxSilentBlocks = 100;
+    int blockMs = juce::jmax(1, (int) std::ceil(getBlockTime() * 1000.0));
+
+    juce::Array<juce::var> results;
+
+    for (auto& testCase : getFileCases())
+    {
+        for (bool buffered : { true, false })
+        {
+            auto player = createPlayer(testCase, DJAudioPlayer::defaultReadAheadSize);
+            player->setHotCueBuffersEnabled(buffered);
+            player->loadURL(juce::URL(testCase.file));
+
+            for (int i = 0; i < DJAudioPlayer::numHotCues; ++i)
+            {
+                player->setHotCue(i, player->getLength() * (i + 1) / (DJAudioPlayer::numHotCues + 1));
+            }
+
+            // give the loader time to decode every window
+            for (int wait = 0; buffered && wait < 200; ++wait)
+            {
+                bool allReady = true;
+
+                for (int i = 0; i < DJAudioPlayer::numHotCues; ++i)
+                {
+                    allReady = allReady && player->isHotCueReady(i);
+                }
+
+                if (allReady)
+                {
+                    break;
+                }
+
+                juce::Thread::sleep(10);
+            }
+
+            player->start();
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::AudioSourceChannelInfo info(&buffer, 0, blockSize);
+            juce::Random random(3);
+            double totalLatency = 0;
+            double maxLatency = 0;
+            int totalSilentBlocks = 0;
+            int numBuffered = 0;
+
+            for (int trigger = 0; trigger < numTriggers; ++trigger)
+            {
+                player->triggerHotCue(random.nextInt(DJAudioPlayer::numHotCues));
+
+                int silentBlocks = 0;
+
+                for (; silentBlocks < maxSilentBlocks; ++silentBlocks)
+                {
+                    player->getNextAudioBlock(info);
+                    juce::Thread::sleep(blockMs);
+
+                    if (buffer.getMagnitude(0, blockSize) > 0.0f)
+                    {
+                        break;
+                    }
+                }
+
+                totalSilentBlocks += silentBlocks;
+                totalLatency += player->getLastHotCueLatency();
+                maxLatency = juce::jmax(maxLatency, player->getLastHotCueLatency());
+                numBuffered += player->wasLastHotCueBuffered() ? 1 : 0;
+
+                for (int i = 0; i < blocksBetweenTriggers; ++i)
+                {
+                    player->getNextAudioBlock(info);
+                    juce::Thread::sleep(blockMs);
+                }
+            }
+
+            results.add(makeResult({ { "file", testCase.file.getFileName() },
+                                     { "memoryMapped", player->isMemoryMapped() },
+                                     { "seekIndexed", player->isSeekIndexed() },
+                                     { "cueBuffers", buffered },
+                                     { "triggersBuffered", numBuffered },
+                                     { "averageMs", totalLatency / numTriggers },
+                                     { "maxMs", maxLatency },
+                                     { "silentBlocksPerTrigger", (double) totalSilentBlocks / numTriggers } }));
+        }
+    }
+
+    return results;
+}
+
+// the master recorder fed faster than real time while it writes WAV and FLAC, giving the audio thread's
+// cost per block, how full the ring got and whether anything was dropped
+juce::var EngineBenchmark::benchmarkRecorder()
+{
+    juce::Array<juce::var> results;
+
+    juce::AudioBuffer<float> block(MasterRecorder::numChannels, blockSize);
+    juce::Random random(4);
+
+    for (int i = 0; i < blockSize; ++i)
+    {
+        for (int channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            block.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+        }
+    }
+
+    juce::AudioSourceChannelInfo info(&block, 0, blockSize);
+    int numBlocks = (int) (recorderTestLength * sampleRate / blockSize);
+    double blockInterval = getBlockTime() / recorderPace;
+
+    for (const char* extension : { ".wav", ".flac" })
+    {
+        juce::File file = testDirectory.getChildFile(juce::String("recording") + extension);
+        MasterRecorder recorder(formatManager);
+        recorder.prepareToPlay(blockSize, sampleRate);
+        juce::String error;
+
+        if (recorder.start(file, error) == false)
+        {
+            results.add(makeResult({ { "format", extension }, { "error", error } }));
+            continue;
+        }
+
+        juce::int64 pushTicks = 0;
+        double startTime = juce::Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+            recorder.pushBlock(info);
+            pushTicks += juce::Time::getHighResolutionTicks() - startTicks;
+
+            // keep to the pace of a device running recorderPace times faster than real time
+            double due = startTime + (i + 1) * blockInterval * 1000.0;
+            double now = juce::Time::getMillisecondCounterHiRes();
+
+            if (due > now)
+            {
+                juce::Thread::sleep((int) (due - now));
+            }
+        }
+
+        recorder.stop();
+
+        results.add(makeResult({ { "format", extension },
+                                 { "seconds", recorder.getRecordedSeconds() },
+                                 { "pace", recorderPace },
+                                 { "usPerBlock", juce::Time::highResolutionTicksToSeconds(pushTicks) / numBlocks * 1.0e6 },
+                                 { "highWaterMark", recorder.getHighWaterMark() },
+                                 { "fifoCapacity", recorder.getFifoCapacity() },
+                                 { "droppedSamples", recorder.getDroppedSamples() },
+                                 { "writeFailed", recorder.hasWriteFailed() },
+                                 { "fileMB", file.getSize() / (1024.0 * 1024.0) } }));
+    }
+
+    return results;
+}
+
+// how many times faster than real time a track's waveform pyramid is built, with its band analysis and without,
+// its size, and the milliseconds to draw it coloured by band across the whole track, a minute and a few seconds
+juce::var EngineBenchmark::benchmarkWaveform()
+{
+    juce::Array<juce::var> results;
+    juce::Array<juce::File> files{ wavFile, flacFile };
+    files.addArray(extraTracks);
+
+    for (auto& file : files)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+        if (reader == nullptr)
+        {
+            results.add(makeResult({ { "file", file.getFileName() }, { "error", "cannot read the file" } }));
+            continue;
+        }
+
+        WaveformPyramid pyramid;
+        double peaksSeconds = measure(numRuns, 1, [&] { pyramid.build(*reader, nullptr, false); });
+        double buildSeconds = measure(numRuns, 1, [&] { pyramid.build(*reader); });
+        double trackSeconds = reader->lengthInSamples / reader->sampleRate;
+
+        juce::Image image(juce::Image::RGB, waveformWidth, waveformHeight, true);
+        juce::Graphics g(image);
+        juce::Array<juce::var> draws;
+
+        for (double seconds : { trackSeconds, 60.0, 4.0 })
+        {
+            auto length = juce::jmin(pyramid.getLengthInSamples(), (juce::int64) (seconds * reader->sampleRate));
+            double drawSeconds = measure(numRuns, 10, [&]
+            {
+                pyramid.draw(g, image.getBounds(), 0, length, juce::Colours::grey, juce::Colours::white, true);
+            });
+
+            draws.add(makeResult({ { "seconds", length / reader->sampleRate }, { "ms", drawSeconds * 1000.0 } }));
+        }
+
+        results.add(makeResult({ { "file", file.getFileName() },
+                                 { "buildRealtimeFactor", trackSeconds / buildSeconds },
+                                 { "peaksOnlyRealtimeFactor", trackSeconds / peaksSeconds },
+                                 { "bandAnalysisRealtimeFactor", trackSeconds / juce::jmax(1.0e-9, buildSeconds - peaksSeconds) },
+                                 { "levels", pyramid.getNumLevels() },
+                                 { "bytes", (juce::int64) pyramid.getSizeInBytes() },
+                                 { "draw", draws } }));
+    }
+
+    return results;
+}
+
+// milliseconds to get a track's waveform by decoding it against reading it back from the cache, then the cost of
+// opening a cache holding a whole library's waveforms, finding one among them and evicting half of them
+juce::var EngineBenchmark::benchmarkWaveformCache()
+{
+    juce::Array<juce::var> tracks;
+    juce::File directory = testDirectory.getChildFile("waveforms");
+    juce::Array<juce::File> files{ wavFile, flacFile };
+    files.addArray(extraTracks);
+
+    for (auto& file : files)
+    {
+        WaveformCache cache(WaveformCache::defaultSizeLimit, directory);
+        WaveformPyramid pyramid;
+
+        double decodeSeconds = measure(numRuns, 1, [&]
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+            if (reader != nullptr)
+            {
+                pyramid.build(*reader);
+            }
+        });
+
+        cache.store(file, pyramid);
+        double loadSeconds = measure(numRuns, 4, [&] { cache.load(file); });
+
+        tracks.add(makeResult({ { "file", file.getFileName() },
+                                { "decodeMs", decodeSeconds * 1000.0 },
+                                { "cachedMs", loadSeconds * 1000.0 },
+                                { "hits", cache.getHitCount() } }));
+    }
+
+    // fill the cache with copies of a short track's entry under other names, which is all that listing
+    // and evicting look at
+    directory.deleteRecursively();
+    juce::File libraryTrack;
+
+    {
+        WaveformCache cache(WaveformCache::defaultSizeLimit, directory);
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(wavFile));
+
+        if (reader == nullptr)
+        {
+            return makeResult({ { "tracks", tracks }, { "error", "cannot read " + wavFile.getFileName() } });
+        }
+
+        juce::AudioSubsectionReader shortReader(reader.get(), 0, (juce::int64) (2.0 * reader->sampleRate), false);
+        WaveformPyramid pyramid;
+        pyramid.build(shortReader);
+        cache.store(wavFile, pyramid);
+        libraryTrack = directory.findChildFiles(juce::File::findFiles, false, "*.wave").getFirst();
+    }
+
+    for (int i = 1; i < waveformLibrarySize; ++i)
+    {
+        libraryTrack.copyFileTo(directory.getChildFile(juce::String::toHexString((juce::int64) i) + ".wave"));
+    }
+
+    WaveformCache library(WaveformCache::defaultSizeLimit, directory);
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    int numEntries = library.getNumEntries();
+    double scanSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    double loadSeconds = measure(numRuns, 4, [&] { library.load(wavFile); });
+    juce::int64 libraryBytes = library.getCachedBytes();
+
+    startTicks = juce::Time::getHighResolutionTicks();
+    library.setSizeLimit(libraryBytes / 2);
+    double evictSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    auto result = makeResult({ { "tracks", tracks },
+                               { "library", makeResult({ { "entries", numEntries },
+                                                         { "MB", libraryBytes / (1024.0 * 1024.0) },
+                                                         { "firstListMs", scanSeconds * 1000.0 },
+                                                         { "cachedMs", loadSeconds * 1000.0 },
+                                                         { "evictHalfMs", evictSeconds * 1000.0 },
+                                                         { "entriesAfterEvict", library.getNumEntries() } }) } });
+
+    directory.deleteRecursively();
+
+    return result;
+}
+
+// milliseconds for one frame of the overview as the playhead moves a pixel, drawing the whole waveform again
+// against copying the strips the marker leaves and enters from the cached image, both through the renderer
+// WaveformDisplay paints with
+juce::var EngineBenchmark::benchmarkWaveformFrame()
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(wavFile));
+    auto pyramid = std::make_shared<WaveformPyramid>();
+
+    if (reader == nullptr || pyramid->build(*reader) == false)
+    {
+        return makeResult({ { "error", "cannot read " + wavFile.getFileName() } });
+    }
+
+    // a marker the size of the app's, which is scaled down into the marker's strip in the same way
+    juce::Image markerImage(juce::Image::ARGB, 1080, 1080, true);
+    juce::Graphics(markerImage).fillRect(markerImage.getBounds().withSizeKeepingCentre(360, 1080));
+
+    WaveformOverviewRenderer overview;
+    overview.setPyramid(pyramid);
+    overview.setMarkerImage(markerImage);
+
+    juce::Image screen(juce::Image::RGB, waveformWidth, waveformHeight, true);
+    juce::Rectangle<int> bounds = screen.getBounds();
+    juce::Graphics g(screen);
+    int x = 0;
+
+    double fullSeconds = measure(numRuns, 20, [&]
+    {
+        x = (x + 1) % waveformWidth;
+        overview.invalidate();
+        overview.draw(g, bounds, 1.0f, (double) x / waveformWidth);
+    });
+
+    double layeredSeconds = measure(numRuns, 200, [&]
+    {
+        double oldPosition = (double) x / waveformWidth;
+        x = (x + 1) % waveformWidth;
+        double newPosition = (double) x / waveformWidth;
+
+        for (auto strip : { overview.getMarkerArea(bounds, oldPosition), overview.getMarkerArea(bounds, newPosition) })
+        {
+            juce::Graphics::ScopedSaveState state(g);
+            g.reduceClipRegion(strip);
+            overview.draw(g, bounds, 1.0f, newPosition);
+        }
+    });
+
+    return makeResult({ { "width", waveformWidth },
+                        { "height", waveformHeight },
+                        { "fullRedrawMs", fullSeconds * 1000.0 },
+                        { "layeredMs", layeredSeconds * 1000.0 },
+                        { "speedup", fullSeconds / layeredSeconds } });
+}
+
+// the share of one core that two decks' zoomed views take scrolling at the display's refresh rate while playing,
+// rendering each frame and painting it to the screen, against drawing every frame whole
+juce::var EngineBenchmark::benchmarkScrollingWaveform()
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(wavFile));
+    auto pyramid = std::make_shared<WaveformPyramid>();
+
+    if (reader == nullptr || pyramid->build(*reader) == false)
+    {
+        return makeResult({ { "error", "cannot read " + wavFile.getFileName() } });
+    }
+
+    juce::Array<juce::var> results;
+    int numFrames = (int) (scrollTestLength * scrollRefreshRate);
+    int deckWidth = waveformWidth / 2;
+
+    for (bool incremental : { true, false })
+    {
+        juce::OwnedArray<ScrollingWaveformRenderer> views;
+        juce::Image screen(juce::Image::RGB, deckWidth, waveformHeight, true);
+        juce::Graphics g(screen);
+
+        for (int deck = 0; deck < 2; ++deck)
+        {
+            auto* view = views.add(new ScrollingWaveformRenderer());
+            view->setPyramid(pyramid);
+            view->setBeatGrid(124.0, 0.1);
+        }
+
+        juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            for (int deck = 0; deck < views.size(); ++deck)
+            {
+                // the second deck plays a little faster, as it would when matched to the first
+                double position = 1.0 + frame / scrollRefreshRate * (deck == 0 ? 1.0 : 1.03);
+
+                // handing over the same grid again throws the image away, as every frame did before
+                if (incremental == false)
+                {
+                    views[deck]->setBeatGrid(124.0, 0.1);
+                }
+
+                views[deck]->renderFrame(position, deckWidth, waveformHeight, 1.0f);
+                views[deck]->draw(g, screen.getBounds());
+            }
+        }
+
+        double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+        results.add(makeResult({ { "incremental", incremental },
+                                 { "width", deckWidth },
+                                 { "refreshRate", scrollRefreshRate },
+                                 { "msPerDeckFrame", seconds / (numFrames * views.size()) * 1000.0 },
+                                 { "columnsPerFrame", (double) views[0]->getNumColumnsDrawn() / numFrames },
+                                 { "twoDeckCorePercent", seconds / scrollTestLength * 100.0 } }));
+    }
+
+    return results;
+}
+
+double EngineBenchmark::measure(int numRunsToTake, int numIterations, const std::function<void()>& body)
+{
+    std::vector<double> runs;
+
+    for (int run = 0; run < numRunsToTake; ++run)
+    {
+        juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numIterations; ++i)
+        {
+            body();
+        }
+
+        runs.push_back(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) / numIterations);
+    }
+
+    std::sort(runs.begin(), runs.end());
+    return runs[runs.size() / 2];
+}
+
+double EngineBenchmark::measureSource(juce::AudioSource& source)
+{
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::AudioSourceChannelInfo info(&buffer, 0, blockSize);
+
+    // let parameter ramps settle before timing
+    for (int i = 0; i < numWarmUpBlocks; ++i)
+    {
+        source.getNextAudioBlock(info);
+    }
+
+    return measure(numRuns, numMeasuredBlocks, [&] { source.getNextAudioBlock(info); }) * 1.0e9 / blockSize;
+}
+
+double EngineBenchmark::measureWorstBlock(juce::AudioSource& source)
+{
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::AudioSourceChannelInfo info(&buffer, 0, blockSize);
+    double worstSeconds = 0;
+
+    for (int i = 0; i < numWarmUpBlocks; ++i)
+    {
+        source.getNextAudioBlock(info);
+    }
+
+    // time every block on its own, as an average would hide one block that overruns the callback
+    for (int i = 0; i < numRuns * numMeasuredBlocks; ++i)
+    {
+        juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+        source.getNextAudioBlock(info);
+        double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        worstSeconds = juce::jmax(worstSeconds, seconds);
+    }
+
+    return worstSeconds * 1.0e6;
+}
+
+// the generated files mapped and streamed, and each added track read with and without its seek index
+std::vector<EngineBenchmark::FileCase> EngineBenchmark::getFileCases()
+{
+    std::vector<FileCase> cases = { { wavFile, true, true }, { wavFile, false, true }, { flacFile, false, true } };
+
+    for (auto& track : extraTracks)
+    {
+        cases.push_back({ track, true, false });
+        cases.push_back({ track, true, true });
+    }
+
+    return cases;
+}
+
+std::unique_ptr<DJAudioPlayer> EngineBenchmark::createPlayer(const FileCase& fileCase, int readAheadSize)
+{
+    auto player = std::make_unique<DJAudioPlayer>(formatManager, readAheadThread);
+    player->setMemoryMappingEnabled(fileCase.memoryMapped);
+    player->setSeekIndexEnabled(fileCase.seekIndex);
+    player->setReadAheadSize(readAheadSize);
+    player->prepareToPlay(blockSize, sampleRate);
+
+    return player;
+}
+
+double EngineBenchmark::getBlockTime()
+{
+    return blockSize / sampleRate;
+}
\ No newline at end of file
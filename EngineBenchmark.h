@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.h
+    Created: 17 Oct 2026 8:41:09pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DeckEngine.h"
+#include "MasterRecorder.h"
+#include "WaveformCache.h"
+#include "WaveformOverviewRenderer.h"
+#include "ScrollingWaveformRenderer.h"
+
+// micro-benchmarks of the audio engine on generated test signals, run headless and reported as JSON so that
+// results can be compared between builds, covering loading, seeking, each deck's block render, the resampler
+// and time-stretcher at several ratios, the EQ, the mixer against juce::MixerAudioSource, decks per core,
+// how closely a synced deck holds the beat of its leader, how soon a hot cue is heard, how far the
+// master recorder's ring fills, how fast waveforms and their band colours are built and drawn, what the
+// waveform cache saves on loading a track and costs at startup with a large library, a waveform frame
+// redrawn whole against one composited from a cached image, and the share of a core two decks' scrolling
+// waveforms take
+class EngineBenchmark
+{
+public:
+    EngineBenchmark(double _sampleRate, int _blockSize);
+    ~EngineBenchmark();
+
+    // also load and seek in a real track, such as an MP3 which cannot be generated here, with and without its seek index
+    void addTrack(const juce::File& track);
+
+    // write the test files and run every benchmark, returns false with a message if the files could not be written
+    bool run(juce::var& results, juce::String& error);
+
+    // run only the benchmarks whose results are checked, for a quick pass in CI
+    void setChecksOnly(bool shouldOnlyCheck);
+
+    // the checks from the last run that failed, each as a line saying what was measured against what it should
+    // be. these hold on any machine, unlike timings, currently the synced deck's phase staying under 1 ms
+    const juce::StringArray& getFailedChecks();
+
+    // seconds of generated audio in each test file
+    static constexpr double testFileLength = 30.0;
+
+    // the sync test measures the beat phase for this long, after giving the follower time to lock on
+    static constexpr double syncTestLength = 600.0;
+    static constexpr double syncSettleTime = 30.0;
+    static constexpr double maxSyncErrorMs = 1.0;
+
+    // the keylock budget test renders two keylocked decks with EQ and filter this long at this rate and block
+    // size on one core, whatever the rate and block size of the rest of the run
+    static constexpr double keylockBudgetLength = 20.0;
+    static constexpr double keylockBudgetSampleRate = 48000.0;
+    static constexpr int keylockBudgetBlockSize = 128;
+
+    // the recorder test pushes this much audio, at recorderPace times real time
+    static constexpr double recorderTestLength = 60.0;
+    static constexpr double recorderPace = 8.0;
+
+    // the waveform test draws into an image this size, about a 4K screen's width
+    static constexpr int waveformWidth = 3840;
+    static constexpr int waveformHeight = 120;
+
+    // entries in the waveform cache for the library test
+    static constexpr int waveformLibrarySize = 10000;
+
+    // the scrolling test runs each deck's view for this long at this refresh rate, half the waveform image wide
+    static constexpr double scrollTestLength = 10.0;
+    static constexpr double scrollRefreshRate = 60.0;
+
+private:
+    struct FileCase
+    {
+        juce::File file;
+        bool memoryMapped;
+        bool seekIndex;
+    };
+
+    bool createTestFiles();
+    std::vector<FileCase> getFileCases();
+    bool writeTestFile(const juce::File& file);
+    bool writeClickTrack(const juce::File& file, double bpm, double firstBeat, double length);
+
+    juce::var benchmarkLoad();
+    juce::var benchmarkSeek();
+    juce::var benchmarkDeckRender();
+    juce::var benchmarkKeylockBudget();
+    juce::var benchmarkResampler();
+    juce::var benchmarkStretcher();
+    juce::var benchmarkEqualiser();
+    juce::var benchmarkMixer();
+    juce::var benchmarkDecksPerCore();
+    juce::var benchmarkSync();
+    juce::var benchmarkHotCues();
+    juce::var benchmarkRecorder();
+    juce::var benchmarkWaveform();
+    juce::var benchmarkWaveformCache();
+    juce::var benchmarkWaveformFrame();
+    juce::var benchmarkScrollingWaveform();
+
+    // median over numRuns of the average seconds that one call to body takes across numIterations calls
+    double measure(int numRuns, int numIterations, const std::function<void()>& body);
+
+    // nanoseconds per output sample frame of a source rendering whole blocks
+    double measureSource(juce::AudioSource& source);
+
+    // microseconds that the slowest single block of a source takes, for sources whose cost varies from block to block
+    double measureWorstBlock(juce::AudioSource& source);
+
+    std::unique_ptr<DJAudioPlayer> createPlayer(const FileCase& fileCase, int readAheadSize);
+    double getBlockTime();
+
+    juce::AudioFormatManager formatManager;
+    juce::TimeSliceThread readAheadThread{ "Benchmark read-ahead" };
+    double sampleRate;
+    int blockSize;
+
+    juce::File testDirectory;
+    juce::File wavFile;
+    juce::File flacFile;
+    juce::Array<juce::File> extraTracks;
+    bool checksOnly = false;
+    juce::StringArray failedChecks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EngineBenchmark)
+};
\ No newline at end of file
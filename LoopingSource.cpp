@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+    LoopingSource.cpp
+    Created: 17 Oct 2026 3:12:40pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "LoopingSource.h"
+
+LoopingSource::LoopingSource(juce::PositionableAudioSource* _input, const LoopState& _state, int _trackId, double _sampleRate) :
+                             input(_input),
+                             state(_state),
+                             trackId(_trackId),
+                             fadeLength(juce::jmax(1, juce::roundToInt(_sampleRate * fadeTime)))
+{
+    jassert(input != nullptr);
+}
+
+LoopingSource::~LoopingSource()
+{
+
+}
+
+void LoopingSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void LoopingSource::releaseResources()
+{
+    input->releaseResources();
+}
+
+void LoopingSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto& buffer = *bufferToFill.buffer;
+    juce::int64 pos = position;
+    int offset = 0;
+
+    // split the block at every loop-out point, so a loop shorter than the block wraps as often as it needs to
+    while (offset < bufferToFill.numSamples)
+    {
+        int numThisTime = bufferToFill.numSamples - offset;
+        bool wraps = false;
+
+        if (isLoopActive(pos) && state.end - pos <= numThisTime)
+        {
+            numThisTime = (int) (state.end - pos);
+            wraps = true;
+        }
+
+        read(pos, buffer, bufferToFill.startSample + offset, numThisTime);
+
+        if (isLoopActive(pos))
+        {
+            crossfade(pos, buffer, bufferToFill.startSample + offset, numThisTime);
+        }
+
+        pos += numThisTime;
+        offset += numThisTime;
+
+        if (wraps)
+        {
+            pos = state.start;
+            wrapped();
+        }
+    }
+
+    position = pos;
+}
+
+// when a seam covers the new position playback starts from it straight away, and the input is pointed at
+// where the seam ends, so that the read-ahead buffer only has to catch up by the time the seam runs out
+void LoopingSource::setNextReadPosition(juce::int64 newPosition)
+{
+    const LoopSeam* seam = findSeam(newPosition);
+    juce::int64 newInputPosition = seam != nullptr ? seam->start + seam->numSamples : newPosition;
+
+    position = newPosition;
+    inputPosition = newInputPosition;
+    input->setNextReadPosition(newInputPosition);
+}
+
+juce::int64 LoopingSource::getNextReadPosition() const
+{
+    return position;
+}
+
+juce::int64 LoopingSource::getTotalLength() const
+{
+    return input->getTotalLength();
+}
+
+// only report looping while the playhead is inside the loop, so that the transport source still stops
+// at the end of the track when playback was moved past loop-out
+bool LoopingSource::isLooping() const
+{
+    return isLoopActive(position);
+}
+
+int LoopingSource::getTrackId()
+{
+    return trackId;
+}
+
+bool LoopingSource::isPlayingFromSeam() const
+{
+    return findSeam(position) != nullptr;
+}
+
+bool LoopingSource::isLoopActive(juce::int64 pos) const
+{
+    return state.enabled && state.end > state.start && pos < state.end;
+}
+
+// a seam decoded for an earlier track must never be played, but any seam of this track holds valid audio
+bool LoopingSource::isSeamUsable() const
+{
+    return isUsable(state.seam);
+}
+
+bool LoopingSource::isUsable(const LoopSeam* seamToCheck) const
+{
+    return seamToCheck != nullptr && seamToCheck->trackId == trackId && seamToCheck->numSamples > 0;
+}
+
+// the loop's seam or the hot cue's, whichever holds the sample at pos, or nullptr if neither does
+const LoopSeam* LoopingSource::findSeam(juce::int64 pos) const
+{
+    for (const LoopSeam* seam : { state.seam, state.cueSeam })
+    {
+        if (isUsable(seam) && pos >= seam->start && pos < seam->start + seam->numSamples)
+        {
+            return seam;
+        }
+    }
+
+    return nullptr;
+}
+
+// fill the buffer from a seam where one covers pos, otherwise from the input
+void LoopingSource::read(juce::int64 pos, juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        int numThisTime = numSamples;
+
+        if (auto* seam = findSeam(pos))
+        {
+            int seamOffset = (int) (pos - seam->start);
+            numThisTime = juce::jmin(numSamples, seam->numSamples - seamOffset);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                buffer.copyFrom(channel, startSample, seam->samples, channel % seam->samples.getNumChannels(), seamOffset, numThisTime);
+            }
+        }
+
+        else
+        {
+            if (inputPosition != pos)
+            {
+                input->setNextReadPosition(pos);
+            }
+
+            input->getNextAudioBlock(juce::AudioSourceChannelInfo(&buffer, startSample, numThisTime));
+            inputPosition = pos + numThisTime;
+        }
+
+        pos += numThisTime;
+        startSample += numThisTime;
+        numSamples -= numThisTime;
+    }
+}
+
+// blend the last samples before loop-out into the samples just before loop-in with an equal-power fade,
+// so the audio arriving at loop-in already continues from what was played
+void LoopingSource::crossfade(juce::int64 pos, juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (isSeamUsable() == false)
+    {
+        return;
+    }
+
+    auto* seam = state.seam;
+    juce::int64 loopLength = state.end - state.start;
+    int length = (int) juce::jmin((juce::int64) fadeLength, loopLength / 2, state.start - seam->start);
+    juce::int64 fadeStart = state.end - length;
+
+    if (length <= 0 || pos + numSamples <= fadeStart)
+    {
+        return;
+    }
+
+    int first = (int) juce::jmax((juce::int64) 0, fadeStart - pos);
+
+    for (int i = first; i < numSamples; ++i)
+    {
+        juce::int64 seamIndex = pos + i - loopLength - seam->start;
+
+        if (seamIndex < 0 || seamIndex >= seam->numSamples)
+        {
+            continue;
+        }
+
+        double t = ((double) (pos + i - fadeStart) + 0.5) / length * juce::MathConstants<double>::halfPi;
+        float fadeOut = (float) std::cos(t);
+        float fadeIn = (float) std::sin(t);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            float* samples = buffer.getWritePointer(channel, startSample);
+            float seamSample = seam->samples.getSample(channel % seam->samples.getNumChannels(), (int) seamIndex);
+            samples[i] = samples[i] * fadeOut + seamSample * fadeIn;
+        }
+    }
+}
+
+// playback has jumped back to loop-in, so while the seam plays point the input at where the seam ends,
+// giving the read-ahead buffer the length of the seam to catch up
+void LoopingSource::wrapped()
+{
+    if (isSeamUsable() == false)
+    {
+        return;
+    }
+
+    juce::int64 seamEnd = state.seam->start + state.seam->numSamples;
+
+    if (state.start >= state.seam->start && state.start < seamEnd && seamEnd < state.end && inputPosition != seamEnd)
+    {
+        input->setNextReadPosition(seamEnd);
+        inputPosition = seamEnd;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    LoopingSource.h
+    Created: 17 Oct 2026 3:12:40pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// audio decoded either side of the loop-in point, or from a hot cue onwards, so that playback can jump
+// there without waiting for the read-ahead buffer to refill
+struct LoopSeam
+{
+    juce::AudioBuffer<float> samples;
+    juce::int64 start = 0;
+    int numSamples = 0;
+    int trackId = 0;
+};
+
+// loop settings owned by the player, only touched on the audio thread, along with the seam of the hot cue
+// that was last jumped to
+struct LoopState
+{
+    bool enabled = false;
+    juce::int64 start = 0;
+    juce::int64 end = 0;
+    const LoopSeam* seam = nullptr;
+    const LoopSeam* cueSeam = nullptr;
+};
+
+// wraps the read position between the loop-in and loop-out points on the audio thread, sample by sample,
+// with a short crossfade from the audio before loop-out into the audio before loop-in
+class LoopingSource : public juce::PositionableAudioSource
+{
+public:
+    LoopingSource(juce::PositionableAudioSource* _input, const LoopState& _state, int _trackId, double _sampleRate);
+    ~LoopingSource() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+
+    int getTrackId();
+    bool isPlayingFromSeam() const;
+
+    // the seam starts this far before loop-in and runs on for seamTime after it
+    static constexpr double fadeTime = 0.003;
+    static constexpr double seamTime = 1.0;
+
+private:
+    bool isLoopActive(juce::int64 pos) const;
+    bool isSeamUsable() const;
+    bool isUsable(const LoopSeam* seamToCheck) const;
+    const LoopSeam* findSeam(juce::int64 pos) const;
+    void read(juce::int64 pos, juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void crossfade(juce::int64 pos, juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void wrapped();
+
+    juce::PositionableAudioSource* input;
+    const LoopState& state;
+    int trackId;
+    int fadeLength;
+
+    std::atomic<juce::int64> position{ 0 };
+    juce::int64 inputPosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopingSource)
+};
\ No newline at end of file
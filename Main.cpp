@@ -1,76 +1,94 @@
-/*
-  ==============================================================================
-
-    This file contains the basic startup code for a JUCE application.
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "MainComponent.h"
-
-class OtoDecksApplication : public juce::JUCEApplication
-{
-public:
-    OtoDecksApplication() {}
-
-    const juce::String getApplicationName() override       { return ProjectInfo::projectName; }
-    const juce::String getApplicationVersion() override    { return ProjectInfo::versionString; }
-    bool moreThanOneInstanceAllowed() override             { return true; }
-
-    void initialise(const juce::String& commandLine) override
-    {
-        mainWindow.reset(new MainWindow(getApplicationName()));
-    }
-
-    void shutdown() override
-    {
-        mainWindow = nullptr;
-    }
-
-    void systemRequestedQuit() override
-    {
-        quit();
-    }
-
-    void anotherInstanceStarted(const juce::String& commandLine) override
-    {
-        
-    }
-
-    class MainWindow : public juce::DocumentWindow
-    {
-    public:
-        MainWindow(juce::String name)
-            : DocumentWindow(name,
-                              juce::Desktop::getInstance().getDefaultLookAndFeel()
-                                                          .findColour(juce::ResizableWindow::backgroundColourId),
-                              DocumentWindow::allButtons)
-        {
-            setUsingNativeTitleBar(true);
-            setContentOwned(new MainComponent(), true);
-
-           #if JUCE_IOS || JUCE_ANDROID
-            setFullScreen(true);
-           #else
-            setResizable(true, true);
-            centreWithSize(getWidth(), getHeight());
-           #endif
-
-            setVisible(true);
-        }
-
-        void closeButtonPressed() override
-        {
-            JUCEApplication::getInstance()->systemRequestedQuit();
-        }
-
-    private:
-        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainWindow)
-    };
-
-private:
-    std::unique_ptr<MainWindow> mainWindow;
-};
-
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "MainComponent.h"
+
+class OtoDecksApplication : public juce::JUCEApplication
+{
+public:
+    OtoDecksApplication() {}
+
+    const juce::String getApplicationName() override       { return ProjectInfo::projectName; }
+    const juce::String getApplicationVersion() override    { return ProjectInfo::versionString; }
+    bool moreThanOneInstanceAllowed() override             { return true; }
+
+    void initialise(const juce::String& commandLine) override
+    {
+        // --decks=N sets how many decks are in use, for example 4 for a four-deck set, and
+        // --render-threads=N renders them in parallel on N worker threads as well as the audio thread
+        int numDecks = 2;
+        int numRenderThreads = 0;
+
+        for (auto& argument : getCommandLineParameterArray())
+        {
+            if (argument.startsWith("--decks="))
+            {
+                numDecks = juce::jlimit(1, DeckEngine::defaultMaxDecks, argument.fromFirstOccurrenceOf("=", false, false).getIntValue());
+            }
+
+            if (argument.startsWith("--render-threads="))
+            {
+                numRenderThreads = juce::jlimit(0, juce::SystemStats::getNumCpus(), argument.fromFirstOccurrenceOf("=", false, false).getIntValue());
+            }
+        }
+
+        mainWindow.reset(new MainWindow(getApplicationName(), numDecks, numRenderThreads));
+    }
+
+    void shutdown() override
+    {
+        mainWindow = nullptr;
+    }
+
+    void systemRequestedQuit() override
+    {
+        quit();
+    }
+
+    void anotherInstanceStarted(const juce::String& commandLine) override
+    {
+        
+    }
+
+    class MainWindow : public juce::DocumentWindow
+    {
+    public:
+        MainWindow(juce::String name, int numDecks, int numRenderThreads)
+            : DocumentWindow(name,
+                              juce::Desktop::getInstance().getDefaultLookAndFeel()
+                                                          .findColour(juce::ResizableWindow::backgroundColourId),
+                              DocumentWindow::allButtons)
+        {
+            setUsingNativeTitleBar(true);
+            setContentOwned(new MainComponent(numDecks, numRenderThreads), true);
+
+           #if JUCE_IOS || JUCE_ANDROID
+            setFullScreen(true);
+           #else
+            setResizable(true, true);
+            centreWithSize(getWidth(), getHeight());
+           #endif
+
+            setVisible(true);
+        }
+
+        void closeButtonPressed() override
+        {
+            JUCEApplication::getInstance()->systemRequestedQuit();
+        }
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainWindow)
+    };
+
+private:
+    std::unique_ptr<MainWindow> mainWindow;
+};
+
 START_JUCE_APPLICATION(OtoDecksApplication)
\ No newline at end of file
@@ -1,108 +1,299 @@
-#include "MainComponent.h"
-#include <iostream>
-#include <fstream>
-
-MainComponent::MainComponent()
-{
-    // set size of component
-    setSize(1370, 835);
-
-    if (juce::RuntimePermissions::isRequired(juce::RuntimePermissions::recordAudio)
-        && juce::RuntimePermissions::isGranted(juce::RuntimePermissions::recordAudio) == false) // if microphone access is required and permission not granted
-    {
-        // request for permission and set 2 output channels
-        juce::RuntimePermissions::request(juce::RuntimePermissions::recordAudio,
-                                           [&] (bool granted) { setAudioChannels(granted ? 2 : 0, 2); });
-    }
-
-    else
-    {
-        // set 2 output channels
-        setAudioChannels(0, 2);
-    }
-
-    // add and make visible decks and playlist
-    addAndMakeVisible(deckGUI1);
-    addAndMakeVisible(deckGUI2);
-    addAndMakeVisible(playlistComponent);
-
-    // register basic formats for the audio files
-    formatManager.registerBasicFormats();
-
-    // read previously loaded tracks from deck file
-    readFromDeckFile();
-
-    // set font
-    getLookAndFeel().setDefaultSansSerifTypefaceName("Avenir LT Std");
-}
-
-MainComponent::~MainComponent()
-{
-    // shut down audio device and clear audio source
-    shutdownAudio();
-}
-
-void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
-{
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
-}
-
-void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
-{
-    mixerSource.getNextAudioBlock(bufferToFill);
-}
-
-void MainComponent::releaseResources()
-{
-    player1.releaseResources();
-    player2.releaseResources();
-    mixerSource.releaseResources();
-}
-
-void MainComponent::paint(juce::Graphics& g)
-{
-    
-}
-
-void MainComponent::resized()
-{
-    deckGUI1.setBounds(0, 0, getWidth() / 2, getHeight() / 2);
-    deckGUI2.setBounds(getWidth() / 2, 0, getWidth() / 2, getHeight() / 2);
-    playlistComponent.setBounds(0, getHeight() / 2, getWidth(), getHeight() / 2);
-}
-
-void MainComponent::readFromDeckFile()
-{
-    // open deck.txt which contains the deck numbers and file paths which the user had loaded previously
-    std::ifstream deckFile("deck.txt");
-    std::string line;
-    std::vector<std::string> lines;
-
-    while (std::getline(deckFile, line))
-    {
-        lines.push_back(line);
-    }
-
-    for (int i = 0; i < lines.size(); i += 5)
-    {
-        // load each track into the respective deck and set their respective slider values
-        if (lines[i] == "1")
-        {
-            deckGUI1.loadTrack(lines[i + 1]);
-            deckGUI1.setSliderValues(std::stod(lines[i + 2]), std::stod(lines[i + 3]), std::stod(lines[i + 4]));
-        }
-
-        else
-        {
-            deckGUI2.loadTrack(lines[i + 1]);
-            deckGUI2.setSliderValues(std::stod(lines[i + 2]), std::stod(lines[i + 3]), std::stod(lines[i + 4]));
-        }
-    }
-
-    // close the file
-    deckFile.close();
+#include "MainComponent.h"
+#include <iostream>
+#include <fstream>
+
+MainComponent::MainComponent(int numDecks, int numRenderThreads)
+{
+    // create a deck for each player the engine has in use
+    deckEngine.setNumDecks(numDecks);
+    deckEngine.setRenderThreads(numRenderThreads);
+    std::vector<DeckGUI*> decks;
+
+    for (int i = 0; i < deckEngine.getNumDecks(); ++i)
+    {
+        decks.push_back(deckGUIs.add(new DeckGUI(deckEngine.getDeck(i), formatManager, waveformCache)));
+    }
+
+    playlistComponent.reset(new PlaylistComponent(decks));
+    profilerOverlay.reset(new ProfilerOverlay(deckEngine.getProfiler(), deckEngine.getNumDecks()));
+
+    // add and make visible decks and playlist
+    for (auto* deckGUI : deckGUIs)
+    {
+        addAndMakeVisible(deckGUI);
+    }
+
+    addAndMakeVisible(crossfaderSlider);
+    addAndMakeVisible(crossfaderCurveBox);
+    addAndMakeVisible(profilerButton);
+    addAndMakeVisible(recordFormatBox);
+    addAndMakeVisible(recordButton);
+    addAndMakeVisible(playlistComponent.get());
+
+    // the profiler overlay sits above everything else and is shown with the CPU button
+    addChildComponent(profilerOverlay.get());
+
+    // set style of profilerButton, which stays lit while the overlay is showing
+    profilerButton.setClickingTogglesState(true);
+    profilerButton.setColour(juce::TextButton::buttonColourId, juce::Colour(35, 47, 52));
+    profilerButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(8, 227, 169));
+    profilerButton.addListener(this);
+
+    // set style of recordButton, which stays lit while the master output is being recorded
+    recordButton.setClickingTogglesState(true);
+    recordButton.setColour(juce::TextButton::buttonColourId, juce::Colour(35, 47, 52));
+    recordButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(229, 57, 53));
+    recordButton.addListener(this);
+
+    // add the formats a set can be recorded in, by file extension
+    recordFormatBox.addItem("WAV", 1);
+    recordFormatBox.addItem("FLAC", 2);
+    recordFormatBox.setSelectedId(1, juce::NotificationType::dontSendNotification);
+
+    // set style of crossfaderSlider, which starts in the centre
+    crossfaderSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    crossfaderSlider.setRange(0.0, 1.0);
+    crossfaderSlider.setValue(deckEngine.getMixer().getCrossfader(), juce::NotificationType::dontSendNotification);
+    crossfaderSlider.setDoubleClickReturnValue(true, 0.5);
+    crossfaderSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    crossfaderSlider.setColour(juce::Slider::trackColourId, juce::Colour(8, 227, 169));
+    crossfaderSlider.setColour(juce::Slider::backgroundColourId, juce::Colour(93, 96, 107));
+    crossfaderSlider.setColour(juce::Slider::thumbColourId, juce::Colours::white);
+    crossfaderSlider.addListener(this);
+
+    // add the crossfader curves in the same order as MixerStage::CrossfaderCurve
+    crossfaderCurveBox.addItem("DIPLESS", 1);
+    crossfaderCurveBox.addItem("SMOOTH", 2);
+    crossfaderCurveBox.addItem("CUT", 3);
+    crossfaderCurveBox.setSelectedId((int) deckEngine.getMixer().getCrossfaderCurve() + 1, juce::NotificationType::dontSendNotification);
+    crossfaderCurveBox.addListener(this);
+
+    // set size of component
+    setSize(1370, 835);
+
+    if (juce::RuntimePermissions::isRequired(juce::RuntimePermissions::recordAudio)
+        && juce::RuntimePermissions::isGranted(juce::RuntimePermissions::recordAudio) == false) // if microphone access is required and permission not granted
+    {
+        // request for permission and set 2 output channels
+        juce::RuntimePermissions::request(juce::RuntimePermissions::recordAudio,
+                                           [&] (bool granted) { setAudioChannels(granted ? 2 : 0, 2); });
+    }
+
+    else
+    {
+        // set 2 output channels
+        setAudioChannels(0, 2);
+    }
+
+    // register basic formats for the audio files
+    formatManager.registerBasicFormats();
+
+    // read previously loaded tracks from deck file
+    readFromDeckFile();
+
+    // set font
+    getLookAndFeel().setDefaultSansSerifTypefaceName("Avenir LT Std");
+
+    // timer updates the recording time twice a second
+    startTimer(500);
+}
+
+MainComponent::~MainComponent()
+{
+    // shut down audio device and clear audio source
+    shutdownAudio();
+    stopTimer();
+
+    // finish a recording that is still running, now that no more blocks can arrive
+    recorder.stop();
+
+    // dump the callback profile next to deck.txt, so glitches can be matched against what was happening at the time
+    auto& profiler = deckEngine.getProfiler();
+    profiler.writeLog(juce::File::getCurrentWorkingDirectory().getChildFile("profile.txt"));
+    DBG("Audio callbacks: " << profiler.getNumCallbacks() << " blocks, " << profiler.getNumDeadlineMisses() << " missed deadlines, "
+        << profiler.getNumXruns() << " xruns, load " << profiler.getAverageLoad() << " average and " << profiler.getPeakLoad() << " peak");
+
+    for (int i = 0; i < deckEngine.getNumDecks(); ++i)
+    {
+        auto* player = deckEngine.getDeck(i);
+        DBG("Deck " << i + 1 << " read-ahead underruns: " << player->getUnderrunCount() << " (" << player->getUnderrunSamples() << " samples)");
+    }
+
+    DBG("Deck rendering: " << deckEngine.getAverageRenderTime(false) << " ms per block on the audio thread, "
+        << deckEngine.getAverageRenderTime(true) << " ms per block with " << deckEngine.getRenderThreads() << " render threads");
+
+    auto& trackCache = deckEngine.getTrackCache();
+    DBG("Track cache: " << trackCache.getHitCount() << " hits, " << trackCache.getMissCount() << " misses, "
+        << trackCache.getNumTracks() << " tracks using " << trackCache.getResidentBytes() / (1024 * 1024) << " MB");
+}
+
+void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    deckEngine.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    recorder.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto& profiler = deckEngine.getProfiler();
+    juce::int64 startTicks = profiler.startCallback();
+    deckEngine.getNextAudioBlock(bufferToFill);
+    recorder.pushBlock(bufferToFill);
+    profiler.endCallback(startTicks, bufferToFill.numSamples);
+}
+
+void MainComponent::releaseResources()
+{
+    deckEngine.releaseResources();
+}
+
+void MainComponent::paint(juce::Graphics& g)
+{
+    
+}
+
+void MainComponent::resized()
+{
+    // decks fill the top half two to a row, above the crossfader
+    int crossfaderH = getHeight() / 20;
+    int decksH = getHeight() / 2 - crossfaderH;
+    int numColumns = juce::jmin(2, deckGUIs.size());
+    int numRows = (deckGUIs.size() + 1) / 2;
+
+    for (int i = 0; i < deckGUIs.size(); ++i)
+    {
+        deckGUIs[i]->setBounds(getWidth() * (i % numColumns) / numColumns, decksH * (i / numColumns) / numRows,
+                               getWidth() / numColumns, decksH / numRows);
+    }
+
+    crossfaderCurveBox.setBounds(getWidth() * 0.02, decksH + crossfaderH / 6, getWidth() * 0.1, crossfaderH * 2 / 3);
+    crossfaderSlider.setBounds(getWidth() * 0.3, decksH, getWidth() * 0.4, crossfaderH);
+    recordFormatBox.setBounds(getWidth() * 0.72, decksH + crossfaderH / 6, getWidth() * 0.07, crossfaderH * 2 / 3);
+    recordButton.setBounds(getWidth() * 0.8, decksH + crossfaderH / 6, getWidth() * 0.08, crossfaderH * 2 / 3);
+    profilerButton.setBounds(getWidth() * 0.9, decksH + crossfaderH / 6, getWidth() * 0.08, crossfaderH * 2 / 3);
+    profilerOverlay->setBounds(getWidth() - 340, decksH + crossfaderH, 320, 120 + 16 * deckEngine.getNumDecks());
+
+    playlistComponent->setBounds(0, getHeight() / 2, getWidth(), getHeight() / 2);
+}
+
+void MainComponent::buttonClicked(juce::Button* button)
+{
+    // if CPU button is clicked, show or hide the profiler overlay
+    if (button == &profilerButton)
+    {
+        profilerOverlay->setVisible(profilerButton.getToggleState());
+    }
+
+    // if REC button is clicked, start or stop recording the master output
+    if (button == &recordButton)
+    {
+        if (recordButton.getToggleState())
+        {
+            startRecording();
+        }
+
+        else
+        {
+            stopRecording();
+        }
+    }
+}
+
+void MainComponent::sliderValueChanged(juce::Slider* slider)
+{
+    // if crossfader is moved, fade between the decks on the left and right of the mixer
+    if (slider == &crossfaderSlider)
+    {
+        deckEngine.getMixer().setCrossfader((float) slider->getValue());
+        deckEngine.getProfiler().logAction(-1, "crossfader " + juce::String(slider->getValue(), 3));
+    }
+}
+
+void MainComponent::comboBoxChanged(juce::ComboBox* comboBox)
+{
+    // if a crossfader curve is picked, apply it to the mixer
+    if (comboBox == &crossfaderCurveBox)
+    {
+        DBG("Crossfader curve changed to " << comboBox->getText());
+        deckEngine.getMixer().setCrossfaderCurve((MixerStage::CrossfaderCurve) (comboBox->getSelectedId() - 1));
+        deckEngine.getProfiler().logAction(-1, "crossfader curve " + comboBox->getText());
+    }
+}
+
+// show how long the set has been recording for on the REC button, or that the file can no longer be written
+void MainComponent::timerCallback()
+{
+    if (recorder.isRecording() && recorder.hasWriteFailed())
+    {
+        recordButton.setButtonText("REC FAILED");
+    }
+
+    else if (recorder.isRecording())
+    {
+        int seconds = (int) recorder.getRecordedSeconds();
+        recordButton.setButtonText(juce::String::formatted("REC %02d:%02d:%02d", seconds / 3600, seconds / 60 % 60, seconds % 60));
+    }
+}
+
+// record into a new file in the recordings folder next to deck.txt, named after the time the set started
+void MainComponent::startRecording()
+{
+    juce::String extension = recordFormatBox.getSelectedId() == 2 ? ".flac" : ".wav";
+    juce::File file = juce::File::getCurrentWorkingDirectory().getChildFile("recordings")
+                                                               .getChildFile("set " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S") + extension);
+    juce::String error;
+
+    if (recorder.start(file, error))
+    {
+        recordFormatBox.setEnabled(false);
+        deckEngine.getProfiler().logAction(-1, "recording to " + file.getFileName());
+    }
+
+    // if the file cannot be written, display an alert window
+    else
+    {
+        recordButton.setToggleState(false, juce::NotificationType::dontSendNotification);
+        juce::AlertWindow recordError("Unable to record", error, juce::MessageBoxIconType::WarningIcon);
+        recordError.addButton("OK", true);
+        recordError.runModalLoop();
+    }
+}
+
+void MainComponent::stopRecording()
+{
+    recorder.stop();
+    recordButton.setButtonText("REC");
+    recordFormatBox.setEnabled(true);
+    deckEngine.getProfiler().logAction(-1, "recording stopped after " + juce::String(recorder.getRecordedSeconds(), 1) + " s, "
+                                           + juce::String(recorder.getDroppedSamples()) + " samples dropped"
+                                           + (recorder.hasWriteFailed() ? ", the file could not be written past that" : ""));
+}
+
+void MainComponent::readFromDeckFile()
+{
+    // open deck.txt which contains the deck numbers and file paths which the user had loaded previously
+    std::ifstream deckFile("deck.txt");
+    std::string line;
+    std::vector<std::string> lines;
+
+    while (std::getline(deckFile, line))
+    {
+        lines.push_back(line);
+    }
+
+    for (int i = 0; i < lines.size(); i += 5)
+    {
+        // load each track into the respective deck and set their respective slider values,
+        // skipping decks that are not in use this time
+        int deck = juce::String(lines[i]).getIntValue() - 1;
+
+        if (juce::isPositiveAndBelow(deck, deckGUIs.size()) && i + 4 < lines.size())
+        {
+            deckGUIs[deck]->loadTrack(lines[i + 1]);
+            deckGUIs[deck]->setSliderValues(std::stod(lines[i + 2]), std::stod(lines[i + 3]), std::stod(lines[i + 4]));
+        }
+    }
+
+    // close the file
+    deckFile.close();
 }
\ No newline at end of file
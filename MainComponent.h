@@ -1,38 +1,54 @@
-#pragma once
-
-#include <JuceHeader.h>
-#include "DJAudioPlayer.h"
-#include "DeckGUI.h"
-#include "PlaylistComponent.h"
-
-class MainComponent : public juce::AudioAppComponent
-{
-public:
-    MainComponent();
-    ~MainComponent() override;
-
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
-    void releaseResources() override;
-
-    void paint(juce::Graphics& g) override;
-    void resized() override;
-
-    void readFromDeckFile();
-
-private:
-    juce::AudioFormatManager formatManager;
-    juce::AudioThumbnailCache thumbCache{ 100 };
-
-    DJAudioPlayer player1{ formatManager };
-    DeckGUI deckGUI1{ &player1, formatManager, thumbCache };
-
-    DJAudioPlayer player2{ formatManager };
-    DeckGUI deckGUI2{ &player2, formatManager, thumbCache };
-
-    juce::MixerAudioSource mixerSource;
-
-    PlaylistComponent playlistComponent{ &deckGUI1, &deckGUI2 };
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
+#pragma once
+
+#include <JuceHeader.h>
+#include "DeckEngine.h"
+#include "DeckGUI.h"
+#include "PlaylistComponent.h"
+#include "ProfilerOverlay.h"
+#include "MasterRecorder.h"
+
+class MainComponent : public juce::AudioAppComponent,
+                      public juce::Button::Listener,
+                      public juce::Slider::Listener,
+                      public juce::ComboBox::Listener,
+                      public juce::Timer
+{
+public:
+    MainComponent(int numDecks = 2, int numRenderThreads = 0);
+    ~MainComponent() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    void buttonClicked(juce::Button* button) override;
+    void sliderValueChanged(juce::Slider* slider) override;
+    void comboBoxChanged(juce::ComboBox* comboBox) override;
+    void timerCallback() override;
+
+    void readFromDeckFile();
+
+private:
+    void startRecording();
+    void stopRecording();
+
+    juce::AudioFormatManager formatManager;
+    WaveformCache waveformCache;
+
+    DeckEngine deckEngine{ formatManager };
+    juce::OwnedArray<DeckGUI> deckGUIs;
+    juce::Slider crossfaderSlider;
+    juce::ComboBox crossfaderCurveBox;
+    juce::TextButton profilerButton{ "CPU" };
+    juce::ComboBox recordFormatBox;
+    juce::TextButton recordButton{ "REC" };
+    MasterRecorder recorder{ formatManager };
+    std::unique_ptr<ProfilerOverlay> profilerOverlay;
+
+    std::unique_ptr<PlaylistComponent> playlistComponent;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 };
\ No newline at end of file
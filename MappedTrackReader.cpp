@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    MappedTrackReader.cpp
+    Created: 17 Oct 2026 11:03:18am
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "MappedTrackReader.h"
+
+MappedTrackReader::MappedTrackReader(juce::MemoryMappedAudioFormatReader* _mappedReader) :
+                                     juce::AudioFormatReader(nullptr, _mappedReader->getFormatName()),
+                                     mappedReader(_mappedReader)
+{
+    sampleRate = mappedReader->sampleRate;
+    bitsPerSample = mappedReader->bitsPerSample;
+    lengthInSamples = mappedReader->lengthInSamples;
+    numChannels = mappedReader->numChannels;
+    usesFloatingPointData = mappedReader->usesFloatingPointData;
+    metadataValues = mappedReader->metadataValues;
+
+    // size the mapped window and the prefault distance in samples rather than bytes
+    juce::int64 bytesPerFrame = juce::jmax((juce::int64) 1, (juce::int64) (numChannels * bitsPerSample / 8));
+    windowSamples = juce::jmax((juce::int64) 65536, mappedWindowBytes / bytesPerFrame);
+    prefaultSamples = prefaultBytes / bytesPerFrame;
+    samplesPerPage = juce::jmax((juce::int64) 1, (juce::int64) 4096 / bytesPerFrame);
+}
+
+MappedTrackReader::~MappedTrackReader()
+{
+
+}
+
+MappedTrackReader* MappedTrackReader::createFor(const juce::File& file)
+{
+    juce::MemoryMappedAudioFormatReader* mappedReader = nullptr;
+
+    if (file.hasFileExtension("wav"))
+    {
+        mappedReader = juce::WavAudioFormat().createMemoryMappedReader(file);
+    }
+
+    else if (file.hasFileExtension("aif;aiff"))
+    {
+        mappedReader = juce::AiffAudioFormat().createMemoryMappedReader(file);
+    }
+
+    if (mappedReader == nullptr || mappedReader->lengthInSamples <= 0)
+    {
+        delete mappedReader;
+        return nullptr;
+    }
+
+    return new MappedTrackReader(mappedReader);
+}
+
+bool MappedTrackReader::readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                                    juce::int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength(destChannels, numDestChannels, startOffsetInDestBuffer,
+                                      startSampleInFile, numSamples, lengthInSamples);
+
+    if (numSamples <= 0)
+    {
+        return true;
+    }
+
+    juce::Range<juce::int64> samplesNeeded(startSampleInFile, startSampleInFile + numSamples);
+
+    // move the window when the playhead leaves it, and give up on the block if the file cannot be mapped
+    if (mappedReader->getMappedSection().contains(samplesNeeded) == false && mapAround(samplesNeeded) == false)
+    {
+        for (int channel = 0; channel < numDestChannels; ++channel)
+        {
+            if (destChannels[channel] != nullptr)
+            {
+                std::memset(destChannels[channel] + startOffsetInDestBuffer, 0, sizeof(int) * (size_t) numSamples);
+            }
+        }
+
+        return false;
+    }
+
+    bool result = mappedReader->readSamples(destChannels, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    prefaultAhead(samplesNeeded.getEnd());
+
+    return result;
+}
+
+void MappedTrackReader::setLoopRegion(juce::Range<juce::int64> newLoopRegion)
+{
+    // the region only steers where the window is mapped, so one too far into the file to pack is dropped
+    if (newLoopRegion.isEmpty() || newLoopRegion.getStart() < 0 || newLoopRegion.getEnd() > (juce::int64) 0xffffffff)
+    {
+        loopRegion = 0;
+    }
+
+    else
+    {
+        loopRegion = ((juce::uint64) newLoopRegion.getStart() << 32) | (juce::uint64) newLoopRegion.getEnd();
+    }
+}
+
+juce::Range<juce::int64> MappedTrackReader::getMappedSection()
+{
+    return mappedReader->getMappedSection();
+}
+
+int MappedTrackReader::getNumRemaps()
+{
+    return numRemaps;
+}
+
+// map a window starting a little before the samples needed, stretched to cover the loop region when it fits.
+// if that much cannot be mapped, the plain window and then the samples needed alone are tried, returns false
+// if not even those could be
+bool MappedTrackReader::mapAround(juce::Range<juce::int64> samplesNeeded)
+{
+    juce::Range<juce::int64> window(samplesNeeded.getStart() - windowSamples / 8,
+                                    samplesNeeded.getStart() - windowSamples / 8 + windowSamples);
+    juce::uint64 packedLoop = loopRegion;
+    juce::Range<juce::int64> loop((juce::int64) (packedLoop >> 32), (juce::int64) (packedLoop & 0xffffffff));
+    juce::Range<juce::int64> withLoop = window;
+
+    if (loop.isEmpty() == false && loop.intersects(window.expanded(windowSamples)))
+    {
+        withLoop = window.getUnionWith(loop);
+
+        if (withLoop.getLength() > windowSamples * 2)
+        {
+            withLoop = window;
+        }
+    }
+
+    lastPrefaulted = -1;
+    numRemaps++;
+
+    for (auto section : { withLoop, window, samplesNeeded })
+    {
+        section = section.getIntersectionWith({ 0, lengthInSamples }).getUnionWith(samplesNeeded);
+
+        if (mappedReader->mapSectionOfFile(section) && mappedReader->getMappedSection().contains(samplesNeeded))
+        {
+            return true;
+        }
+    }
+
+    DBG("MappedTrackReader::mapAround cannot map samples " << samplesNeeded.getStart() << " to " << samplesNeeded.getEnd());
+    return false;
+}
+
+// touch the pages just ahead of the playhead so they are in the page cache before they are read
+void MappedTrackReader::prefaultAhead(juce::int64 sample)
+{
+    juce::Range<juce::int64> mapped = mappedReader->getMappedSection();
+    juce::int64 from = (lastPrefaulted > sample && lastPrefaulted <= sample + prefaultSamples) ? lastPrefaulted : sample;
+    juce::int64 to = juce::jmin(sample + prefaultSamples, mapped.getEnd());
+
+    for (juce::int64 i = from; i < to; i += samplesPerPage)
+    {
+        mappedReader->touchSample(i);
+    }
+
+    lastPrefaulted = juce::jmax(from, to);
+}
\ No newline at end of file
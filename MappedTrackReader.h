@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    MappedTrackReader.h
+    Created: 17 Oct 2026 11:03:18am
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class MappedTrackReader : public juce::AudioFormatReader
+{
+public:
+    MappedTrackReader(juce::MemoryMappedAudioFormatReader* _mappedReader);
+    ~MappedTrackReader() override;
+
+    // create a mapped reader for WAV and AIFF files, returns nullptr for any other format
+    static MappedTrackReader* createFor(const juce::File& file);
+
+    bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                     juce::int64 startSampleInFile, int numSamples) override;
+
+    // keep the loop region mapped alongside the playhead, an empty range clears it. it only steers the window,
+    // so a region that ends past sample 2^32 - 1 is ignored
+    void setLoopRegion(juce::Range<juce::int64> newLoopRegion);
+
+    juce::Range<juce::int64> getMappedSection();
+    int getNumRemaps();
+
+    static constexpr juce::int64 mappedWindowBytes = 64 * 1024 * 1024;
+    static constexpr juce::int64 prefaultBytes = 1024 * 1024;
+
+private:
+    bool mapAround(juce::Range<juce::int64> samplesNeeded);
+    void prefaultAhead(juce::int64 sample);
+
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader;
+    juce::int64 windowSamples;
+    juce::int64 prefaultSamples;
+    juce::int64 samplesPerPage;
+    juce::int64 lastPrefaulted = -1;
+
+    // the loop's start in the high 32 bits and its end in the low 32, so that both are published together
+    std::atomic<juce::uint64> loopRegion{ 0 };
+
+    int numRemaps = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MappedTrackReader)
+};
\ No newline at end of file
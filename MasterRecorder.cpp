@@ -0,0 +1,286 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.cpp
+    Created: 17 Oct 2026 9:52:13pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "MasterRecorder.h"
+
+MasterRecorder::MasterRecorder(juce::AudioFormatManager& _formatManager, double _fifoSeconds) :
+                               juce::Thread("Master recorder"),
+                               formatManager(_formatManager),
+                               fifoSeconds(_fifoSeconds)
+{
+    startThread();
+}
+
+MasterRecorder::~MasterRecorder()
+{
+    stop();
+    signalThreadShouldExit();
+    notify();
+    stopThread(4000);
+}
+
+void MasterRecorder::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    if (recording)
+    {
+        DBG("MasterRecorder::prepareToPlay the device changed while recording, the file keeps the rate it was started with");
+        return;
+    }
+
+    sampleRate = newSampleRate;
+
+    int capacity = juce::jmax(samplesPerBlockExpected * 4, (int) std::ceil(sampleRate * fifoSeconds));
+    ring.setSize(numChannels, capacity);
+    fifo.setTotalSize(capacity);
+}
+
+bool MasterRecorder::start(const juce::File& newFile, juce::String& error)
+{
+    if (recording)
+    {
+        error = "already recording to " + file.getFullPathName();
+        return false;
+    }
+
+    if (sampleRate <= 0)
+    {
+        error = "the audio device has not started";
+        return false;
+    }
+
+    auto* format = formatManager.findFormatForFileExtension(newFile.getFileExtension());
+
+    if (format == nullptr)
+    {
+        error = "cannot write " + newFile.getFileExtension() + " files";
+        return false;
+    }
+
+    newFile.getParentDirectory().createDirectory();
+    newFile.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream = newFile.createOutputStream();
+    int bitDepth = format->getPossibleBitDepths().contains(24) ? 24 : 16;
+    std::unique_ptr<juce::AudioFormatWriter> newWriter;
+
+    if (stream != nullptr)
+    {
+        newWriter.reset(format->createWriterFor(stream.get(), sampleRate, numChannels, bitDepth, {}, 0));
+    }
+
+    if (newWriter == nullptr)
+    {
+        error = "cannot write " + newFile.getFullPathName();
+        return false;
+    }
+
+    // the writer owns the stream from here on
+    stream.release();
+
+    {
+        const juce::ScopedLock sl(writerLock);
+        writer = std::move(newWriter);
+        file = newFile;
+    }
+
+    fifo.reset();
+    recordedSamples = 0;
+    writeFailed = false;
+    highWaterMark = 0;
+    droppedSamples = 0;
+    numDroppedBlocks = 0;
+    recording = true;
+
+    return true;
+}
+
+void MasterRecorder::stop()
+{
+    recording = false;
+
+    // let the audio thread finish a block it may be in the middle of copying
+    while (pushing)
+    {
+        juce::Thread::yield();
+    }
+
+    const juce::ScopedLock sl(writerLock);
+
+    if (writer != nullptr)
+    {
+        drain();
+
+        // deleting the writer finishes the file's header
+        writer.reset();
+
+        DBG("MasterRecorder::stop wrote " << getRecordedSeconds() << " seconds to " << file.getFileName() << ", ring high-water mark "
+            << highWaterMark << " of " << getFifoCapacity() << " samples, " << droppedSamples << " samples dropped"
+            << (writeFailed ? ", stopped at a failed write" : ""));
+    }
+}
+
+bool MasterRecorder::isRecording()
+{
+    return recording;
+}
+
+juce::File MasterRecorder::getFile()
+{
+    const juce::ScopedLock sl(writerLock);
+    return file;
+}
+
+void MasterRecorder::pushBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // set before checking recording, so that stop either sees this block in progress or this block sees the stop
+    pushing = true;
+
+    if (recording)
+    {
+        int numSamples = bufferToFill.numSamples;
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        // a block that does not fit whole is dropped whole, so the file only ever skips at block boundaries
+        if (size1 + size2 < numSamples)
+        {
+            droppedSamples += numSamples;
+            numDroppedBlocks++;
+        }
+
+        else
+        {
+            const auto& source = *bufferToFill.buffer;
+            int numSourceChannels = source.getNumChannels();
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                if (numSourceChannels == 0)
+                {
+                    ring.clear(channel, start1, size1);
+                    ring.clear(channel, start2, size2);
+                    continue;
+                }
+
+                ring.copyFrom(channel, start1, source, channel % numSourceChannels, bufferToFill.startSample, size1);
+
+                if (size2 > 0)
+                {
+                    ring.copyFrom(channel, start2, source, channel % numSourceChannels, bufferToFill.startSample + size1, size2);
+                }
+            }
+
+            fifo.finishedWrite(numSamples);
+        }
+
+        // only this thread raises the mark, so it does not need a compare-and-swap
+        int numWaiting = fifo.getNumReady();
+
+        if (numWaiting > highWaterMark)
+        {
+            highWaterMark = numWaiting;
+        }
+    }
+
+    pushing = false;
+}
+
+juce::int64 MasterRecorder::getRecordedSamples()
+{
+    return recordedSamples;
+}
+
+double MasterRecorder::getRecordedSeconds()
+{
+    return sampleRate > 0 ? recordedSamples / sampleRate : 0;
+}
+
+bool MasterRecorder::hasWriteFailed()
+{
+    return writeFailed;
+}
+
+int MasterRecorder::getHighWaterMark()
+{
+    return highWaterMark;
+}
+
+// one slot of the fifo is always kept free
+int MasterRecorder::getFifoCapacity()
+{
+    return fifo.getTotalSize() - 1;
+}
+
+juce::int64 MasterRecorder::getDroppedSamples()
+{
+    return droppedSamples;
+}
+
+int MasterRecorder::getNumDroppedBlocks()
+{
+    return numDroppedBlocks;
+}
+
+// write out whatever the audio thread has copied into the ring, then sleep until the next round
+void MasterRecorder::run()
+{
+    while (threadShouldExit() == false)
+    {
+        {
+            const juce::ScopedLock sl(writerLock);
+
+            if (writer != nullptr)
+            {
+                drain();
+            }
+        }
+
+        wait(drainInterval);
+    }
+}
+
+// called with the writer lock held
+void MasterRecorder::drain()
+{
+    int numReady = fifo.getNumReady();
+
+    if (numReady == 0)
+    {
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+    // only count what reached the file, and once a write fails stop writing, so the file never has a gap in it,
+    // but still empty the ring so the audio thread does not start dropping blocks
+    int starts[] = { start1, start2 };
+    int sizes[] = { size1, size2 };
+
+    for (int i = 0; i < 2 && writeFailed == false; ++i)
+    {
+        if (sizes[i] == 0)
+        {
+            continue;
+        }
+
+        if (writer->writeFromAudioSampleBuffer(ring, starts[i], sizes[i]) == false)
+        {
+            DBG("MasterRecorder::drain cannot write to " << file.getFullPathName());
+            writeFailed = true;
+        }
+
+        else
+        {
+            recordedSamples += sizes[i];
+        }
+    }
+
+    fifo.finishedRead(size1 + size2);
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.h
+    Created: 17 Oct 2026 9:52:13pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// records the master output to any file format the format manager can write, such as WAV or FLAC. the audio
+// thread only copies each block into a ring allocated up front and never waits, and a background thread
+// drains the ring into the file, so memory stays the same however many hours the set runs
+class MasterRecorder : private juce::Thread
+{
+public:
+    MasterRecorder(juce::AudioFormatManager& _formatManager, double _fifoSeconds = defaultFifoSeconds);
+    ~MasterRecorder() override;
+
+    // size the ring for the device's rate, which is kept while a recording is running
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    // start writing into the file, in the format of its extension, returns false with a message if it cannot be written
+    bool start(const juce::File& file, juce::String& error);
+
+    // stop taking blocks, write whatever is still in the ring and close the file
+    void stop();
+    bool isRecording();
+    juce::File getFile();
+
+    // copy the block into the ring, on the audio thread, dropping what does not fit rather than waiting
+    void pushBlock(const juce::AudioSourceChannelInfo& bufferToFill);
+
+    // samples written to the file so far and the seconds they last
+    juce::int64 getRecordedSamples();
+    double getRecordedSeconds();
+
+    // true once a write to the file has failed, for example because the disk is full. nothing more is written
+    // after that, the ring keeps being drained so the audio thread never waits, and it stays set until the next start
+    bool hasWriteFailed();
+
+    // the most samples that have been waiting in the ring at once since recording started, out of its capacity
+    int getHighWaterMark();
+    int getFifoCapacity();
+
+    // samples that found the ring full, and the blocks they came from
+    juce::int64 getDroppedSamples();
+    int getNumDroppedBlocks();
+
+    static constexpr double defaultFifoSeconds = 10.0;
+    static constexpr int numChannels = 2;
+
+    // how long the writer sleeps when the ring is empty
+    static constexpr int drainInterval = 20;
+
+private:
+    void run() override;
+    void drain();
+
+    juce::AudioFormatManager& formatManager;
+    double fifoSeconds;
+    double sampleRate = 0;
+
+    // the ring is only resized while not recording, when nothing else is using it
+    juce::AudioBuffer<float> ring;
+    juce::AbstractFifo fifo{ 1 };
+
+    // the writer belongs to the background thread, apart from start and stop taking the lock to swap it
+    juce::CriticalSection writerLock;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    juce::File file;
+
+    std::atomic<bool> recording{ false };
+    std::atomic<bool> pushing{ false };
+    std::atomic<juce::int64> recordedSamples{ 0 };
+    std::atomic<bool> writeFailed{ false };
+    std::atomic<int> highWaterMark{ 0 };
+    std::atomic<juce::int64> droppedSamples{ 0 };
+    std::atomic<int> numDroppedBlocks{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MasterRecorder)
+};
\ No newline at end of file
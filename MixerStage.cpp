@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    MixerStage.cpp
+    Created: 17 Oct 2026 5:31:07pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "MixerStage.h"
+
+namespace
+{
+    // how far the crossfader travels from either end before the sharp cut curve fully opens the other side
+    const float sharpCutWidth = 0.05f;
+}
+
+MixerStage::MixerStage(int _maxInputs) :
+                       inputs((size_t) juce::jmax(1, _maxInputs))
+{
+    // decks alternate between the two sides of the crossfader, 1 and 3 on the left, 2 and 4 on the right
+    for (int i = 0; i < getMaxInputs(); ++i)
+    {
+        inputs[(size_t) i].side = (int) (i % 2 == 0 ? CrossfaderSide::left : CrossfaderSide::right);
+    }
+}
+
+MixerStage::~MixerStage()
+{
+
+}
+
+void MixerStage::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    juce::ignoreUnused(sampleRate);
+    rampShape.resize((size_t) samplesPerBlockExpected);
+    gainRamp.resize((size_t) samplesPerBlockExpected);
+    rampLength = 0;
+
+    // jump straight to the current gains when playback starts
+    for (auto& input : inputs)
+    {
+        input.currentGain = -1.0f;
+    }
+}
+
+void MixerStage::process(const juce::AudioBuffer<float>* inputBuffers, int numInputs, const juce::AudioSourceChannelInfo& output)
+{
+    auto& buffer = *output.buffer;
+    int numSamples = output.numSamples;
+
+    output.clearActiveBufferRegion();
+
+    if (numSamples > (int) gainRamp.size())
+    {
+        jassertfalse;
+        return;
+    }
+
+    float position = crossfader;
+    auto curve = (CrossfaderCurve) crossfaderCurve.load();
+    float master = masterGain;
+
+    for (int i = 0; i < juce::jmin(numInputs, getMaxInputs()); ++i)
+    {
+        auto& input = inputs[(size_t) i];
+        auto& source = inputBuffers[i];
+        float targetGain = input.trim * getCrossfaderGain((CrossfaderSide) input.side.load(), position, curve) * master;
+        float startGain = input.currentGain < 0 ? targetGain : input.currentGain;
+        input.currentGain = targetGain;
+
+        if (startGain == targetGain)
+        {
+            if (targetGain == 0)
+            {
+                continue;
+            }
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                juce::FloatVectorOperations::addWithMultiply(buffer.getWritePointer(channel, output.startSample),
+                                                             source.getReadPointer(channel % source.getNumChannels()), targetGain, numSamples);
+            }
+        }
+
+        // ramp a moving gain across the block, still as a multiply-and-add of whole vectors
+        else
+        {
+            updateRamp(numSamples);
+            juce::FloatVectorOperations::copyWithMultiply(gainRamp.data(), rampShape.data(), targetGain - startGain, numSamples);
+            juce::FloatVectorOperations::add(gainRamp.data(), startGain, numSamples);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                juce::FloatVectorOperations::addWithMultiply(buffer.getWritePointer(channel, output.startSample),
+                                                             source.getReadPointer(channel % source.getNumChannels()), gainRamp.data(), numSamples);
+            }
+        }
+    }
+}
+
+void MixerStage::setCrossfader(float position)
+{
+    if (position < 0 || position > 1)
+    {
+        DBG("MixerStage::setCrossfader position should be between 0 and 1");
+    }
+
+    else
+    {
+        crossfader = position;
+    }
+}
+
+float MixerStage::getCrossfader()
+{
+    return crossfader;
+}
+
+void MixerStage::setCrossfaderCurve(CrossfaderCurve curve)
+{
+    crossfaderCurve = (int) curve;
+}
+
+MixerStage::CrossfaderCurve MixerStage::getCrossfaderCurve()
+{
+    return (CrossfaderCurve) crossfaderCurve.load();
+}
+
+void MixerStage::setCrossfaderSide(int input, CrossfaderSide side)
+{
+    if (juce::isPositiveAndBelow(input, getMaxInputs()) == false)
+    {
+        DBG("MixerStage::setCrossfaderSide input should be between 0 and " << getMaxInputs() - 1);
+    }
+
+    else
+    {
+        inputs[(size_t) input].side = (int) side;
+    }
+}
+
+MixerStage::CrossfaderSide MixerStage::getCrossfaderSide(int input)
+{
+    return juce::isPositiveAndBelow(input, getMaxInputs()) ? (CrossfaderSide) inputs[(size_t) input].side.load() : CrossfaderSide::thru;
+}
+
+void MixerStage::setTrim(int input, float gain)
+{
+    if (juce::isPositiveAndBelow(input, getMaxInputs()) == false || gain < 0 || gain > 4)
+    {
+        DBG("MixerStage::setTrim gain should be between 0 and 4 for an existing input");
+    }
+
+    else
+    {
+        inputs[(size_t) input].trim = gain;
+    }
+}
+
+float MixerStage::getTrim(int input)
+{
+    return juce::isPositiveAndBelow(input, getMaxInputs()) ? inputs[(size_t) input].trim.load() : 0.0f;
+}
+
+void MixerStage::setMasterGain(float gain)
+{
+    if (gain < 0 || gain > 2)
+    {
+        DBG("MixerStage::setMasterGain gain should be between 0 and 2");
+    }
+
+    else
+    {
+        masterGain = gain;
+    }
+}
+
+float MixerStage::getMasterGain()
+{
+    return masterGain;
+}
+
+int MixerStage::getMaxInputs()
+{
+    return (int) inputs.size();
+}
+
+// gain of one side of the crossfader, dipless keeps both sides at full level through the centre,
+// constant power dips both by 3 dB there and sharp cut only fades over the last few percent of travel
+float MixerStage::getCrossfaderGain(CrossfaderSide side, float position, CrossfaderCurve curve)
+{
+    if (side == CrossfaderSide::thru)
+    {
+        return 1.0f;
+    }
+
+    float distance = side == CrossfaderSide::left ? 1.0f - position : position;
+
+    switch (curve)
+    {
+        case CrossfaderCurve::dipless:
+            return juce::jmin(1.0f, distance * 2.0f);
+
+        case CrossfaderCurve::constantPower:
+            return std::sin(distance * juce::MathConstants<float>::halfPi);
+
+        case CrossfaderCurve::sharpCut:
+            return juce::jmin(1.0f, distance / sharpCutWidth);
+    }
+
+    return 1.0f;
+}
+
+// the ramp shape only depends on the block length, so it is rebuilt only when that changes
+void MixerStage::updateRamp(int numSamples)
+{
+    if (numSamples == rampLength)
+    {
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        rampShape[(size_t) i] = (float) (i + 1) / (float) numSamples;
+    }
+
+    rampLength = numSamples;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    MixerStage.h
+    Created: 17 Oct 2026 5:31:07pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// sums the decks into the output through a per-deck trim, the crossfader and the master gain, each deck
+// in a single vectorised multiply-and-add pass per channel
+class MixerStage
+{
+public:
+    enum class CrossfaderCurve
+    {
+        dipless,
+        constantPower,
+        sharpCut
+    };
+
+    enum class CrossfaderSide
+    {
+        thru,
+        left,
+        right
+    };
+
+    MixerStage(int _maxInputs);
+    ~MixerStage();
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    // overwrite the output with the mix of the first numInputs buffers, which must hold at least
+    // output.numSamples samples and at most the prepared block size
+    void process(const juce::AudioBuffer<float>* inputs, int numInputs, const juce::AudioSourceChannelInfo& output);
+
+    // 0 is fully on the left side and 1 fully on the right
+    void setCrossfader(float position);
+    float getCrossfader();
+    void setCrossfaderCurve(CrossfaderCurve curve);
+    CrossfaderCurve getCrossfaderCurve();
+
+    void setCrossfaderSide(int input, CrossfaderSide side);
+    CrossfaderSide getCrossfaderSide(int input);
+    void setTrim(int input, float gain);
+    float getTrim(int input);
+
+    void setMasterGain(float gain);
+    float getMasterGain();
+
+    int getMaxInputs();
+
+private:
+    struct Input
+    {
+        std::atomic<float> trim{ 1.0f };
+        std::atomic<int> side{ (int) CrossfaderSide::thru };
+        float currentGain = -1.0f;
+    };
+
+    float getCrossfaderGain(CrossfaderSide side, float position, CrossfaderCurve curve);
+    void updateRamp(int numSamples);
+
+    std::vector<Input> inputs;
+    std::atomic<float> crossfader{ 0.5f };
+    std::atomic<int> crossfaderCurve{ (int) CrossfaderCurve::dipless };
+    std::atomic<float> masterGain{ 1.0f };
+
+    // rampShape rises from just above 0 to 1 over the block, and gainRamp is scaled from it whenever a gain moves
+    std::vector<float> rampShape;
+    std::vector<float> gainRamp;
+    int rampLength = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerStage)
+};
\ No newline at end of file
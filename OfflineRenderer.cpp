@@ -0,0 +1,444 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 17 Oct 2026 7:58:20pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+
+namespace
+{
+    // how many arguments each command takes, deck commands first and then the mixer's
+    struct CommandInfo
+    {
+        const char* name;
+        int numArguments;
+        bool forMixer;
+    };
+
+    const CommandInfo commandInfos[] = { { "load", 1, false }, { "play", 0, false }, { "stop", 0, false }, { "seek", 1, false },
+                                         { "gain", 1, false }, { "speed", 1, false }, { "keylock", 1, false }, { "eq", 2, false },
+                                         { "filter", 1, false }, { "trim", 1, false }, { "grid", 2, false }, { "sync", 1, false },
+                                         { "cue", 2, false }, { "hotcue", 1, false },
+                                         { "crossfader", 1, true }, { "curve", 1, true }, { "master", 1, true } };
+
+    const char* curveNames[] = { "dipless", "smooth", "cut" };
+    const char* bandNames[] = { "low", "mid", "high" };
+
+    bool isNumber(const juce::String& text)
+    {
+        return text.isNotEmpty() && text.containsOnly("0123456789.-+eE");
+    }
+}
+
+OfflineRenderer::OfflineRenderer(double _sampleRate, int _blockSize, int _numRenderThreads) :
+                                 sampleRate(_sampleRate),
+                                 blockSize(_blockSize)
+{
+    formatManager.registerBasicFormats();
+
+    // with nothing to wait for, decks read straight from their files instead of through the read-ahead buffers,
+    // and decode loop and cue seams before the next block rather than whenever the loader gets to them
+    for (int i = 0; i < deckEngine.getMaxDecks(); ++i)
+    {
+        deckEngine.getDeck(i)->setReadAheadSize(0);
+        deckEngine.getDeck(i)->setSeamDecodingSynchronous(true);
+    }
+
+    deckEngine.setRenderThreads(_numRenderThreads);
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+
+}
+
+bool OfflineRenderer::loadScript(const juce::File& script, juce::String& error)
+{
+    if (script.existsAsFile() == false)
+    {
+        error = "cannot read " + script.getFullPathName();
+        return false;
+    }
+
+    juce::StringArray lines;
+    script.readLines(lines);
+
+    scriptDirectory = script.getParentDirectory();
+    events.clear();
+    endTime = -1;
+    int numDecks = 1;
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        juce::String line = lines[i].upToFirstOccurrenceOf("#", false, false).trim();
+
+        if (line.isEmpty())
+        {
+            continue;
+        }
+
+        // quoted arguments keep their spaces, so paths can be written as they are
+        juce::StringArray tokens = juce::StringArray::fromTokens(line, " \t", "\"");
+        tokens.removeEmptyStrings();
+
+        for (auto& token : tokens)
+        {
+            token = token.unquoted();
+        }
+
+        Event event;
+        event.line = i + 1;
+
+        if (parseEvent(tokens, event, error) == false)
+        {
+            error = "line " + juce::String(event.line) + ": " + error;
+            return false;
+        }
+
+        if (event.command == "end")
+        {
+            endTime = event.time;
+        }
+
+        else
+        {
+            numDecks = juce::jmax(numDecks, event.deck + 1);
+            events.push_back(event);
+        }
+    }
+
+    if (endTime < 0)
+    {
+        error = "the script has no end";
+        return false;
+    }
+
+    // events at the same time are applied in the order they were written
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.time < b.time; });
+    deckEngine.setNumDecks(numDecks);
+
+    return true;
+}
+
+bool OfflineRenderer::parseEvent(const juce::StringArray& tokens, Event& event, juce::String& error)
+{
+    if (tokens.size() < 2 || isNumber(tokens[0]) == false || tokens[0].getDoubleValue() < 0)
+    {
+        error = "expected a time in seconds followed by a deck and a command, or end";
+        return false;
+    }
+
+    event.time = tokens[0].getDoubleValue();
+
+    if (tokens[1] == "end" && tokens.size() == 2)
+    {
+        event.command = "end";
+        return true;
+    }
+
+    if (tokens.size() < 3)
+    {
+        error = "expected a command after " + tokens[1];
+        return false;
+    }
+
+    bool forMixer = tokens[1] == "mixer";
+
+    if (forMixer == false)
+    {
+        event.deck = tokens[1].getIntValue() - 1;
+
+        if (tokens[1].containsOnly("0123456789") == false || juce::isPositiveAndBelow(event.deck, deckEngine.getMaxDecks()) == false)
+        {
+            error = "deck should be mixer or between 1 and " + juce::String(deckEngine.getMaxDecks());
+            return false;
+        }
+    }
+
+    event.command = tokens[2];
+    event.arguments = juce::StringArray(tokens.begin() + 3, tokens.size() - 3);
+
+    for (auto& info : commandInfos)
+    {
+        if (event.command != info.name || info.forMixer != forMixer)
+        {
+            continue;
+        }
+
+        if (event.arguments.size() != info.numArguments)
+        {
+            error = event.command + " takes " + juce::String(info.numArguments) + " arguments";
+            return false;
+        }
+
+        // the words each command accepts, and numbers everywhere else
+        if (event.command == "load")
+        {
+            event.arguments.set(0, scriptDirectory.getChildFile(event.arguments[0]).getFullPathName());
+        }
+
+        else if (event.command == "keylock" || event.command == "sync")
+        {
+            if (event.arguments[0] != "on" && event.arguments[0] != "off")
+            {
+                error = event.command + " should be on or off";
+                return false;
+            }
+        }
+
+        else if (event.command == "grid")
+        {
+            if (isNumber(event.arguments[0]) == false || isNumber(event.arguments[1]) == false)
+            {
+                error = "grid should be followed by a bpm and the time of the first beat";
+                return false;
+            }
+        }
+
+        else if (event.command == "cue" || event.command == "hotcue")
+        {
+            int index = event.arguments[0].getIntValue();
+
+            if (isNumber(event.arguments[0]) == false || index < 1 || index > DJAudioPlayer::numHotCues
+                || (event.command == "cue" && isNumber(event.arguments[1]) == false))
+            {
+                error = event.command + " should be followed by a cue from 1 to " + juce::String(DJAudioPlayer::numHotCues)
+                      + (event.command == "cue" ? " and its position" : "");
+                return false;
+            }
+        }
+
+        else if (event.command == "curve")
+        {
+            if (juce::StringArray(curveNames, 3).contains(event.arguments[0]) == false)
+            {
+                error = "curve should be dipless, smooth or cut";
+                return false;
+            }
+        }
+
+        else if (event.command == "eq")
+        {
+            if (juce::StringArray(bandNames, 3).contains(event.arguments[0]) == false || isNumber(event.arguments[1]) == false)
+            {
+                error = "eq should be followed by low, mid or high and a gain";
+                return false;
+            }
+        }
+
+        else if (info.numArguments == 1 && isNumber(event.arguments[0]) == false)
+        {
+            error = event.command + " should be followed by a number";
+            return false;
+        }
+
+        return true;
+    }
+
+    error = "unknown " + juce::String(forMixer ? "mixer" : "deck") + " command " + event.command;
+    return false;
+}
+
+bool OfflineRenderer::render(const juce::File& output, juce::String& error)
+{
+    auto* format = formatManager.findFormatForFileExtension(output.getFileExtension());
+
+    if (format == nullptr || format->canDoStereo() == false)
+    {
+        error = "cannot write " + output.getFileExtension() + " files";
+        return false;
+    }
+
+    output.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream = output.createOutputStream();
+    int bitDepth = format->getPossibleBitDepths().contains(24) ? 24 : 16;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    if (stream != nullptr)
+    {
+        writer.reset(format->createWriterFor(stream.get(), sampleRate, DeckEngine::numDeckChannels, bitDepth, {}, 0));
+    }
+
+    if (writer == nullptr)
+    {
+        error = "cannot write to " + output.getFullPathName();
+        return false;
+    }
+
+    // the writer owns the stream from here on
+    stream.release();
+
+    juce::AudioBuffer<float> buffer(DeckEngine::numDeckChannels, blockSize);
+    juce::int64 totalSamples = (juce::int64) std::llround(endTime * sampleRate);
+    juce::int64 position = 0;
+    size_t nextEvent = 0;
+    bool ok = true;
+
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    deckEngine.prepareToPlay(blockSize, sampleRate);
+
+    while (position < totalSamples && ok)
+    {
+        // apply everything due by now, then render up to the next event so that each lands on its own sample
+        while (nextEvent < events.size() && (juce::int64) std::llround(events[nextEvent].time * sampleRate) <= position)
+        {
+            if (applyEvent(events[nextEvent]) == false)
+            {
+                error = "line " + juce::String(events[nextEvent].line) + ": cannot load " + events[nextEvent].arguments[0];
+                ok = false;
+            }
+
+            nextEvent++;
+        }
+
+        juce::int64 blockEnd = juce::jmin(position + blockSize, totalSamples);
+
+        if (nextEvent < events.size())
+        {
+            blockEnd = juce::jmin(blockEnd, (juce::int64) std::llround(events[nextEvent].time * sampleRate));
+        }
+
+        int numSamples = (int) (blockEnd - position);
+        deckEngine.getNextAudioBlock(juce::AudioSourceChannelInfo(&buffer, 0, numSamples));
+
+        if (writer->writeFromAudioSampleBuffer(buffer, 0, numSamples) == false)
+        {
+            error = "cannot write to " + output.getFullPathName();
+            ok = false;
+        }
+
+        position = blockEnd;
+    }
+
+    deckEngine.releaseResources();
+    writer.reset();
+
+    elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    renderedSeconds = position / sampleRate;
+
+    return ok;
+}
+
+double OfflineRenderer::getRenderedSeconds()
+{
+    return renderedSeconds;
+}
+
+double OfflineRenderer::getElapsedSeconds()
+{
+    return elapsedSeconds;
+}
+
+double OfflineRenderer::getRealtimeFactor()
+{
+    return elapsedSeconds > 0 ? renderedSeconds / elapsedSeconds : 0;
+}
+
+// hand an event to the deck or mixer it is for, through the same calls the GUI makes
+bool OfflineRenderer::applyEvent(const Event& event)
+{
+    const juce::String& command = event.command;
+    double value = event.arguments.size() > 0 ? event.arguments[event.arguments.size() - 1].getDoubleValue() : 0;
+
+    if (event.deck < 0)
+    {
+        auto& mixer = deckEngine.getMixer();
+
+        if (command == "crossfader")
+        {
+            mixer.setCrossfader((float) value);
+        }
+
+        else if (command == "curve")
+        {
+            mixer.setCrossfaderCurve((MixerStage::CrossfaderCurve) juce::StringArray(curveNames, 3).indexOf(event.arguments[0]));
+        }
+
+        else if (command == "master")
+        {
+            mixer.setMasterGain((float) value);
+        }
+
+        return true;
+    }
+
+    auto* player = deckEngine.getDeck(event.deck);
+
+    if (command == "load")
+    {
+        player->stop();
+        return player->loadURL(juce::URL(juce::File(event.arguments[0])));
+    }
+
+    if (command == "play")
+    {
+        player->start();
+    }
+
+    else if (command == "stop")
+    {
+        player->stop();
+    }
+
+    else if (command == "seek")
+    {
+        player->setPosition(value);
+    }
+
+    else if (command == "gain")
+    {
+        player->setGain(value);
+    }
+
+    else if (command == "speed")
+    {
+        player->setSpeed(value);
+    }
+
+    else if (command == "keylock")
+    {
+        player->setKeylock(event.arguments[0] == "on");
+    }
+
+    else if (command == "eq")
+    {
+        player->setEqGain((DeckEqualiser::Band) juce::StringArray(bandNames, 3).indexOf(event.arguments[0]), value);
+    }
+
+    else if (command == "filter")
+    {
+        player->setFilter(value);
+    }
+
+    else if (command == "trim")
+    {
+        deckEngine.getMixer().setTrim(event.deck, (float) value);
+    }
+
+    else if (command == "grid")
+    {
+        player->setBeatGrid(event.arguments[0].getDoubleValue(), value);
+    }
+
+    else if (command == "sync")
+    {
+        player->setSyncEnabled(event.arguments[0] == "on");
+    }
+
+    else if (command == "cue")
+    {
+        player->setHotCue(event.arguments[0].getIntValue() - 1, value);
+    }
+
+    else if (command == "hotcue")
+    {
+        player->triggerHotCue(event.arguments[0].getIntValue() - 1);
+    }
+
+    return true;
+}
\ No newline at end of file
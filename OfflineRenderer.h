@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+    Created: 17 Oct 2026 7:58:20pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DeckEngine.h"
+
+// renders a scripted session through the same decks and mixer as the app, without an audio device and as
+// fast as the CPU allows, into any file format the format manager can write such as WAV or FLAC
+//
+// each line of the script is "<seconds> <deck> <command> [arguments]", where deck is 1 to 8 or "mixer",
+// or "<seconds> end" to set where the render stops, and # starts a comment:
+//
+//     0     1      load "tracks/first track.mp3"
+//     0     1      play
+//     30.5  1      seek 60
+//     32    1      eq low 0
+//     40    mixer  crossfader 0.25
+//     180   end
+//
+// decks take load, play, stop, seek, gain, speed, keylock on/off, eq low/mid/high, filter, trim,
+// grid <bpm> <first beat>, sync on/off, cue <1 to 8> <seconds> to set a hot cue and hotcue <1 to 8> to jump to one,
+// the mixer takes crossfader, curve dipless/smooth/cut and master
+class OfflineRenderer
+{
+public:
+    OfflineRenderer(double _sampleRate, int _blockSize, int _numRenderThreads);
+    ~OfflineRenderer();
+
+    // read a timeline script, relative paths being relative to the script, returns false with a
+    // message naming the offending line if it cannot be used
+    bool loadScript(const juce::File& script, juce::String& error);
+
+    // render the whole timeline into the output file, returns false with a message if it cannot be written
+    bool render(const juce::File& output, juce::String& error);
+
+    double getRenderedSeconds();
+    double getElapsedSeconds();
+
+    // seconds of audio rendered per second of wall-clock time
+    double getRealtimeFactor();
+
+private:
+    struct Event
+    {
+        double time = 0;
+        int deck = -1;
+        juce::String command;
+        juce::StringArray arguments;
+        int line = 0;
+    };
+
+    bool parseEvent(const juce::StringArray& tokens, Event& event, juce::String& error);
+    bool applyEvent(const Event& event);
+
+    juce::AudioFormatManager formatManager;
+    DeckEngine deckEngine{ formatManager };
+    double sampleRate;
+    int blockSize;
+
+    std::vector<Event> events;
+    juce::File scriptDirectory;
+    double endTime = -1;
+
+    double renderedSeconds = 0;
+    double elapsedSeconds = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
\ No newline at end of file
@@ -0,0 +1,344 @@
+/*
+  ==============================================================================
+
+    PolyphaseResampler.cpp
+    Created: 17 Oct 2026 11:47:05am
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "PolyphaseResampler.h"
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+ #define OTODECKS_RESAMPLER_AVX 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define OTODECKS_RESAMPLER_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+ #include <arm_neon.h>
+ #define OTODECKS_RESAMPLER_NEON 1
+#endif
+
+namespace
+{
+    const int maxTaps = 32;
+
+    // dot product of a filter phase with the input, numTaps is always a multiple of 8
+    inline float dotProduct(const float* samples, const float* coefficients, int numTaps)
+    {
+       #if OTODECKS_RESAMPLER_AVX
+        __m256 sum = _mm256_setzero_ps();
+
+        for (int i = 0; i < numTaps; i += 8)
+        {
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(samples + i), _mm256_loadu_ps(coefficients + i)));
+        }
+
+        __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+        half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+        half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+        return _mm_cvtss_f32(half);
+       #elif OTODECKS_RESAMPLER_SSE
+        __m128 sum = _mm_setzero_ps();
+
+        for (int i = 0; i < numTaps; i += 4)
+        {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(samples + i), _mm_loadu_ps(coefficients + i)));
+        }
+
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+       #elif OTODECKS_RESAMPLER_NEON
+        float32x4_t sum = vdupq_n_f32(0.0f);
+
+        for (int i = 0; i < numTaps; i += 4)
+        {
+            sum = vmlaq_f32(sum, vld1q_f32(samples + i), vld1q_f32(coefficients + i));
+        }
+
+        float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+        return vget_lane_f32(vpadd_f32(half, half), 0);
+       #else
+        float sum = 0.0f;
+
+        for (int i = 0; i < numTaps; ++i)
+        {
+            sum += samples[i] * coefficients[i];
+        }
+
+        return sum;
+       #endif
+    }
+
+    // zeroth order modified Bessel function, used by the Kaiser window
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+
+            if (term < sum * 1.0e-12)
+            {
+                break;
+            }
+        }
+
+        return sum;
+    }
+}
+
+PolyphaseResampler::PolyphaseResampler(juce::AudioSource* _input, bool _deleteInputWhenDeleted, int _numChannels) :
+                                       input(_input, _deleteInputWhenDeleted),
+                                       numChannels(_numChannels)
+{
+    jassert(input != nullptr);
+}
+
+PolyphaseResampler::~PolyphaseResampler()
+{
+
+}
+
+void PolyphaseResampler::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    // every tier and band is ready before audio runs, so nothing is built or allocated while playing
+    tableSet = &getTableSet();
+
+    maxOutputChunk = juce::jmax(1, samplesPerBlockExpected);
+    inputBuffer.setSize(numChannels, (int) std::ceil(maxOutputChunk * maxRatio) + maxTaps * 2 + 2);
+    historyTaps = maxTaps / 2 - 1;
+    currentRatio = targetRatio;
+    clearHistory();
+
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void PolyphaseResampler::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (flushRequested.exchange(false))
+    {
+        clearHistory();
+    }
+
+    // ramp the ratio from the previous block's value to the new target across this block
+    double endRatio = juce::jlimit(1.0 / maxRatio, maxRatio, targetRatio.load());
+    double ratioIncrement = (endRatio - currentRatio) / juce::jmax(1, bufferToFill.numSamples);
+
+    for (int done = 0; done < bufferToFill.numSamples;)
+    {
+        int numThisTime = juce::jmin(maxOutputChunk, bufferToFill.numSamples - done);
+        render(bufferToFill, bufferToFill.startSample + done, numThisTime, currentRatio, ratioIncrement);
+        currentRatio += ratioIncrement * numThisTime;
+        done += numThisTime;
+    }
+
+    currentRatio = endRatio;
+
+    for (int channel = numChannels; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+    {
+        bufferToFill.buffer->clear(channel, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+}
+
+void PolyphaseResampler::releaseResources()
+{
+    input->releaseResources();
+    inputBuffer.setSize(numChannels, 0);
+}
+
+void PolyphaseResampler::setResamplingRatio(double ratio)
+{
+    jassert(ratio > 0);
+    targetRatio = juce::jmax(0.0, ratio);
+}
+
+double PolyphaseResampler::getResamplingRatio()
+{
+    return targetRatio;
+}
+
+void PolyphaseResampler::setQuality(Quality newQuality)
+{
+    quality = (int) newQuality;
+}
+
+PolyphaseResampler::Quality PolyphaseResampler::getQuality()
+{
+    return (Quality) quality.load();
+}
+
+void PolyphaseResampler::flushBuffers()
+{
+    flushRequested = true;
+}
+
+int PolyphaseResampler::getNumTaps(Quality quality)
+{
+    switch (quality)
+    {
+        case Quality::low:    return 8;
+        case Quality::medium: return 16;
+        case Quality::high:   return maxTaps;
+    }
+
+    return 16;
+}
+
+// build a Kaiser-windowed sinc with numPhases + 1 fractional offsets so neighbouring phases can be interpolated
+void PolyphaseResampler::buildTable(FilterTable& table, int numTaps, double cutoff, double beta)
+{
+    table.numTaps = numTaps;
+    table.coefficients.assign((size_t) ((numPhases + 1) * numTaps), 0.0f);
+
+    double halfWidth = numTaps / 2;
+    double windowNorm = besselI0(beta);
+
+    for (int phase = 0; phase <= numPhases; ++phase)
+    {
+        double offset = (double) phase / numPhases;
+        float* coefficients = table.coefficients.data() + phase * numTaps;
+        double sum = 0;
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            // distance of this tap's input sample from the output point
+            double t = (tap - halfWidth + 1) - offset;
+            double x = juce::MathConstants<double>::pi * cutoff * t;
+            double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(x) / x;
+            double w = t / halfWidth;
+            double window = std::abs(w) >= 1.0 ? 0.0 : besselI0(beta * std::sqrt(1.0 - w * w)) / windowNorm;
+
+            coefficients[tap] = (float) (sinc * window);
+            sum += coefficients[tap];
+        }
+
+        // normalise each phase to unity gain at DC
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            coefficients[tap] = (float) (coefficients[tap] / sum);
+        }
+    }
+}
+
+// built once on first use and shared by every resampler, leaving some transition band below the cutoff of each band
+const PolyphaseResampler::TableSet& PolyphaseResampler::getTableSet()
+{
+    static const TableSet tableSet = []
+    {
+        TableSet set;
+        const Quality qualities[] = { Quality::low, Quality::medium, Quality::high };
+        const double kaiserBetas[] = { 5.0, 7.0, 9.0 };
+
+        for (int tier = 0; tier < 3; ++tier)
+        {
+            for (int band = 0; band < numBands; ++band)
+            {
+                buildTable(set.tables[tier][band], getNumTaps(qualities[tier]), 0.92 / getBandRatio(band), kaiserBetas[tier]);
+            }
+        }
+
+        return set;
+    }();
+
+    return tableSet;
+}
+
+double PolyphaseResampler::getBandRatio(int band)
+{
+    return std::pow(bandStep, band);
+}
+
+// the band at or just above the ratio, so the cutoff is never higher than 0.92 / ratio and at most one step lower
+const PolyphaseResampler::FilterTable& PolyphaseResampler::chooseTable(double ratio) const
+{
+    int band = 0;
+
+    if (ratio > 1.0)
+    {
+        band = juce::jlimit(0, numBands - 1, (int) std::ceil(std::log(ratio) / std::log(bandStep) - 1.0e-9));
+    }
+
+    return tableSet->tables[quality.load()][band];
+}
+
+void PolyphaseResampler::clearHistory()
+{
+    inputBuffer.clear();
+    numBuffered = historyTaps;
+    position = historyTaps;
+}
+
+void PolyphaseResampler::render(const juce::AudioSourceChannelInfo& bufferToFill, int startSample, int numSamples,
+                                double startRatio, double ratioIncrement)
+{
+    // pull enough input to cover the last output sample plus half a filter of look-ahead
+    double endPosition = position + numSamples * (startRatio + ratioIncrement * numSamples * 0.5);
+    int numNeeded = juce::jmin(inputBuffer.getNumSamples(), (int) std::floor(endPosition) + maxTaps / 2 + 1);
+
+    if (numNeeded > numBuffered)
+    {
+        juce::AudioSourceChannelInfo inputInfo(&inputBuffer, numBuffered, numNeeded - numBuffered);
+        input->getNextAudioBlock(inputInfo);
+        numBuffered = numNeeded;
+    }
+
+    const FilterTable& table = chooseTable(juce::jmax(startRatio, startRatio + ratioIncrement * numSamples));
+    const int numTaps = table.numTaps;
+    const int numOutputChannels = juce::jmin(numChannels, bufferToFill.buffer->getNumChannels());
+
+    double pos = position;
+
+    for (int channel = 0; channel < numOutputChannels; ++channel)
+    {
+        float* output = bufferToFill.buffer->getWritePointer(channel, startSample);
+        double ratio = startRatio;
+        pos = position;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            int index = (int) pos;
+            double fraction = (pos - index) * numPhases;
+            int phase = (int) fraction;
+            float phaseFraction = (float) (fraction - phase);
+            int firstTap = juce::jmin(index - numTaps / 2 + 1, numBuffered - numTaps);
+
+            // interpolate between the two nearest filter phases
+            const float* samples = inputBuffer.getReadPointer(channel, firstTap);
+            float a = dotProduct(samples, table.getPhase(phase), numTaps);
+            float b = dotProduct(samples, table.getPhase(phase + 1), numTaps);
+            output[i] = a + (b - a) * phaseFraction;
+
+            pos += ratio;
+            ratio += ratioIncrement;
+        }
+    }
+
+    if (numOutputChannels == 0)
+    {
+        pos = position + numSamples * startRatio + ratioIncrement * numSamples * (numSamples - 1) * 0.5;
+    }
+
+    // drop the input that no later output sample can reach, keeping the filter history
+    int numToDiscard = juce::jlimit(0, numBuffered, (int) pos - historyTaps);
+
+    if (numToDiscard > 0)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* data = inputBuffer.getWritePointer(channel);
+            std::memmove(data, data + numToDiscard, sizeof(float) * (size_t) (numBuffered - numToDiscard));
+        }
+
+        numBuffered -= numToDiscard;
+        pos -= numToDiscard;
+    }
+
+    position = pos;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    PolyphaseResampler.h
+    Created: 17 Oct 2026 11:47:05am
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class PolyphaseResampler : public juce::AudioSource
+{
+public:
+    enum class Quality
+    {
+        low,
+        medium,
+        high
+    };
+
+    PolyphaseResampler(juce::AudioSource* _input, bool _deleteInputWhenDeleted, int _numChannels = 2);
+    ~PolyphaseResampler() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    // number of input samples consumed per output sample, changes are ramped across the next block
+    void setResamplingRatio(double ratio);
+    double getResamplingRatio();
+
+    // every tier is built in prepareToPlay, so switching is safe while playing
+    void setQuality(Quality quality);
+    Quality getQuality();
+
+    // forget the samples held for interpolation, e.g. after the input has been repositioned
+    void flushBuffers();
+
+    static int getNumTaps(Quality quality);
+
+    static constexpr int numPhases = 256;
+    static constexpr double maxRatio = 8.0;
+
+    // the cutoff bands are bandStep apart from a ratio of 1 up to maxRatio, and the band at or just above the
+    // ratio is used, so speeding up lowers the cutoff instead of aliasing and a small nudge only moves it a little
+    static constexpr double bandStep = 1.05;
+    static constexpr int numBands = 44;
+
+private:
+    struct FilterTable
+    {
+        int numTaps = 0;
+        std::vector<float> coefficients;
+
+        const float* getPhase(int phase) const { return coefficients.data() + phase * numTaps; }
+    };
+
+    // one table per quality tier and per cutoff band, every resampler reads the same tables
+    struct TableSet
+    {
+        FilterTable tables[3][numBands];
+    };
+
+    static void buildTable(FilterTable& table, int numTaps, double cutoff, double beta);
+    static const TableSet& getTableSet();
+    static double getBandRatio(int band);
+    const FilterTable& chooseTable(double ratio) const;
+    void clearHistory();
+    void render(const juce::AudioSourceChannelInfo& bufferToFill, int startSample, int numSamples,
+                double startRatio, double ratioIncrement);
+
+    juce::OptionalScopedPointer<juce::AudioSource> input;
+    int numChannels;
+    std::atomic<double> targetRatio{ 1.0 };
+    double currentRatio = 1.0;
+    std::atomic<int> quality{ (int) Quality::medium };
+    std::atomic<bool> flushRequested{ false };
+
+    const TableSet* tableSet = nullptr;
+
+    juce::AudioBuffer<float> inputBuffer;
+    int numBuffered = 0;
+    double position = 0;
+    int maxOutputChunk = 0;
+    int historyTaps = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolyphaseResampler)
+};
\ No newline at end of file
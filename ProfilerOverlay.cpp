@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    ProfilerOverlay.cpp
+    Created: 17 Oct 2026 7:26:15pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "ProfilerOverlay.h"
+
+ProfilerOverlay::ProfilerOverlay(CallbackProfiler& _profiler, int _numDecks) :
+                                 profiler(_profiler),
+                                 numDecks(_numDecks)
+{
+    setInterceptsMouseClicks(true, false);
+}
+
+ProfilerOverlay::~ProfilerOverlay()
+{
+
+}
+
+void ProfilerOverlay::paint(juce::Graphics& g)
+{
+    // set translucent background colour
+    g.fillAll(juce::Colour(35, 47, 52).withAlpha(0.9f));
+
+    // draw border around overlay
+    g.setColour(juce::Colours::grey);
+    g.drawRect(getLocalBounds(), 1);
+
+    auto area = getLocalBounds().reduced(8);
+    int lineH = 16;
+
+    // display the load of the callback and the deadlines it missed
+    g.setColour(juce::Colours::white);
+    g.setFont(14);
+    g.drawText("CPU " + juce::String(juce::roundToInt(profiler.getLastLoad() * 100)) + "%   AVG "
+               + juce::String(juce::roundToInt(profiler.getAverageLoad() * 100)) + "%   PEAK "
+               + juce::String(juce::roundToInt(profiler.getPeakLoad() * 100)) + "%",
+               area.removeFromTop(lineH), juce::Justification::centredLeft, true);
+    g.drawText("MISSED " + juce::String(profiler.getNumDeadlineMisses()) + "   XRUNS " + juce::String(profiler.getNumXruns())
+               + "   BLOCKS " + juce::String(profiler.getNumCallbacks()),
+               area.removeFromTop(lineH), juce::Justification::centredLeft, true);
+
+    // display each deck's share of the block as a bar, with its peak as a tick
+    area.removeFromTop(4);
+
+    for (int i = 0; i < numDecks; ++i)
+    {
+        auto row = area.removeFromTop(lineH);
+        g.setColour(juce::Colours::white);
+        g.drawText("DECK " + juce::String(i + 1), row.removeFromLeft(60), juce::Justification::centredLeft, true);
+
+        auto bar = row.reduced(0, 4);
+        g.setColour(juce::Colour(93, 96, 107));
+        g.fillRect(bar);
+        g.setColour(juce::Colour(8, 227, 169));
+        g.fillRect(bar.withWidth((int) (bar.getWidth() * juce::jmin(1.0f, profiler.getDeckLoad(i)))));
+        g.setColour(juce::Colours::white);
+        g.fillRect(bar.getX() + (int) (bar.getWidth() * juce::jmin(1.0f, profiler.getDeckPeakLoad(i))), bar.getY(), 2, bar.getHeight());
+    }
+
+    // draw the histogram of loads on a log scale, with the bins past the deadline in red
+    area.removeFromTop(4);
+    auto histogramArea = area.removeFromTop(area.getHeight() - lineH);
+    int maxCount = 1;
+
+    for (int bin = 0; bin < CallbackProfiler::numHistogramBins; ++bin)
+    {
+        maxCount = juce::jmax(maxCount, profiler.getHistogramCount(bin));
+    }
+
+    float binW = (float) histogramArea.getWidth() / CallbackProfiler::numHistogramBins;
+
+    for (int bin = 0; bin < CallbackProfiler::numHistogramBins; ++bin)
+    {
+        int count = profiler.getHistogramCount(bin);
+        float barH = count > 0 ? histogramArea.getHeight() * std::log10(1.0f + count) / std::log10(1.0f + maxCount) : 0.0f;
+        g.setColour(bin * CallbackProfiler::binWidth >= 1.0f ? juce::Colours::red : juce::Colour(167, 172, 174));
+        g.fillRect(histogramArea.getX() + bin * binW, histogramArea.getBottom() - barH, binW - 1, barH);
+    }
+
+    g.setColour(juce::Colours::grey);
+    g.setFont(12);
+    g.drawText("0%", area, juce::Justification::centredLeft, true);
+    g.drawText("100%", area, juce::Justification::centred, true);
+    g.drawText("200%+", area, juce::Justification::centredRight, true);
+}
+
+void ProfilerOverlay::mouseDown(const juce::MouseEvent& event)
+{
+    // click the overlay to start measuring peaks again
+    profiler.resetPeaks();
+    repaint();
+}
+
+void ProfilerOverlay::visibilityChanged()
+{
+    // only refresh while showing
+    if (isVisible())
+    {
+        startTimerHz(10);
+    }
+
+    else
+    {
+        stopTimer();
+    }
+}
+
+void ProfilerOverlay::timerCallback()
+{
+    repaint();
+}
\ No newline at end of file
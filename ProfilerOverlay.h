@@ -0,0 +1,35 @@
+/*
+  ==============================================================================
+
+    ProfilerOverlay.h
+    Created: 17 Oct 2026 7:26:15pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CallbackProfiler.h"
+
+// panel drawn over the main window showing the audio callback's load, its histogram and each deck's share
+class ProfilerOverlay : public juce::Component,
+                        public juce::Timer
+{
+public:
+    ProfilerOverlay(CallbackProfiler& _profiler, int _numDecks);
+    ~ProfilerOverlay() override;
+
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent& event) override;
+    void visibilityChanged() override;
+
+    void timerCallback() override;
+
+private:
+    CallbackProfiler& profiler;
+    int numDecks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
\ No newline at end of file
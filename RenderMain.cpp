@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    RenderMain.cpp
+    Created: 17 Oct 2026 11:59:52pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+#include <iostream>
+
+// renders a timeline script, see OfflineRenderer.h, into --output=mix.wav (or .flac) without a window or an audio
+// device, at --sample-rate=44100 in blocks of --block-size=512, with the decks rendered on --render-threads=N
+// worker threads as well as this one. the output defaults to the script's name with .wav, and the exit code is
+// 1 if the script cannot be read or the file cannot be written
+int main(int argc, char* argv[])
+{
+    // decks hand loaded tracks over on the message thread, so there needs to be one even with nothing to show
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::String scriptPath;
+    juce::String outputPath;
+    double sampleRate = 44100;
+    int blockSize = 512;
+    int numRenderThreads = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String argument(argv[i]);
+
+        if (argument.startsWith("--output="))
+        {
+            outputPath = argument.fromFirstOccurrenceOf("=", false, false).unquoted();
+        }
+
+        else if (argument.startsWith("--sample-rate="))
+        {
+            sampleRate = juce::jlimit(8000.0, 384000.0, argument.fromFirstOccurrenceOf("=", false, false).getDoubleValue());
+        }
+
+        else if (argument.startsWith("--block-size="))
+        {
+            blockSize = juce::jlimit(16, 8192, argument.fromFirstOccurrenceOf("=", false, false).getIntValue());
+        }
+
+        else if (argument.startsWith("--render-threads="))
+        {
+            numRenderThreads = juce::jlimit(0, juce::SystemStats::getNumCpus(), argument.fromFirstOccurrenceOf("=", false, false).getIntValue());
+        }
+
+        else if (argument.startsWith("--") == false)
+        {
+            scriptPath = argument.unquoted();
+        }
+    }
+
+    if (scriptPath.isEmpty())
+    {
+        std::cerr << "usage: otodecks-render script.txt [--output=mix.wav] [--sample-rate=44100] [--block-size=512] [--render-threads=0]" << std::endl;
+        return 1;
+    }
+
+    juce::File script = juce::File::getCurrentWorkingDirectory().getChildFile(scriptPath);
+    juce::File output = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath.isNotEmpty() ? outputPath : script.getFileNameWithoutExtension() + ".wav");
+    OfflineRenderer renderer(sampleRate, blockSize, numRenderThreads);
+    juce::String error;
+
+    if (renderer.loadScript(script, error) == false || renderer.render(output, error) == false)
+    {
+        std::cerr << "otodecks-render: " << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "rendered " << renderer.getRenderedSeconds() << " s to " << output.getFullPathName() << " in "
+              << renderer.getElapsedSeconds() << " s, " << renderer.getRealtimeFactor() << "x real time" << std::endl;
+    return 0;
+}
\ No newline at end of file
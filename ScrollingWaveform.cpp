@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    ScrollingWaveform.cpp
+    Created: 17 Oct 2026 11:34:52pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "ScrollingWaveform.h"
+
+ScrollingWaveform::ScrollingWaveform(DJAudioPlayer* _player) :
+                                     player(_player)
+{
+    setOpaque(true);
+}
+
+ScrollingWaveform::~ScrollingWaveform()
+{
+
+}
+
+void ScrollingWaveform::paint(juce::Graphics& g)
+{
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+    if (renderer.getPyramid() == nullptr || renderer.getImage().isNull())
+    {
+        // set background colour and draw border
+        g.fillAll(juce::Colour(35, 47, 52));
+        g.setColour(juce::Colours::grey);
+        g.drawRect(getLocalBounds(), 1);
+        return;
+    }
+
+    renderer.draw(g, getLocalBounds());
+
+    double paintMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    averagePaintMs += (paintMs - averagePaintMs) * 0.05;
+}
+
+// the image is drawn again at the new size on the next frame
+void ScrollingWaveform::resized()
+{
+    renderer.invalidate();
+}
+
+void ScrollingWaveform::setPyramid(std::shared_ptr<WaveformPyramid> newPyramid)
+{
+    renderer.setPyramid(newPyramid);
+    lastRawPosition = -1;
+    repaint();
+}
+
+void ScrollingWaveform::setBeatGrid(double bpm, double firstBeat)
+{
+    renderer.setBeatGrid(bpm, firstBeat);
+}
+
+void ScrollingWaveform::setVisibleSeconds(double seconds)
+{
+    renderer.setVisibleSeconds(seconds);
+}
+
+double ScrollingWaveform::getVisibleSeconds()
+{
+    return renderer.getVisibleSeconds();
+}
+
+void ScrollingWaveform::renderFrame(double positionInSecs, float scale)
+{
+    renderer.renderFrame(positionInSecs, getWidth(), getHeight(), scale);
+}
+
+const juce::Image& ScrollingWaveform::getImage()
+{
+    return renderer.getImage();
+}
+
+double ScrollingWaveform::getAverageFrameMs()
+{
+    return renderer.getAverageRenderMs() + averagePaintMs;
+}
+
+juce::int64 ScrollingWaveform::getNumColumnsDrawn()
+{
+    return renderer.getNumColumnsDrawn();
+}
+
+int ScrollingWaveform::getNumFullRedraws()
+{
+    return renderer.getNumFullRedraws();
+}
+
+// called before each refresh of the display
+void ScrollingWaveform::onVBlank()
+{
+    if (player == nullptr || renderer.getPyramid() == nullptr || isShowing() == false)
+    {
+        return;
+    }
+
+    double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    double position = getSmoothedPosition(now);
+
+    // nothing moved by a whole column, so there is nothing to paint
+    if (renderer.renderFrame(position, getWidth(), getHeight(), (float) juce::Component::getApproximateScaleFactorForComponent(this)))
+    {
+        repaint();
+    }
+}
+
+// follow the player's position, which only changes once per audio block, with a clock that runs smoothly between
+double ScrollingWaveform::getSmoothedPosition(double now)
+{
+    double raw = player->getPosition();
+    double frameTime = juce::jlimit(0.0, 0.1, now - lastFrameTime);
+    lastFrameTime = now;
+
+    if (lastRawPosition < 0 || player->isPlaying() == false)
+    {
+        lastRawPosition = raw;
+        lastRawTime = now;
+        displayedPosition = raw;
+        positionRate = 0;
+        return displayedPosition;
+    }
+
+    if (raw != lastRawPosition)
+    {
+        double elapsed = now - lastRawTime;
+        double rate = elapsed > 0 ? (raw - lastRawPosition) / elapsed : 0;
+
+        // a jump such as a seek, a hot cue or a loop wrapping leaves the rate alone and is followed straight away
+        if (rate < 0 || rate > 4)
+        {
+            displayedPosition = raw;
+        }
+
+        else
+        {
+            positionRate += (rate - positionRate) * (positionRate == 0 ? 1.0 : 0.2);
+        }
+
+        lastRawPosition = raw;
+        lastRawTime = now;
+    }
+
+    // run on at the rate the position has been moving at, and take a fifth of the distance to where the player
+    // would be by now each frame, so that block-sized steps never show
+    double expected = lastRawPosition + positionRate * (now - lastRawTime);
+    displayedPosition += positionRate * frameTime;
+    displayedPosition += (expected - displayedPosition) * 0.2;
+
+    if (std::abs(expected - displayedPosition) > 0.25)
+    {
+        displayedPosition = expected;
+    }
+
+    return displayedPosition;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    ScrollingWaveform.h
+    Created: 17 Oct 2026 11:34:52pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "ScrollingWaveformRenderer.h"
+
+// a few seconds of the track around the playhead, with the beat grid, scrolled on every refresh of the display.
+// the image is kept and scrolled by a ScrollingWaveformRenderer, this follows the player and paints it
+class ScrollingWaveform : public juce::Component
+{
+public:
+    ScrollingWaveform(DJAudioPlayer* _player);
+    ~ScrollingWaveform() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    // the pyramid of the loaded track, nullptr while there is none
+    void setPyramid(std::shared_ptr<WaveformPyramid> newPyramid);
+
+    // a bpm of 0 clears the grid
+    void setBeatGrid(double bpm, double firstBeat);
+
+    void setVisibleSeconds(double seconds);
+    double getVisibleSeconds();
+
+    // bring the image up to date with the position at its centre, scrolling what is already drawn and drawing
+    // only the columns that come into view, at scale physical pixels per logical one
+    void renderFrame(double positionInSecs, float scale);
+    const juce::Image& getImage();
+
+    // how long a frame takes to render and paint on average, and how many columns and whole images have been drawn
+    double getAverageFrameMs();
+    juce::int64 getNumColumnsDrawn();
+    int getNumFullRedraws();
+
+private:
+    void onVBlank();
+    double getSmoothedPosition(double now);
+
+    DJAudioPlayer* player;
+    ScrollingWaveformRenderer renderer;
+
+    // the player's position only moves once per audio block, so it is followed by a clock that runs at the
+    // rate the position has been seen to move at, and pulled gently back to it
+    double lastRawPosition = -1;
+    double lastRawTime = 0;
+    double displayedPosition = 0;
+    double lastFrameTime = 0;
+    double positionRate = 0;
+
+    double averagePaintMs = 0;
+
+    juce::VBlankAttachment vBlankAttachment{ this, [this] { onVBlank(); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScrollingWaveform)
+};
\ No newline at end of file
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    ScrollingWaveformRenderer.cpp
+    Created: 17 Oct 2026 11:58:14pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "ScrollingWaveformRenderer.h"
+
+ScrollingWaveformRenderer::ScrollingWaveformRenderer()
+{
+
+}
+
+ScrollingWaveformRenderer::~ScrollingWaveformRenderer()
+{
+
+}
+
+void ScrollingWaveformRenderer::setPyramid(std::shared_ptr<WaveformPyramid> newPyramid)
+{
+    pyramid = newPyramid;
+    imageValid = false;
+}
+
+std::shared_ptr<WaveformPyramid> ScrollingWaveformRenderer::getPyramid()
+{
+    return pyramid;
+}
+
+void ScrollingWaveformRenderer::setBeatGrid(double bpm, double firstBeat)
+{
+    if (bpm < 0)
+    {
+        DBG("ScrollingWaveformRenderer::setBeatGrid bpm should not be negative");
+        return;
+    }
+
+    gridBpm = bpm;
+    gridFirstBeat = firstBeat;
+    imageValid = false;
+}
+
+void ScrollingWaveformRenderer::setVisibleSeconds(double seconds)
+{
+    if (seconds <= 0)
+    {
+        DBG("ScrollingWaveformRenderer::setVisibleSeconds seconds should be positive");
+        return;
+    }
+
+    visibleSeconds = seconds;
+    imageValid = false;
+}
+
+double ScrollingWaveformRenderer::getVisibleSeconds()
+{
+    return visibleSeconds;
+}
+
+void ScrollingWaveformRenderer::invalidate()
+{
+    imageValid = false;
+}
+
+bool ScrollingWaveformRenderer::renderFrame(double positionInSecs, int viewWidth, int viewHeight, float scale)
+{
+    if (pyramid == nullptr || viewWidth <= 0 || viewHeight <= 0)
+    {
+        return false;
+    }
+
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+    int width = juce::jmax(1, juce::roundToInt(viewWidth * scale));
+    int height = juce::jmax(1, juce::roundToInt(viewHeight * scale));
+    juce::int64 newSamplesPerPixel = juce::jmax((juce::int64) 1, (juce::int64) std::round(visibleSeconds * pyramid->getSampleRate() / width));
+
+    if (image.getWidth() != width || image.getHeight() != height || scale != imageScale || newSamplesPerPixel != samplesPerPixel)
+    {
+        image = juce::Image(juce::Image::RGB, width, height, false);
+        imageScale = scale;
+        samplesPerPixel = newSamplesPerPixel;
+        imageValid = false;
+    }
+
+    // the column under the playhead sits in the middle of the image
+    juce::int64 positionColumn = (juce::int64) std::floor(positionInSecs * pyramid->getSampleRate() / samplesPerPixel);
+    juce::int64 newStartColumn = positionColumn - width / 2;
+    juce::int64 shift = newStartColumn - imageStartColumn;
+    bool changed = imageValid == false || shift != 0;
+
+    // each Graphics is made only once the image has been moved and only around the drawing, since a context
+    // open on the image can hold its pixels in a copy that moveImageSection would not see
+
+    if (imageValid == false || std::abs(shift) >= width)
+    {
+        imageStartColumn = newStartColumn;
+        juce::Graphics g(image);
+        drawColumns(g, 0, width);
+        numFullRedraws++;
+        imageValid = true;
+    }
+
+    // move what is already drawn sideways, then draw the columns that were scrolled into view
+    else if (shift > 0)
+    {
+        image.moveImageSection(0, 0, (int) shift, 0, width - (int) shift, height);
+        imageStartColumn = newStartColumn;
+        juce::Graphics g(image);
+        drawColumns(g, width - (int) shift, width);
+    }
+
+    else if (shift < 0)
+    {
+        image.moveImageSection((int) -shift, 0, 0, 0, width + (int) shift, height);
+        imageStartColumn = newStartColumn;
+        juce::Graphics g(image);
+        drawColumns(g, 0, (int) -shift);
+    }
+
+    double renderMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    averageRenderMs += (renderMs - averageRenderMs) * 0.05;
+
+    return changed;
+}
+
+const juce::Image& ScrollingWaveformRenderer::getImage()
+{
+    return image;
+}
+
+void ScrollingWaveformRenderer::draw(juce::Graphics& g, juce::Rectangle<int> bounds)
+{
+    // the image is already at the physical size, so this is a straight copy
+    g.drawImage(image, bounds.toFloat());
+
+    // draw the playhead down the centre
+    g.setColour(juce::Colours::white);
+    g.fillRect(bounds.getCentreX() - 1, bounds.getY(), 2, bounds.getHeight());
+}
+
+double ScrollingWaveformRenderer::getAverageRenderMs()
+{
+    return averageRenderMs;
+}
+
+juce::int64 ScrollingWaveformRenderer::getNumColumnsDrawn()
+{
+    return numColumnsDrawn;
+}
+
+int ScrollingWaveformRenderer::getNumFullRedraws()
+{
+    return numFullRedraws;
+}
+
+// draw the columns from startX up to endX of the image, with the beats of the grid that fall in them
+void ScrollingWaveformRenderer::drawColumns(juce::Graphics& g, int startX, int endX)
+{
+    juce::Rectangle<int> area(startX, 0, endX - startX, image.getHeight());
+    juce::int64 startSample = (imageStartColumn + startX) * samplesPerPixel;
+    juce::int64 endSample = (imageStartColumn + endX) * samplesPerPixel;
+
+    g.setColour(juce::Colour(35, 47, 52));
+    g.fillRect(area);
+    pyramid->draw(g, area, startSample, endSample, juce::Colour(167, 172, 174), juce::Colour(215, 219, 221), true);
+
+    // draw each beat as a thin line and the first beat of every bar brighter
+    if (gridBpm > 0)
+    {
+        double sampleRate = pyramid->getSampleRate();
+        double beatLength = 60.0 / gridBpm * sampleRate;
+        double firstBeatSample = gridFirstBeat * sampleRate;
+        juce::int64 beat = (juce::int64) std::ceil((startSample - firstBeatSample) / beatLength);
+
+        for (double beatSample = firstBeatSample + beat * beatLength; beatSample < endSample; beatSample += beatLength, ++beat)
+        {
+            int x = (int) ((juce::int64) std::floor(beatSample / samplesPerPixel) - imageStartColumn);
+            bool barStart = beat % 4 == 0;
+            g.setColour(barStart ? juce::Colour(11, 174, 244) : juce::Colours::white.withAlpha(0.35f));
+            g.fillRect(x, 0, 1, image.getHeight());
+        }
+    }
+
+    // redraw the border over the edges of the columns
+    int border = juce::jmax(1, juce::roundToInt(imageScale));
+    g.setColour(juce::Colours::grey);
+    g.fillRect(startX, 0, endX - startX, border);
+    g.fillRect(startX, image.getHeight() - border, endX - startX, border);
+
+    numColumnsDrawn += endX - startX;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    ScrollingWaveformRenderer.h
+    Created: 17 Oct 2026 11:58:14pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WaveformPyramid.h"
+
+// the image behind ScrollingWaveform, a few seconds of the track around a position with the beat grid. it is
+// moved sideways by whole columns each frame, so only the columns scrolled into view are drawn, from the pyramid
+// and never from the audio. it holds no component or player, so the same frames can be drawn off screen
+class ScrollingWaveformRenderer
+{
+public:
+    ScrollingWaveformRenderer();
+    ~ScrollingWaveformRenderer();
+
+    // the pyramid of the loaded track, nullptr while there is none
+    void setPyramid(std::shared_ptr<WaveformPyramid> newPyramid);
+    std::shared_ptr<WaveformPyramid> getPyramid();
+
+    // a bpm of 0 clears the grid
+    void setBeatGrid(double bpm, double firstBeat);
+
+    void setVisibleSeconds(double seconds);
+    double getVisibleSeconds();
+
+    // throw the image away, so that it is drawn whole on the next frame
+    void invalidate();
+
+    // bring the image up to date with the position at its centre, for a view width by height logical pixels
+    // at scale physical pixels per logical one, returns true if the image changed
+    bool renderFrame(double positionInSecs, int width, int height, float scale);
+    const juce::Image& getImage();
+
+    // copy the image into bounds and draw the playhead down its centre
+    void draw(juce::Graphics& g, juce::Rectangle<int> bounds);
+
+    // how long a frame takes to render on average, and how many columns and whole images have been drawn
+    double getAverageRenderMs();
+    juce::int64 getNumColumnsDrawn();
+    int getNumFullRedraws();
+
+    static constexpr double defaultVisibleSeconds = 8.0;
+
+private:
+    void drawColumns(juce::Graphics& g, int startX, int endX);
+
+    std::shared_ptr<WaveformPyramid> pyramid;
+    double visibleSeconds = defaultVisibleSeconds;
+    double gridBpm = 0;
+    double gridFirstBeat = 0;
+
+    // the image holds the columns from imageStartColumn, where column c covers samples c * samplesPerPixel onwards
+    juce::Image image;
+    float imageScale = 0;
+    juce::int64 imageStartColumn = 0;
+    juce::int64 samplesPerPixel = 0;
+    bool imageValid = false;
+
+    double averageRenderMs = 0;
+    juce::int64 numColumnsDrawn = 0;
+    int numFullRedraws = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScrollingWaveformRenderer)
+};
\ No newline at end of file
@@ -0,0 +1,352 @@
+/*
+  ==============================================================================
+
+    SeekIndexedReader.cpp
+    Created: 17 Oct 2026 9:37:52pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "SeekIndexedReader.h"
+
+namespace
+{
+    const int indexMagic = 0x4f545349;
+    const int indexVersion = 1;
+
+    const int bitrates[16] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+    const int sampleRates[4] = { 44100, 48000, 32000, 0 };
+
+    struct FrameHeader
+    {
+        int length = 0;
+        int sampleRate = 0;
+        bool mono = false;
+        bool protectedByCrc = false;
+    };
+
+    // parse the four bytes at the start of an MPEG-1 Layer III frame, returns false for anything else,
+    // including free-format frames whose length cannot be told from the header
+    bool parseHeader(const juce::uint8* data, FrameHeader& header)
+    {
+        if (data[0] != 0xff || (data[1] & 0xfe) != 0xfa)
+        {
+            return false;
+        }
+
+        int bitrate = bitrates[data[2] >> 4];
+        int sampleRate = sampleRates[(data[2] >> 2) & 3];
+
+        if (bitrate == 0 || sampleRate == 0)
+        {
+            return false;
+        }
+
+        header.length = 144000 * bitrate / sampleRate + ((data[2] >> 1) & 1);
+        header.sampleRate = sampleRate;
+        header.mono = (data[3] >> 6) == 3;
+        header.protectedByCrc = (data[1] & 1) == 0;
+
+        return true;
+    }
+
+    // the Xing, Info or VBRI frame some encoders put first holds the track's length rather than audio
+    bool isTagFrame(const juce::uint8* data, const FrameHeader& header)
+    {
+        int sideInfoEnd = 4 + (header.protectedByCrc ? 2 : 0) + (header.mono ? 17 : 32);
+
+        if (header.length < 36 + 4)
+        {
+            return false;
+        }
+
+        return std::memcmp(data + sideInfoEnd, "Xing", 4) == 0 || std::memcmp(data + sideInfoEnd, "Info", 4) == 0
+            || std::memcmp(data + 36, "VBRI", 4) == 0;
+    }
+
+    bool isTrailingTag(const juce::uint8* data, size_t numBytes)
+    {
+        return (numBytes >= 3 && std::memcmp(data, "TAG", 3) == 0) || (numBytes >= 8 && std::memcmp(data, "APETAGEX", 8) == 0)
+            || (numBytes >= 6 && std::memcmp(data, "LYRICS", 6) == 0);
+    }
+}
+
+SeekIndexedReader::SeekIndexedReader(std::unique_ptr<juce::MemoryMappedFile> _mappedFile, SeekTable& _table,
+                                     juce::AudioFormat& _mp3Format, bool _indexLoaded) :
+                                     juce::AudioFormatReader(nullptr, _mp3Format.getFormatName()),
+                                     mappedFile(std::move(_mappedFile)),
+                                     mp3Format(_mp3Format),
+                                     indexLoaded(_indexLoaded)
+{
+    std::swap(table, _table);
+
+    sampleRate = table.sampleRate;
+    numChannels = (unsigned int) table.numChannels;
+    bitsPerSample = 32;
+    usesFloatingPointData = true;
+    lengthInSamples = (juce::int64) table.frameOffsets.size() * samplesPerFrame;
+}
+
+SeekIndexedReader::~SeekIndexedReader()
+{
+
+}
+
+SeekIndexedReader* SeekIndexedReader::createFor(const juce::File& file, juce::AudioFormatManager& formatManager)
+{
+    auto* mp3Format = formatManager.findFormatForFileExtension(".mp3");
+
+    if (mp3Format == nullptr || file.hasFileExtension("mp3") == false)
+    {
+        return nullptr;
+    }
+
+    auto mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+
+    if (mappedFile->getData() == nullptr)
+    {
+        return nullptr;
+    }
+
+    // use the saved table while the file is unchanged, otherwise scan the file and save a new one
+    SeekTable table;
+    juce::File indexFile = getIndexFileFor(file);
+    bool indexLoaded = loadTable(indexFile, table) && table.path == file.getFullPathName() && table.fileSize == file.getSize()
+                       && table.modificationTime == file.getLastModificationTime().toMilliseconds();
+
+    if (indexLoaded == false)
+    {
+        table = SeekTable();
+        table.path = file.getFullPathName();
+        table.fileSize = file.getSize();
+        table.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+        if (buildTable(*mappedFile, table) == false)
+        {
+            return nullptr;
+        }
+
+        saveTable(indexFile, table);
+    }
+
+    std::unique_ptr<SeekIndexedReader> reader(new SeekIndexedReader(std::move(mappedFile), table, *mp3Format, indexLoaded));
+
+    // the decoder's view of the file is the one to trust for the channel count
+    if (reader->openDecoderAt(0) == false)
+    {
+        return nullptr;
+    }
+
+    reader->numChannels = reader->decoder->numChannels;
+    return reader.release();
+}
+
+bool SeekIndexedReader::readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                                    juce::int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength(destChannels, numDestChannels, startOffsetInDestBuffer,
+                                      startSampleInFile, numSamples, lengthInSamples);
+
+    if (numSamples <= 0)
+    {
+        return true;
+    }
+
+    // carry on with the current decoder for reads that continue from it or jump back within what it has
+    // already decoded, which it can seek to itself, and open a new one anywhere else
+    juce::int64 firstUsable = decoderStart + (decoderStart > 0 ? prerollFrames * samplesPerFrame : 0);
+    bool reuseDecoder = decoder != nullptr && startSampleInFile >= firstUsable
+                        && startSampleInFile <= nextSample + prerollFrames * samplesPerFrame;
+
+    if (reuseDecoder == false && openDecoderAt(startSampleInFile) == false)
+    {
+        for (int i = 0; i < numDestChannels; ++i)
+        {
+            if (destChannels[i] != nullptr)
+            {
+                juce::zeromem(destChannels[i] + startOffsetInDestBuffer, (size_t) numSamples * sizeof(int));
+            }
+        }
+
+        return false;
+    }
+
+    // the decoder's own length is only an estimate from the file size, so it is read directly rather than through read()
+    nextSample = startSampleInFile + numSamples;
+
+    return decoder->readSamples(destChannels, numDestChannels, startOffsetInDestBuffer, startSampleInFile - decoderStart, numSamples);
+}
+
+int SeekIndexedReader::getNumFrames()
+{
+    return (int) table.frameOffsets.size();
+}
+
+int SeekIndexedReader::getNumDecoderOpens()
+{
+    return numDecoderOpens;
+}
+
+bool SeekIndexedReader::wasIndexLoaded()
+{
+    return indexLoaded;
+}
+
+juce::File SeekIndexedReader::getIndexDirectory()
+{
+    return juce::File::getCurrentWorkingDirectory().getChildFile("seekindex");
+}
+
+// open a decoder on the file from a few frames before the one holding the sample, which the decoder then
+// reaches by decoding only those frames
+bool SeekIndexedReader::openDecoderAt(juce::int64 sample)
+{
+    int frame = (int) juce::jlimit((juce::int64) 0, (juce::int64) table.frameOffsets.size() - 1, sample / samplesPerFrame);
+    int firstFrame = juce::jmax(0, frame - prerollFrames);
+    size_t offset = table.frameOffsets[(size_t) firstFrame];
+
+    auto* stream = new juce::MemoryInputStream(static_cast<const char*>(mappedFile->getData()) + offset,
+                                               mappedFile->getSize() - offset, false);
+    decoder.reset(mp3Format.createReaderFor(stream, true));
+    decoderStart = (juce::int64) firstFrame * samplesPerFrame;
+    nextSample = -1;
+    numDecoderOpens++;
+
+    return decoder != nullptr;
+}
+
+// walk the frame headers from after any ID3v2 tag, resyncing byte by byte over anything that is not a frame
+// followed by another frame or the end of the file
+bool SeekIndexedReader::buildTable(const juce::MemoryMappedFile& mappedFile, SeekTable& table)
+{
+    auto* data = static_cast<const juce::uint8*>(mappedFile.getData());
+    size_t size = mappedFile.getSize();
+    size_t position = 0;
+
+    if (size > std::numeric_limits<juce::uint32>::max())
+    {
+        return false;
+    }
+
+    if (size >= 10 && std::memcmp(data, "ID3", 3) == 0)
+    {
+        size_t tagSize = ((size_t) (data[6] & 0x7f) << 21) | ((size_t) (data[7] & 0x7f) << 14)
+                         | ((size_t) (data[8] & 0x7f) << 7) | (size_t) (data[9] & 0x7f);
+        position = 10 + tagSize + ((data[5] & 0x10) != 0 ? 10 : 0);
+    }
+
+    bool firstFrame = true;
+    size_t expectedPosition = 0;
+    FrameHeader header, nextHeader;
+
+    while (position + 4 <= size)
+    {
+        bool isFrame = parseHeader(data + position, header) && (table.sampleRate == 0 || header.sampleRate == table.sampleRate);
+        size_t next = position + (size_t) header.length;
+
+        // a frame straight after the last one is trusted on its header, one found by resyncing must be followed by another
+        bool confirmed = (firstFrame == false && position == expectedPosition)
+                         || next + 4 > size || parseHeader(data + next, nextHeader) || isTrailingTag(data + next, size - next);
+        isFrame = isFrame && next <= size && confirmed;
+
+        if (isFrame == false)
+        {
+            position++;
+            continue;
+        }
+
+        if (firstFrame)
+        {
+            table.sampleRate = header.sampleRate;
+            table.numChannels = header.mono ? 1 : 2;
+            firstFrame = false;
+
+            if (isTagFrame(data + position, header))
+            {
+                position = next;
+                expectedPosition = next;
+                continue;
+            }
+        }
+
+        table.frameOffsets.push_back((juce::uint32) position);
+        position = next;
+        expectedPosition = next;
+    }
+
+    return table.frameOffsets.size() > (size_t) prerollFrames;
+}
+
+bool SeekIndexedReader::loadTable(const juce::File& indexFile, SeekTable& table)
+{
+    juce::FileInputStream stream(indexFile);
+
+    if (stream.openedOk() == false || stream.readInt() != indexMagic || stream.readInt() != indexVersion)
+    {
+        return false;
+    }
+
+    table.path = stream.readString();
+    table.fileSize = stream.readInt64();
+    table.modificationTime = stream.readInt64();
+    table.sampleRate = stream.readInt();
+    table.numChannels = stream.readInt();
+    int numFrames = stream.readInt();
+
+    if (numFrames <= 0 || stream.getNumBytesRemaining() != (juce::int64) numFrames * 4)
+    {
+        return false;
+    }
+
+    table.frameOffsets.resize((size_t) numFrames);
+    stream.read(table.frameOffsets.data(), numFrames * 4);
+
+    // the offsets are saved little-endian
+    for (auto& offset : table.frameOffsets)
+    {
+        offset = juce::ByteOrder::swapIfBigEndian(offset);
+    }
+
+    return true;
+}
+
+bool SeekIndexedReader::saveTable(const juce::File& indexFile, const SeekTable& table)
+{
+    indexFile.getParentDirectory().createDirectory();
+
+    // the deck loader, a seam and the track cache can all index the same file at once, so each one writes
+    // its own file beside the index and moves it into place, and a reader never sees half a table
+    juce::TemporaryFile temporary(indexFile);
+
+    {
+        juce::FileOutputStream stream(temporary.getFile());
+
+        if (stream.openedOk() == false)
+        {
+            DBG("SeekIndexedReader::saveTable could not write " << temporary.getFile().getFullPathName());
+            return false;
+        }
+
+        stream.writeInt(indexMagic);
+        stream.writeInt(indexVersion);
+        stream.writeString(table.path);
+        stream.writeInt64(table.fileSize);
+        stream.writeInt64(table.modificationTime);
+        stream.writeInt(table.sampleRate);
+        stream.writeInt(table.numChannels);
+        stream.writeInt((int) table.frameOffsets.size());
+
+        for (auto offset : table.frameOffsets)
+        {
+            stream.writeInt((int) offset);
+        }
+    }
+
+    return temporary.overwriteTargetFileWithTemporary();
+}
+
+juce::File SeekIndexedReader::getIndexFileFor(const juce::File& file)
+{
+    return getIndexDirectory().getChildFile(juce::String::toHexString(file.getFullPathName().hashCode64()) + ".seek");
+}
\ No newline at end of file
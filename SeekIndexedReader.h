@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    SeekIndexedReader.h
+    Created: 17 Oct 2026 9:37:52pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// reads an MP3 file through a table of where every frame starts, so that a seek opens a fresh decoder a few
+// frames before the target instead of making the decoder scan the file up to it, the table is built from
+// the frame headers the first time a file is opened and saved next to the library for later loads
+class SeekIndexedReader : public juce::AudioFormatReader
+{
+public:
+    ~SeekIndexedReader() override;
+
+    // create an indexed reader for MPEG-1 Layer III files, returns nullptr for anything else
+    // or if the format manager has no MP3 decoder
+    static SeekIndexedReader* createFor(const juce::File& file, juce::AudioFormatManager& formatManager);
+
+    bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                     juce::int64 startSampleInFile, int numSamples) override;
+
+    int getNumFrames();
+    int getNumDecoderOpens();
+
+    // whether the table came from a saved index rather than scanning the file
+    bool wasIndexLoaded();
+
+    // where the tables are saved, next to playlist.txt and deck.txt
+    static juce::File getIndexDirectory();
+
+    static constexpr int samplesPerFrame = 1152;
+
+    // frames decoded and thrown away before the target, so that the bit reservoir is filled again
+    static constexpr int prerollFrames = 4;
+
+private:
+    struct SeekTable
+    {
+        juce::String path;
+        juce::int64 fileSize = 0;
+        juce::int64 modificationTime = 0;
+        int sampleRate = 0;
+        int numChannels = 0;
+        std::vector<juce::uint32> frameOffsets;
+    };
+
+    SeekIndexedReader(std::unique_ptr<juce::MemoryMappedFile> _mappedFile, SeekTable& _table,
+                      juce::AudioFormat& _mp3Format, bool _indexLoaded);
+
+    static bool buildTable(const juce::MemoryMappedFile& mappedFile, SeekTable& table);
+    static bool loadTable(const juce::File& indexFile, SeekTable& table);
+    static bool saveTable(const juce::File& indexFile, const SeekTable& table);
+    static juce::File getIndexFileFor(const juce::File& file);
+
+    bool openDecoderAt(juce::int64 sample);
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    SeekTable table;
+    juce::AudioFormat& mp3Format;
+    bool indexLoaded;
+
+    // the decoder reads from the frame at decoderStart, and nextSample is where the last read ended
+    std::unique_ptr<juce::AudioFormatReader> decoder;
+    juce::int64 decoderStart = 0;
+    juce::int64 nextSample = -1;
+    int numDecoderOpens = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SeekIndexedReader)
+};
\ No newline at end of file
@@ -0,0 +1,536 @@
+/*
+  ==============================================================================
+
+    TimeStretcher.cpp
+    Created: 17 Oct 2026 1:26:52pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "TimeStretcher.h"
+
+// WSOLA: each output frame is the input segment, within a fixed search range around its nominal position,
+// that best continues the previous frame, cross-faded in with a Hann window at 50% overlap. The frame size
+// and search range only depend on the mode, and each frame's search is spread over the output of the frame
+// before it, so every output block costs about the same whatever the tempo.
+
+namespace
+{
+    const int pullChunk = 256;
+    const double minTempo = 0.01;
+    const double maxTempo = 4.0;
+}
+
+TimeStretcher::TimeStretcher(juce::AudioSource* _input, bool _deleteInputWhenDeleted, int _numChannels) :
+                             input(_input, _deleteInputWhenDeleted),
+                             numChannels(_numChannels)
+{
+    jassert(input != nullptr);
+}
+
+TimeStretcher::~TimeStretcher()
+{
+
+}
+
+void TimeStretcher::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    blockSize = samplesPerBlockExpected;
+    input->prepareToPlay(samplesPerBlockExpected, newSampleRate);
+
+    // build both windows and size the buffers for the larger mode, so switching never allocates
+    for (int i = 0; i < 2; ++i)
+    {
+        int frameLength = getSettings((Mode) i).frameLength;
+        windows[i].resize((size_t) frameLength);
+
+        for (int k = 0; k < frameLength; ++k)
+        {
+            windows[i][(size_t) k] = (float) (0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * k / frameLength));
+        }
+    }
+
+    Settings largest = getSettings(Mode::highQuality);
+    int inputCapacity = (int) (largest.frameLength * (maxTempo + 2)) + largest.searchRange * 4 + pullChunk * 2;
+    inputBuffer.setSize(numChannels, inputCapacity);
+    mixBuffer.assign((size_t) inputCapacity, 0.0f);
+    overlapBuffer.setSize(numChannels, largest.frameLength);
+    outputBuffer.setSize(numChannels, largest.frameLength);
+
+    applySettings((Mode) mode.load());
+    stretching = false;
+    clearState();
+}
+
+void TimeStretcher::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    bool shouldBeEnabled = enabled;
+    int newMode = mode;
+
+    // the input was repositioned, so nothing buffered belongs to where it is now
+    if (resetRequested.exchange(false))
+    {
+        clearState();
+        stretching = false;
+    }
+
+    // switching keylock off or changing mode fades the stretched output into the input where it had got to,
+    // and switching it on fades back in from there, rather than dropping what was buffered. a switch waits a
+    // block if the last one's fade has not played out far enough to leave room for another
+    bool roomToFinish = numOutputReady + settings.frameLength / 2 <= outputBuffer.getNumSamples();
+
+    if (stretching && (shouldBeEnabled == false || newMode != activeMode) && roomToFinish)
+    {
+        finishStretching();
+    }
+
+    if (stretching == false && newMode != activeMode)
+    {
+        applySettings((Mode) newMode);
+    }
+
+    if (shouldBeEnabled && stretching == false && inputBuffer.getNumSamples() > 0)
+    {
+        startStretching();
+    }
+
+    if (stretching == false)
+    {
+        copyRawInput(bufferToFill);
+        return;
+    }
+
+    const int numOutputChannels = juce::jmin(numChannels, bufferToFill.buffer->getNumChannels());
+    const int hop = settings.frameLength / 2;
+
+    for (int done = 0; done < bufferToFill.numSamples;)
+    {
+        if (numOutputReady == 0)
+        {
+            processFrame();
+        }
+
+        int numThisTime = juce::jmin(numOutputReady, bufferToFill.numSamples - done);
+
+        for (int channel = 0; channel < numOutputChannels; ++channel)
+        {
+            bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample + done, outputBuffer, channel, outputReadPosition, numThisTime);
+        }
+
+        outputReadPosition += numThisTime;
+        numOutputReady -= numThisTime;
+        done += numThisTime;
+
+        // keep the next frame's search in step with how much of this frame has been played
+        int target = (int) ((juce::int64) search.numCandidates * juce::jmax(0, hop - numOutputReady) / hop);
+        continueSearch(target - search.numDone);
+    }
+
+    for (int channel = numChannels; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+    {
+        bufferToFill.buffer->clear(channel, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+}
+
+void TimeStretcher::releaseResources()
+{
+    input->releaseResources();
+}
+
+void TimeStretcher::setEnabled(bool shouldBeEnabled)
+{
+    enabled = shouldBeEnabled;
+}
+
+bool TimeStretcher::isEnabled()
+{
+    return enabled;
+}
+
+void TimeStretcher::setTempo(double ratio)
+{
+    tempo = juce::jlimit(minTempo, maxTempo, ratio);
+}
+
+double TimeStretcher::getTempo()
+{
+    return tempo;
+}
+
+void TimeStretcher::setMode(Mode newMode)
+{
+    mode = (int) newMode;
+}
+
+TimeStretcher::Mode TimeStretcher::getMode()
+{
+    return (Mode) mode.load();
+}
+
+void TimeStretcher::reset()
+{
+    resetRequested = true;
+}
+
+int TimeStretcher::getLatencySamples()
+{
+    Settings current = getSettings(getMode());
+    return current.frameLength + current.searchRange;
+}
+
+// live uses short frames and a decimated search to keep latency and CPU low, high quality uses
+// longer frames and searches every offset
+TimeStretcher::Settings TimeStretcher::getSettings(Mode forMode) const
+{
+    Settings result;
+
+    if (forMode == Mode::live)
+    {
+        result.frameLength = 2 * juce::roundToInt(sampleRate * 0.010);
+        result.searchRange = juce::roundToInt(sampleRate * 0.004);
+        result.searchStep = 4;
+        result.correlationStep = 4;
+    }
+
+    else
+    {
+        result.frameLength = 2 * juce::roundToInt(sampleRate * 0.020);
+        result.searchRange = juce::roundToInt(sampleRate * 0.012);
+        result.searchStep = 1;
+        result.correlationStep = 2;
+    }
+
+    return result;
+}
+
+void TimeStretcher::applySettings(Mode newMode)
+{
+    settings = getSettings(newMode);
+    activeMode = (int) newMode;
+}
+
+void TimeStretcher::clearState()
+{
+    inputStart = 0;
+    inputEnd = 0;
+    analysisPosition = 0;
+    previousSegment = 0;
+    hasPreviousFrame = false;
+    search = Search();
+    rawPosition = -1;
+    outputReadPosition = 0;
+    numOutputReady = 0;
+    overlapBuffer.clear();
+}
+
+// start stretching from the next input sample to be played, treating the input from there as the previous
+// frame, so that its falling half cross-fades into the first stretched frame with no gap and no jump
+void TimeStretcher::startStretching()
+{
+    if (rawPosition < 0)
+    {
+        clearState();
+        rawPosition = 0;
+    }
+
+    const int hop = settings.frameLength / 2;
+    const std::vector<float>& window = windows[activeMode];
+    ensureInput(rawPosition + hop);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* overlap = overlapBuffer.getWritePointer(channel);
+        const float* samples = inputBuffer.getReadPointer(channel, (int) (rawPosition - inputStart));
+
+        for (int k = 0; k < hop; ++k)
+        {
+            overlap[k] = samples[k] * window[(size_t) (hop + k)];
+        }
+
+        juce::FloatVectorOperations::clear(overlap + hop, overlapBuffer.getNumSamples() - hop);
+    }
+
+    previousSegment = rawPosition - hop;
+    hasPreviousFrame = true;
+    analysisPosition = (double) rawPosition;
+    rawPosition = -1;
+    stretching = true;
+    startSearch();
+}
+
+// play out what is ready, then one hop of the last frame's falling half over the input that naturally follows
+// it, which adds back up to the input itself, so that playing on from there continues without a jump
+void TimeStretcher::finishStretching()
+{
+    stretching = false;
+    search = Search();
+
+    if (hasPreviousFrame == false)
+    {
+        rawPosition = juce::jmax(inputStart, (juce::int64) analysisPosition);
+        return;
+    }
+
+    const int hop = settings.frameLength / 2;
+    const std::vector<float>& window = windows[activeMode];
+    juce::int64 natural = previousSegment + hop;
+    ensureInput(natural + hop);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* output = outputBuffer.getWritePointer(channel);
+        const float* overlap = overlapBuffer.getReadPointer(channel);
+        const float* samples = inputBuffer.getReadPointer(channel, (int) (natural - inputStart));
+
+        std::memmove(output, output + outputReadPosition, sizeof(float) * (size_t) numOutputReady);
+
+        for (int k = 0; k < hop; ++k)
+        {
+            output[numOutputReady + k] = overlap[k] + samples[k] * window[(size_t) k];
+        }
+    }
+
+    outputReadPosition = 0;
+    numOutputReady += hop;
+    overlapBuffer.clear();
+    hasPreviousFrame = false;
+    rawPosition = natural + hop;
+}
+
+// play whatever the last cross-fade left, then the input read ahead but not played yet, then the input itself
+void TimeStretcher::copyRawInput(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (numOutputReady == 0 && rawPosition < 0)
+    {
+        input->getNextAudioBlock(bufferToFill);
+        return;
+    }
+
+    const int numOutputChannels = juce::jmin(numChannels, bufferToFill.buffer->getNumChannels());
+    int done = 0;
+
+    int numReady = juce::jmin(numOutputReady, bufferToFill.numSamples);
+
+    for (int channel = 0; channel < numOutputChannels; ++channel)
+    {
+        bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample, outputBuffer, channel, outputReadPosition, numReady);
+    }
+
+    outputReadPosition += numReady;
+    numOutputReady -= numReady;
+    done += numReady;
+
+    if (rawPosition >= 0 && done < bufferToFill.numSamples)
+    {
+        int numBuffered = (int) juce::jmin((juce::int64) (bufferToFill.numSamples - done), inputEnd - rawPosition);
+
+        for (int channel = 0; channel < numOutputChannels; ++channel)
+        {
+            bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample + done, inputBuffer, channel, (int) (rawPosition - inputStart), numBuffered);
+        }
+
+        rawPosition += numBuffered;
+        done += numBuffered;
+
+        if (rawPosition >= inputEnd)
+        {
+            clearState();
+        }
+
+        else
+        {
+            discardInputBefore(rawPosition);
+        }
+    }
+
+    for (int channel = numChannels; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+    {
+        bufferToFill.buffer->clear(channel, bufferToFill.startSample, done);
+    }
+
+    if (done < bufferToFill.numSamples)
+    {
+        juce::AudioSourceChannelInfo rest(bufferToFill.buffer, bufferToFill.startSample + done, bufferToFill.numSamples - done);
+        input->getNextAudioBlock(rest);
+    }
+}
+
+// produce the next half frame of output
+void TimeStretcher::processFrame()
+{
+    const int frameLength = settings.frameLength;
+    const int hop = frameLength / 2;
+    const std::vector<float>& window = windows[activeMode];
+
+    if (search.started == false)
+    {
+        startSearch();
+    }
+
+    // whatever of the search has not been spread over the last frame's output is finished here
+    continueSearch(std::numeric_limits<int>::max());
+
+    juce::int64 segment = search.best;
+    int offset = (int) (segment - inputStart);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* overlap = overlapBuffer.getWritePointer(channel);
+        const float* samples = inputBuffer.getReadPointer(channel, offset);
+
+        for (int k = 0; k < frameLength; ++k)
+        {
+            overlap[k] += samples[k] * window[(size_t) k];
+        }
+
+        // the first half has now had both overlapping frames added, so it is finished
+        outputBuffer.copyFrom(channel, 0, overlapBuffer, channel, 0, hop);
+        std::memmove(overlap, overlap + hop, sizeof(float) * (size_t) (frameLength - hop));
+        juce::FloatVectorOperations::clear(overlap + frameLength - hop, hop);
+    }
+
+    outputReadPosition = 0;
+    numOutputReady = hop;
+    previousSegment = segment;
+    hasPreviousFrame = true;
+    analysisPosition += hop * tempo.load();
+
+    discardInputBefore(juce::jmin((juce::int64) analysisPosition - settings.searchRange, previousSegment + hop));
+    startSearch();
+}
+
+// set up the search for the segment near the next nominal position whose start best matches the natural
+// continuation of the previous frame, reading all the input it will need now
+void TimeStretcher::startSearch()
+{
+    const int frameLength = settings.frameLength;
+    juce::int64 nominal = (juce::int64) analysisPosition;
+
+    search = Search();
+    search.started = true;
+    search.natural = hasPreviousFrame ? previousSegment + frameLength / 2 : -1;
+    ensureInput(juce::jmax(nominal + settings.searchRange + frameLength, search.natural + frameLength));
+
+    search.low = juce::jmax(nominal - settings.searchRange, inputStart);
+    search.high = juce::jmax(search.low, nominal + settings.searchRange);
+
+    if (search.natural < 0)
+    {
+        search.best = juce::jmax(nominal, inputStart);
+        search.finished = true;
+        return;
+    }
+
+    search.candidate = search.low;
+    search.end = search.high;
+    search.best = search.low;
+    search.bestScore = -std::numeric_limits<float>::max();
+    search.numCandidates = (int) ((search.high - search.low) / settings.searchStep) + 1
+                           + (settings.searchStep > 1 ? settings.searchStep * 2 - 1 : 0);
+}
+
+// score up to numToTry more candidates, a decimated pass first and then every offset around its best match
+void TimeStretcher::continueSearch(int numToTry)
+{
+    for (int i = 0; i < numToTry && search.finished == false; ++i)
+    {
+        if (search.candidate > search.end)
+        {
+            if (search.refining || settings.searchStep <= 1)
+            {
+                search.finished = true;
+                break;
+            }
+
+            search.refining = true;
+            search.candidate = juce::jmax(search.low, search.best - settings.searchStep + 1);
+            search.end = juce::jmin(search.high, search.best + settings.searchStep - 1);
+        }
+
+        float score = getSimilarity(search.candidate, search.natural);
+
+        if (score > search.bestScore)
+        {
+            search.bestScore = score;
+            search.best = search.candidate;
+        }
+
+        search.candidate += search.refining ? 1 : settings.searchStep;
+        search.numDone++;
+    }
+}
+
+// cross-correlation of the candidate with the reference, divided by the candidate's level over the same taps,
+// so that a louder candidate does not win just for being loud, such as one landing on the next transient
+float TimeStretcher::getSimilarity(juce::int64 candidate, juce::int64 natural)
+{
+    const int overlapLength = settings.frameLength / 2;
+    const float* samples = mixBuffer.data() + (candidate - inputStart);
+    const float* reference = mixBuffer.data() + (natural - inputStart);
+    float sum = 0.0f;
+    float energy = 0.0f;
+
+    for (int k = 0; k < overlapLength; k += settings.correlationStep)
+    {
+        sum += samples[k] * reference[k];
+        energy += samples[k] * samples[k];
+    }
+
+    // keeps a silent candidate from dividing by zero
+    const float epsilon = 1.0e-9f;
+    return sum / std::sqrt(energy + epsilon);
+}
+
+// pull input until samples up to end are buffered
+void TimeStretcher::ensureInput(juce::int64 end)
+{
+    while (inputEnd < end)
+    {
+        int offset = (int) (inputEnd - inputStart);
+        int numToPull = juce::jmin(inputBuffer.getNumSamples() - offset, juce::jmax((int) (end - inputEnd), pullChunk));
+
+        if (numToPull <= 0)
+        {
+            jassertfalse;
+            break;
+        }
+
+        juce::AudioSourceChannelInfo inputInfo(&inputBuffer, offset, numToPull);
+        input->getNextAudioBlock(inputInfo);
+
+        for (int k = 0; k < numToPull; ++k)
+        {
+            float sum = 0.0f;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                sum += inputBuffer.getSample(channel, offset + k);
+            }
+
+            mixBuffer[(size_t) (offset + k)] = sum;
+        }
+
+        inputEnd += numToPull;
+    }
+}
+
+void TimeStretcher::discardInputBefore(juce::int64 position)
+{
+    int numToDiscard = (int) juce::jlimit((juce::int64) 0, inputEnd - inputStart, position - inputStart);
+
+    if (numToDiscard > 0)
+    {
+        int numToKeep = (int) (inputEnd - inputStart) - numToDiscard;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* data = inputBuffer.getWritePointer(channel);
+            std::memmove(data, data + numToDiscard, sizeof(float) * (size_t) numToKeep);
+        }
+
+        std::memmove(mixBuffer.data(), mixBuffer.data() + numToDiscard, sizeof(float) * (size_t) numToKeep);
+        inputStart += numToDiscard;
+    }
+}
\ No newline at end of file
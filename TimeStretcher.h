@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    TimeStretcher.h
+    Created: 17 Oct 2026 1:26:52pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class TimeStretcher : public juce::AudioSource
+{
+public:
+    enum class Mode
+    {
+        live,
+        highQuality
+    };
+
+    TimeStretcher(juce::AudioSource* _input, bool _deleteInputWhenDeleted, int _numChannels = 2);
+    ~TimeStretcher() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    // when disabled, blocks are passed straight through from the input. switching either way, or changing the
+    // mode, cross-fades over one hop at the input position already reached, so the playhead never jumps
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled();
+
+    // input samples consumed per output sample
+    void setTempo(double ratio);
+    double getTempo();
+
+    void setMode(Mode newMode);
+    Mode getMode();
+
+    // drop everything buffered, e.g. after the input has been repositioned
+    void reset();
+
+    int getLatencySamples();
+
+private:
+    struct Settings
+    {
+        int frameLength = 0;
+        int searchRange = 0;
+        int searchStep = 1;
+        int correlationStep = 1;
+    };
+
+    // the search for the segment of the next frame, started as soon as the previous frame is done and carried
+    // out a little at a time while that frame's output is played, so that no one block pays for all of it
+    struct Search
+    {
+        juce::int64 low = 0;
+        juce::int64 high = 0;
+        juce::int64 natural = -1;
+        juce::int64 candidate = 0;
+        juce::int64 end = 0;
+        juce::int64 best = 0;
+        float bestScore = 0;
+        bool refining = false;
+        bool started = false;
+        bool finished = false;
+        int numCandidates = 0;
+        int numDone = 0;
+    };
+
+    Settings getSettings(Mode mode) const;
+    void applySettings(Mode newMode);
+    void clearState();
+    void startStretching();
+    void finishStretching();
+    void copyRawInput(const juce::AudioSourceChannelInfo& bufferToFill);
+    void processFrame();
+    void startSearch();
+    void continueSearch(int numToTry);
+    float getSimilarity(juce::int64 candidate, juce::int64 natural);
+    void ensureInput(juce::int64 end);
+    void discardInputBefore(juce::int64 position);
+
+    juce::OptionalScopedPointer<juce::AudioSource> input;
+    int numChannels;
+    double sampleRate = 44100;
+    int blockSize = 512;
+
+    std::atomic<bool> enabled{ false };
+    std::atomic<double> tempo{ 1.0 };
+    std::atomic<int> mode{ (int) Mode::live };
+    std::atomic<bool> resetRequested{ false };
+    bool stretching = false;
+    int activeMode = -1;
+
+    Settings settings;
+    std::vector<float> windows[2];
+
+    // input samples from inputStart onwards, plus a mono mix used for the similarity search
+    juce::AudioBuffer<float> inputBuffer;
+    std::vector<float> mixBuffer;
+    juce::int64 inputStart = 0;
+    juce::int64 inputEnd = 0;
+
+    juce::AudioBuffer<float> overlapBuffer;
+    juce::AudioBuffer<float> outputBuffer;
+    int outputReadPosition = 0;
+    int numOutputReady = 0;
+
+    double analysisPosition = 0;
+    juce::int64 previousSegment = 0;
+    bool hasPreviousFrame = false;
+    Search search;
+
+    // after stretching stops, the input from rawPosition to inputEnd has been read but not yet played,
+    // so it is played from the buffer before blocks are passed straight through again, -1 once it has all gone
+    juce::int64 rawPosition = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeStretcher)
+};
\ No newline at end of file
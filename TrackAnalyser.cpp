@@ -0,0 +1,901 @@
+/*
+  ==============================================================================
+
+    TrackAnalyser.cpp
+    Created: 17 Oct 2026 8:47:19pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "TrackAnalyser.h"
+#include <iostream>
+#include <fstream>
+#include <numeric>
+
+namespace
+{
+    // samples decoded at a time and handed to every analyser
+    const int chunkSize = 65536;
+
+    // how long a job waits before asking again for a slot while a deck is playing
+    const int slotWaitMs = 20;
+
+    // shortest time between two saves of analysis.txt while tracks are finishing
+    const juce::uint32 saveIntervalMs = 5000;
+
+    struct Biquad
+    {
+        double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+        double z1 = 0, z2 = 0;
+
+        void setLowPass(double frequency, double q, double sampleRate)
+        {
+            double w0 = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            double alpha = std::sin(w0) / (2.0 * q);
+            double a0 = 1.0 + alpha;
+            b0 = (1.0 - std::cos(w0)) / 2.0 / a0;
+            b1 = (1.0 - std::cos(w0)) / a0;
+            b2 = b0;
+            a1 = -2.0 * std::cos(w0) / a0;
+            a2 = (1.0 - alpha) / a0;
+        }
+
+        // transposed direct form II
+        float process(float x)
+        {
+            double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return (float) y;
+        }
+    };
+
+    // one analysis fed block by block from the shared decode, which writes its findings when the track ends
+    class Analyser
+    {
+    public:
+        virtual ~Analyser() = default;
+        virtual void process(const float* const* channels, int numChannels, int numSamples) = 0;
+        virtual void finish(TrackAnalyser::Result& result) = 0;
+    };
+
+    class PeakAnalyser : public Analyser
+    {
+    public:
+        void process(const float* const* channels, int numChannels, int numSamples) override
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto range = juce::FloatVectorOperations::findMinAndMax(channels[channel], numSamples);
+                peak = juce::jmax(peak, std::abs(range.getStart()), std::abs(range.getEnd()));
+            }
+        }
+
+        void finish(TrackAnalyser::Result& result) override
+        {
+            result.peak = juce::Decibels::gainToDecibels(peak, -100.0f);
+        }
+
+    private:
+        float peak = 0;
+    };
+
+    // integrated loudness from K-weighted mean square over 400 ms blocks that overlap by 75%,
+    // gated at -70 LUFS and then at 10 LU below the loudness of the blocks that passed
+    class LoudnessAnalyser : public Analyser
+    {
+    public:
+        LoudnessAnalyser(double sampleRate) :
+                         stepLength(juce::jmax(1, juce::roundToInt(sampleRate * 0.1)))
+        {
+            // the K-weighting pre-filter shelf and RLB high-pass, worked out for any sample rate
+            double k = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+            double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+            double vb = std::pow(vh, 0.4996667741545416);
+            double q = 0.7071752369554196;
+            double a0 = 1.0 + k / q + k * k;
+
+            for (auto& filter : shelf)
+            {
+                filter.b0 = (vh + vb * k / q + k * k) / a0;
+                filter.b1 = 2.0 * (k * k - vh) / a0;
+                filter.b2 = (vh - vb * k / q + k * k) / a0;
+                filter.a1 = 2.0 * (k * k - 1.0) / a0;
+                filter.a2 = (1.0 - k / q + k * k) / a0;
+            }
+
+            k = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+            q = 0.5003270373238773;
+            a0 = 1.0 + k / q + k * k;
+
+            for (auto& filter : highPass)
+            {
+                filter.b0 = 1.0;
+                filter.b1 = -2.0;
+                filter.b2 = 1.0;
+                filter.a1 = 2.0 * (k * k - 1.0) / a0;
+                filter.a2 = (1.0 - k / q + k * k) / a0;
+            }
+        }
+
+        void process(const float* const* channels, int numChannels, int numSamples) override
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int channel = 0; channel < juce::jmin(2, numChannels); ++channel)
+                {
+                    double y = highPass[channel].process(shelf[channel].process(channels[channel][i]));
+                    stepEnergy += y * y;
+                }
+
+                if (++stepPosition == stepLength)
+                {
+                    addStep();
+                }
+            }
+        }
+
+        void finish(TrackAnalyser::Result& result) override
+        {
+            double absoluteGate = std::pow(10.0, (-70.0 + 0.691) / 10.0);
+            double sum = 0;
+            int count = 0;
+
+            for (double energy : blockEnergies)
+            {
+                if (energy > absoluteGate)
+                {
+                    sum += energy;
+                    count++;
+                }
+            }
+
+            if (count == 0)
+            {
+                return;
+            }
+
+            double relativeGate = sum / count * 0.1;
+            sum = 0;
+            count = 0;
+
+            for (double energy : blockEnergies)
+            {
+                if (energy > absoluteGate && energy > relativeGate)
+                {
+                    sum += energy;
+                    count++;
+                }
+            }
+
+            result.loudness = (float) juce::jmax(-100.0, -0.691 + 10.0 * std::log10(sum / count));
+        }
+
+    private:
+        void addStep()
+        {
+            steps[numSteps % 4] = stepEnergy;
+            numSteps++;
+            stepEnergy = 0;
+            stepPosition = 0;
+
+            if (numSteps >= 4)
+            {
+                blockEnergies.push_back((steps[0] + steps[1] + steps[2] + steps[3]) / (4.0 * stepLength));
+            }
+        }
+
+        Biquad shelf[2];
+        Biquad highPass[2];
+        int stepLength;
+        int stepPosition = 0;
+        double stepEnergy = 0;
+        double steps[4] = {};
+        int numSteps = 0;
+        std::vector<double> blockEnergies;
+    };
+
+    // an onset envelope from rises in the log energy of a low band and of the high-passed signal,
+    // whose autocorrelation gives the beat period, weighted towards 120 BPM to settle half or double
+    // tempo, and whose strongest comb of beats at that period gives where the grid starts
+    class TempoAnalyser : public Analyser
+    {
+    public:
+        TempoAnalyser(double _sampleRate) :
+                      sampleRate(_sampleRate),
+                      hopLength(juce::jmax(1, juce::roundToInt(_sampleRate / framesPerSecond)))
+        {
+            lowPass.setLowPass(150.0, 0.7071, sampleRate);
+        }
+
+        void process(const float* const* channels, int numChannels, int numSamples) override
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float mono = numChannels > 1 ? 0.5f * (channels[0][i] + channels[1][i]) : channels[0][i];
+                float low = lowPass.process(mono);
+                float high = mono - lastSample;
+                lastSample = mono;
+
+                lowEnergy += low * low;
+                highEnergy += high * high;
+
+                if (++hopPosition == hopLength)
+                {
+                    // the floor keeps the level of near silence from jumping about on every hop
+                    double lowLevel = std::log(levelFloor + lowEnergy / hopLength);
+                    double highLevel = std::log(levelFloor + highEnergy / hopLength);
+                    onsets.push_back((float) (juce::jmax(0.0, lowLevel - lastLowLevel) + juce::jmax(0.0, highLevel - lastHighLevel)));
+                    lastLowLevel = lowLevel;
+                    lastHighLevel = highLevel;
+                    lowEnergy = 0;
+                    highEnergy = 0;
+                    hopPosition = 0;
+                }
+            }
+        }
+
+        void finish(TrackAnalyser::Result& result) override
+        {
+            double frameRate = sampleRate / hopLength;
+            int minLag = (int) (60.0 * frameRate / maxBpm);
+            int maxLag = (int) std::ceil(60.0 * frameRate / minBpm);
+            int numFrames = (int) onsets.size();
+
+            if (numFrames < maxLag * 4)
+            {
+                return;
+            }
+
+            // take away the local mean so that only sudden rises are left
+            std::vector<float> envelope((size_t) numFrames);
+            int meanRadius = (int) (frameRate / 4);
+            double windowSum = 0;
+
+            for (int i = 0; i < juce::jmin(numFrames, meanRadius); ++i)
+            {
+                windowSum += onsets[(size_t) i];
+            }
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                if (i + meanRadius < numFrames)
+                {
+                    windowSum += onsets[(size_t) (i + meanRadius)];
+                }
+
+                if (i - meanRadius - 1 >= 0)
+                {
+                    windowSum -= onsets[(size_t) (i - meanRadius - 1)];
+                }
+
+                int windowLength = juce::jmin(numFrames - 1, i + meanRadius) - juce::jmax(0, i - meanRadius) + 1;
+                envelope[(size_t) i] = juce::jmax(0.0f, onsets[(size_t) i] - (float) (windowSum / windowLength));
+            }
+
+            // smooth what is left, so that onsets a frame apart from one beat to the next still line up
+            std::vector<float> smoothed((size_t) numFrames);
+
+            for (int i = 2; i + 2 < numFrames; ++i)
+            {
+                smoothed[(size_t) i] = (envelope[(size_t) (i - 2)] + 2.0f * envelope[(size_t) (i - 1)] + 3.0f * envelope[(size_t) i]
+                                        + 2.0f * envelope[(size_t) (i + 1)] + envelope[(size_t) (i + 2)]) / 9.0f;
+            }
+
+            envelope.swap(smoothed);
+
+            std::vector<double> correlation((size_t) (maxLag * 2 + 3));
+
+            for (int lag = minLag; lag < (int) correlation.size(); ++lag)
+            {
+                double sum = 0;
+
+                for (int i = 0; i + lag < numFrames; ++i)
+                {
+                    sum += envelope[(size_t) i] * envelope[(size_t) (i + lag)];
+                }
+
+                correlation[(size_t) lag] = sum / (numFrames - lag);
+            }
+
+            // a beat period also correlates at twice its length, which tips the balance towards the true tempo
+            std::vector<double> scores((size_t) (maxLag + 2));
+            int bestLag = -1;
+
+            for (int lag = minLag; lag <= maxLag + 1; ++lag)
+            {
+                double bpm = 60.0 * frameRate / lag;
+                double octaves = std::log2(bpm / 120.0);
+                scores[(size_t) lag] = std::exp(-0.5 * octaves * octaves) * (correlation[(size_t) lag] + 0.5 * correlation[(size_t) (lag * 2)]);
+
+                if (lag <= maxLag && (bestLag < 0 || scores[(size_t) lag] > scores[(size_t) bestLag]))
+                {
+                    bestLag = lag;
+                }
+            }
+
+            if (scores[(size_t) bestLag] <= 0)
+            {
+                return;
+            }
+
+            // fit a parabola through the peak to find the period between frames
+            double period = bestLag;
+
+            if (bestLag > minLag)
+            {
+                double before = scores[(size_t) (bestLag - 1)];
+                double peak = scores[(size_t) bestLag];
+                double after = scores[(size_t) (bestLag + 1)];
+                double curvature = before - 2.0 * peak + after;
+
+                if (curvature < 0)
+                {
+                    period += juce::jlimit(-0.5, 0.5, 0.5 * (before - after) / curvature);
+                }
+            }
+
+            // the grid is the period close to that and the phase whose beats land on the most onsets across
+            // the whole track, which pins the tempo down far more finely than one frame of lag
+            double coarsePeriod = period;
+            int bestPhase = 0;
+            double bestSum = -1;
+
+            for (int step = -gridSearchSteps; step <= gridSearchSteps; ++step)
+            {
+                double candidate = coarsePeriod + step * gridSearchStep;
+
+                for (int phase = 0; phase < (int) std::ceil(candidate); ++phase)
+                {
+                    double sum = 0;
+
+                    for (double frame = phase; frame < numFrames; frame += candidate)
+                    {
+                        sum += envelope[(size_t) frame];
+                    }
+
+                    if (sum > bestSum)
+                    {
+                        bestSum = sum;
+                        bestPhase = phase;
+                        period = candidate;
+                    }
+                }
+            }
+
+            // fit a parabola through the phases either side in the same way, so that the first beat is placed
+            // between frames rather than on the 5 ms grid of the onset envelope
+            double phase = bestPhase;
+            double before = getGridSum(envelope, bestPhase, period, -1.0);
+            double peak = getGridSum(envelope, bestPhase, period, 0.0);
+            double after = getGridSum(envelope, bestPhase, period, 1.0);
+            double curvature = before - 2.0 * peak + after;
+
+            if (curvature < 0)
+            {
+                phase += juce::jlimit(-0.5, 0.5, 0.5 * (before - after) / curvature);
+            }
+
+            if (phase < 0)
+            {
+                phase += period;
+            }
+
+            result.bpm = (float) (60.0 * frameRate / period);
+            result.firstBeat = (float) (phase * hopLength / sampleRate);
+        }
+
+        static constexpr double framesPerSecond = 200.0;
+        static constexpr double minBpm = 60.0;
+        static constexpr double maxBpm = 200.0;
+        static constexpr double levelFloor = 1.0e-5;
+
+        // periods tried either side of the autocorrelation's, in frames
+        static constexpr int gridSearchSteps = 50;
+        static constexpr double gridSearchStep = 0.02;
+
+    private:
+        // the envelope summed over the beats of a grid moved by up to a frame either way, read between frames
+        // where the beats fall. beats within a frame of either end are left out whatever the offset, so that
+        // every offset sums the same beats
+        static double getGridSum(const std::vector<float>& envelope, int phase, double period, double offset)
+        {
+            double sum = 0;
+
+            for (double beat = phase; beat + 2 < (double) envelope.size(); beat += period)
+            {
+                if (beat < 1)
+                {
+                    continue;
+                }
+
+                double frame = beat + offset;
+                size_t index = (size_t) frame;
+                double fraction = frame - (double) index;
+                sum += envelope[index] * (1.0 - fraction) + envelope[index + 1] * fraction;
+            }
+
+            return sum;
+        }
+
+        double sampleRate;
+        int hopLength;
+        int hopPosition = 0;
+        Biquad lowPass;
+        float lastSample = 0;
+        double lowEnergy = 0;
+        double highEnergy = 0;
+        double lastLowLevel = 0;
+        double lastHighLevel = 0;
+        std::vector<float> onsets;
+    };
+
+    // a chromagram from Goertzel filters on every semitone from C3 to B6, run over windowed frames of the
+    // mono signal decimated to below 11 kHz, matched against the Krumhansl-Kessler key profiles
+    class KeyAnalyser : public Analyser
+    {
+    public:
+        KeyAnalyser(double sampleRate) :
+                    decimation(juce::jmax(1, (int) (sampleRate / 8000.0))),
+                    frame(frameLength),
+                    window(frameLength)
+        {
+            double rate = sampleRate / decimation;
+
+            for (auto& filter : antiAlias)
+            {
+                filter.setLowPass(2500.0, 0.7071, sampleRate);
+            }
+
+            for (int note = 0; note < numNotes; ++note)
+            {
+                double frequency = 130.81278265 * std::pow(2.0, note / 12.0);
+                coefficients[note] = 2.0 * std::cos(juce::MathConstants<double>::twoPi * frequency / rate);
+            }
+
+            for (int i = 0; i < frameLength; ++i)
+            {
+                window[(size_t) i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * i / (frameLength - 1));
+            }
+        }
+
+        void process(const float* const* channels, int numChannels, int numSamples) override
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float mono = numChannels > 1 ? 0.5f * (channels[0][i] + channels[1][i]) : channels[0][i];
+                mono = antiAlias[1].process(antiAlias[0].process(mono));
+
+                if (++decimationPosition < decimation)
+                {
+                    continue;
+                }
+
+                decimationPosition = 0;
+                frame[(size_t) framePosition++] = mono;
+
+                if (framePosition == frameLength)
+                {
+                    addFrame();
+                    framePosition = 0;
+                }
+            }
+        }
+
+        void finish(TrackAnalyser::Result& result) override
+        {
+            static const double majorProfile[12] = { 6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 5.19, 2.39, 3.66, 2.29, 2.88 };
+            static const double minorProfile[12] = { 6.33, 2.68, 3.52, 5.38, 2.60, 3.53, 2.54, 4.75, 3.98, 2.69, 3.34, 3.17 };
+
+            if (std::accumulate(std::begin(chroma), std::end(chroma), 0.0) <= 0)
+            {
+                return;
+            }
+
+            double bestCorrelation = -2.0;
+
+            for (int key = 0; key < 24; ++key)
+            {
+                const double* profile = key < 12 ? majorProfile : minorProfile;
+                int tonic = key % 12;
+                double correlation = getCorrelation(profile, tonic);
+
+                if (correlation > bestCorrelation)
+                {
+                    bestCorrelation = correlation;
+                    result.key = key;
+                }
+            }
+        }
+
+        static constexpr int frameLength = 4096;
+        static constexpr int numNotes = 48;
+
+    private:
+        void addFrame()
+        {
+            for (int note = 0; note < numNotes; ++note)
+            {
+                double coefficient = coefficients[note];
+                double s1 = 0, s2 = 0;
+
+                for (int i = 0; i < frameLength; ++i)
+                {
+                    double s = frame[(size_t) i] * window[(size_t) i] + coefficient * s1 - s2;
+                    s2 = s1;
+                    s1 = s;
+                }
+
+                chroma[note % 12] += std::sqrt(juce::jmax(0.0, s1 * s1 + s2 * s2 - coefficient * s1 * s2));
+            }
+        }
+
+        // Pearson correlation of the chromagram with a profile rotated to start on the tonic
+        double getCorrelation(const double* profile, int tonic)
+        {
+            double chromaMean = std::accumulate(std::begin(chroma), std::end(chroma), 0.0) / 12.0;
+            double profileMean = std::accumulate(profile, profile + 12, 0.0) / 12.0;
+            double product = 0, chromaSquares = 0, profileSquares = 0;
+
+            for (int pitch = 0; pitch < 12; ++pitch)
+            {
+                double x = chroma[pitch] - chromaMean;
+                double y = profile[(pitch - tonic + 12) % 12] - profileMean;
+                product += x * y;
+                chromaSquares += x * x;
+                profileSquares += y * y;
+            }
+
+            return product / juce::jmax(1.0e-12, std::sqrt(chromaSquares * profileSquares));
+        }
+
+        int decimation;
+        int decimationPosition = 0;
+        Biquad antiAlias[2];
+        std::vector<float> frame;
+        std::vector<float> window;
+        int framePosition = 0;
+        double coefficients[numNotes] = {};
+        double chroma[12] = {};
+    };
+}
+
+class TrackAnalyser::AnalysisJob : public juce::ThreadPoolJob
+{
+public:
+    AnalysisJob(TrackAnalyser& _analyser, const juce::File& _file) :
+                juce::ThreadPoolJob("Analyse " + _file.getFileName()),
+                analyser(_analyser),
+                file(_file)
+    {
+
+    }
+
+    JobStatus runJob() override
+    {
+        Result result;
+        result.fileSize = file.getSize();
+        result.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+        // a track that cannot be decoded is still recorded, so it is not tried again until the file changes,
+        // but one cut short by shutting down is left for next time
+        if (analyser.analyseFile(file, result, *this) || shouldExit() == false)
+        {
+            analyser.finishJob(file.getFullPathName(), result);
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    TrackAnalyser& analyser;
+    juce::File file;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisJob)
+};
+
+TrackAnalyser::TrackAnalyser() :
+               pool(juce::SystemStats::getNumCpus(), 0, juce::Thread::Priority::low)
+{
+    formatManager.registerBasicFormats();
+    readFromAnalysisFile();
+}
+
+TrackAnalyser::~TrackAnalyser()
+{
+    // stop the jobs before saving, so the file only holds finished tracks
+    pool.removeAllJobs(true, 5000);
+
+    if (resultsDirty)
+    {
+        writeToAnalysisFile();
+    }
+}
+
+void TrackAnalyser::analyse(const juce::File& file)
+{
+    juce::String path = file.getFullPathName();
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+
+        auto it = results.find(path);
+
+        if (it != results.end() && it->second.fileSize == file.getSize()
+            && it->second.modificationTime == file.getLastModificationTime().toMilliseconds())
+        {
+            return;
+        }
+
+        if (pending.insert(path).second == false)
+        {
+            return;
+        }
+    }
+
+    pool.addJob(new AnalysisJob(*this, file), true);
+}
+
+bool TrackAnalyser::getResult(const juce::File& file, Result& result)
+{
+    const juce::ScopedLock scopedLock(lock);
+
+    auto it = results.find(file.getFullPathName());
+
+    if (it == results.end())
+    {
+        return false;
+    }
+
+    result = it->second;
+    return true;
+}
+
+bool TrackAnalyser::isPending(const juce::File& file)
+{
+    const juce::ScopedLock scopedLock(lock);
+    return pending.count(file.getFullPathName()) > 0;
+}
+
+int TrackAnalyser::getNumPending()
+{
+    const juce::ScopedLock scopedLock(lock);
+    return (int) pending.size();
+}
+
+int TrackAnalyser::getNumCompleted()
+{
+    return numCompleted;
+}
+
+void TrackAnalyser::setPlaybackActive(bool isActive)
+{
+    playbackActive = isActive;
+}
+
+void TrackAnalyser::setPlaybackCpuShare(float share)
+{
+    if (share <= 0 || share > 1)
+    {
+        DBG("TrackAnalyser::setPlaybackCpuShare share should be above 0 and at most 1");
+    }
+
+    else
+    {
+        playbackCpuShare = share;
+    }
+}
+
+float TrackAnalyser::getPlaybackCpuShare()
+{
+    return playbackCpuShare;
+}
+
+// key names as DJs read them, with the minor keys marked by m
+juce::String TrackAnalyser::getKeyName(int key)
+{
+    static const char* const noteNames[12] = { "C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+
+    if (juce::isPositiveAndBelow(key, 24) == false)
+    {
+        return "-";
+    }
+
+    return juce::String(noteNames[key % 12]) + (key < 12 ? "" : "m");
+}
+
+// decode the file once from start to end, handing each chunk to every analyser in turn
+bool TrackAnalyser::analyseFile(const juce::File& file, Result& result, juce::ThreadPoolJob& job)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr || reader->sampleRate <= 0 || reader->lengthInSamples <= 0)
+    {
+        DBG("TrackAnalyser::analyseFile could not read " << file.getFullPathName());
+        return false;
+    }
+
+    std::vector<std::unique_ptr<Analyser>> analysers;
+    analysers.push_back(std::make_unique<PeakAnalyser>());
+    analysers.push_back(std::make_unique<LoudnessAnalyser>(reader->sampleRate));
+    analysers.push_back(std::make_unique<TempoAnalyser>(reader->sampleRate));
+    analysers.push_back(std::make_unique<KeyAnalyser>(reader->sampleRate));
+
+    int numChannels = juce::jmin(2, (int) reader->numChannels);
+    juce::AudioBuffer<float> chunk(numChannels, chunkSize);
+    bool holdsSlot = false;
+
+    for (juce::int64 position = 0; position < reader->lengthInSamples; position += chunkSize)
+    {
+        if (acquireSlot(job, holdsSlot) == false)
+        {
+            return false;
+        }
+
+        juce::int64 chunkStart = juce::Time::getHighResolutionTicks();
+        int numSamples = (int) juce::jmin((juce::int64) chunkSize, reader->lengthInSamples - position);
+
+        if (reader->read(&chunk, 0, numSamples, position, true, true) == false)
+        {
+            releaseSlot(holdsSlot, 0);
+            return false;
+        }
+
+        for (auto& analyser : analysers)
+        {
+            analyser->process(chunk.getArrayOfReadPointers(), numChannels, numSamples);
+        }
+
+        releaseSlot(holdsSlot, juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - chunkStart));
+    }
+
+    for (auto& analyser : analysers)
+    {
+        analyser->finish(result);
+    }
+
+    result.analysed = true;
+    return true;
+}
+
+void TrackAnalyser::finishJob(const juce::String& path, const Result& result)
+{
+    {
+        const juce::ScopedLock scopedLock(lock);
+        results[path] = result;
+        pending.erase(path);
+        resultsDirty = true;
+    }
+
+    numCompleted++;
+
+    // save at most every saveIntervalMs, from whichever job gets there first while no save is running, so that
+    // a large import writes the file a few times rather than once per track and no job waits on another's save.
+    // a crash loses at most the last interval's tracks, and the destructor saves whatever is left
+    juce::uint32 now = juce::Time::getMillisecondCounter();
+
+    if (now - lastSaveMs >= saveIntervalMs)
+    {
+        const juce::ScopedTryLock scopedSaveLock(saveLock);
+
+        if (scopedSaveLock.isLocked())
+        {
+            lastSaveMs = now;
+            writeToAnalysisFile();
+        }
+    }
+}
+
+// while a deck plays only as many jobs as the share covers may decode at once, and each one idles
+// between chunks for long enough that together they use no more than the share of all the cores
+bool TrackAnalyser::acquireSlot(juce::ThreadPoolJob& job, bool& holdsSlot)
+{
+    holdsSlot = false;
+
+    while (job.shouldExit() == false)
+    {
+        if (playbackActive == false)
+        {
+            return true;
+        }
+
+        int numSlots = (int) std::ceil(playbackCpuShare * pool.getNumThreads());
+        int numBusy = numBusyJobs;
+
+        if (numBusy < numSlots && numBusyJobs.compare_exchange_weak(numBusy, numBusy + 1))
+        {
+            holdsSlot = true;
+            return true;
+        }
+
+        juce::Thread::sleep(slotWaitMs);
+    }
+
+    return false;
+}
+
+void TrackAnalyser::releaseSlot(bool& holdsSlot, double busySeconds)
+{
+    if (holdsSlot == false)
+    {
+        return;
+    }
+
+    float share = playbackCpuShare * pool.getNumThreads();
+    float dutyCycle = share / std::ceil(share);
+
+    if (dutyCycle < 1.0f)
+    {
+        juce::Thread::sleep(juce::jmin(1000, juce::roundToInt(busySeconds * 1000.0 * (1.0f / dutyCycle - 1.0f))));
+    }
+
+    numBusyJobs--;
+    holdsSlot = false;
+}
+
+void TrackAnalyser::readFromAnalysisFile()
+{
+    // open analysis.txt which holds the path, size, modification time and results of each analysed track
+    std::ifstream analysisFile("analysis.txt");
+    std::string line;
+    std::vector<std::string> lines;
+
+    while (std::getline(analysisFile, line))
+    {
+        lines.push_back(line);
+    }
+
+    for (int i = 0; i + 8 < (int) lines.size(); i += 9)
+    {
+        Result result;
+        result.fileSize = juce::String(lines[i + 1]).getLargeIntValue();
+        result.modificationTime = juce::String(lines[i + 2]).getLargeIntValue();
+        result.analysed = juce::String(lines[i + 3]).getIntValue() != 0;
+        result.bpm = juce::String(lines[i + 4]).getFloatValue();
+        result.firstBeat = juce::String(lines[i + 5]).getFloatValue();
+        result.key = juce::String(lines[i + 6]).getIntValue();
+        result.loudness = juce::String(lines[i + 7]).getFloatValue();
+        result.peak = juce::String(lines[i + 8]).getFloatValue();
+        results[juce::String(lines[i])] = result;
+    }
+
+    // close the file
+    analysisFile.close();
+}
+
+void TrackAnalyser::writeToAnalysisFile()
+{
+    // one save at a time, each from a copy of the results taken once it has its turn, so that the playlist
+    // is not kept waiting on the results while the file is written. a track finished after the copy marks
+    // the results dirty again for the next save
+    const juce::ScopedLock scopedSaveLock(saveLock);
+    std::map<juce::String, Result> savedResults;
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+        savedResults = results;
+        resultsDirty = false;
+    }
+
+    // write analysis.txt.tmp which holds the path, size, modification time and results of each analysed track,
+    // then move it over analysis.txt, so that the file is never left half written
+    std::ofstream analysisFile("analysis.txt.tmp");
+
+    for (auto& entry : savedResults)
+    {
+        const Result& result = entry.second;
+        analysisFile << entry.first << std::endl << result.fileSize << std::endl << result.modificationTime << std::endl
+                     << (result.analysed ? 1 : 0) << std::endl << result.bpm << std::endl << result.firstBeat << std::endl
+                     << result.key << std::endl << result.loudness << std::endl << result.peak << std::endl;
+    }
+
+    // close the file
+    analysisFile.close();
+
+    if (analysisFile.fail() == false)
+    {
+        juce::File directory = juce::File::getCurrentWorkingDirectory();
+        directory.getChildFile("analysis.txt.tmp").moveFileTo(directory.getChildFile("analysis.txt"));
+    }
+}
\ No newline at end of file
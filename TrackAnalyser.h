@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    TrackAnalyser.h
+    Created: 17 Oct 2026 8:47:19pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <set>
+
+// decodes every imported track once on a pool of background threads, one track per core, and feeds the
+// decoded blocks to the tempo, key, loudness and peak analysers in the same pass, keeping the results in
+// analysis.txt next to playlist.txt so a track is only analysed again if the file changes
+class TrackAnalyser
+{
+public:
+    struct Result
+    {
+        juce::int64 fileSize = 0;
+        juce::int64 modificationTime = 0;
+        bool analysed = false;
+
+        // the beat grid starts at firstBeat seconds and repeats every 60 / bpm seconds, bpm is 0 if no tempo was found
+        float bpm = 0;
+        float firstBeat = 0;
+
+        // 0 to 11 for C major up to B major, 12 to 23 for C minor up to B minor, -1 if unknown
+        int key = -1;
+
+        // integrated loudness in LUFS following ITU-R BS.1770, and sample peak in dBFS
+        float loudness = -100.0f;
+        float peak = -100.0f;
+    };
+
+    TrackAnalyser();
+    ~TrackAnalyser();
+
+    // queue the file unless it has been analysed already or is waiting to be
+    void analyse(const juce::File& file);
+
+    // copies the result for the file and returns true once it has been analysed
+    bool getResult(const juce::File& file, Result& result);
+    bool isPending(const juce::File& file);
+    int getNumPending();
+
+    // goes up each time a track finishes, so the playlist knows when to repaint
+    int getNumCompleted();
+
+    // while a deck plays, analysis is held to this fraction of all cores so the audio keeps its headroom
+    void setPlaybackActive(bool isActive);
+    void setPlaybackCpuShare(float share);
+    float getPlaybackCpuShare();
+
+    static juce::String getKeyName(int key);
+
+    static constexpr float defaultPlaybackCpuShare = 0.25f;
+
+private:
+    class AnalysisJob;
+
+    bool analyseFile(const juce::File& file, Result& result, juce::ThreadPoolJob& job);
+    void finishJob(const juce::String& path, const Result& result);
+
+    // blocks until the job may decode another chunk, returns false if it should stop
+    bool acquireSlot(juce::ThreadPoolJob& job, bool& holdsSlot);
+    void releaseSlot(bool& holdsSlot, double busySeconds);
+
+    void readFromAnalysisFile();
+    void writeToAnalysisFile();
+
+    juce::AudioFormatManager formatManager;
+    juce::CriticalSection lock;
+    juce::CriticalSection saveLock;
+    std::map<juce::String, Result> results;
+    std::set<juce::String> pending;
+    std::atomic<int> numCompleted{ 0 };
+
+    // set when a track finishes and cleared when the results are copied for a save
+    std::atomic<bool> resultsDirty{ false };
+    std::atomic<juce::uint32> lastSaveMs{ 0 };
+
+    std::atomic<bool> playbackActive{ false };
+    std::atomic<float> playbackCpuShare{ defaultPlaybackCpuShare };
+    std::atomic<int> numBusyJobs{ 0 };
+
+    // declared last so that its threads are stopped before anything they use is destroyed
+    juce::ThreadPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackAnalyser)
+};
\ No newline at end of file
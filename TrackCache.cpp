@@ -0,0 +1,373 @@
+/*
+  ==============================================================================
+
+    TrackCache.cpp
+    Created: 17 Oct 2026 10:12:41am
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "TrackCache.h"
+#include "SeekIndexedReader.h"
+
+// reads decoded samples from a cache entry, falling back to the file for anything not decoded yet
+class TrackCache::CachedReader : public juce::AudioFormatReader
+{
+public:
+    CachedReader(std::shared_ptr<Entry> _entry, juce::AudioFormatReader* _fileReader) :
+                 juce::AudioFormatReader(nullptr, _fileReader->getFormatName()),
+                 entry(std::move(_entry)),
+                 fileReader(_fileReader)
+    {
+        sampleRate = fileReader->sampleRate;
+        bitsPerSample = 32;
+        lengthInSamples = fileReader->lengthInSamples;
+        numChannels = fileReader->numChannels;
+        usesFloatingPointData = true;
+        metadataValues = fileReader->metadataValues;
+    }
+
+    bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                     juce::int64 startSampleInFile, int numSamples) override
+    {
+        clearSamplesBeyondAvailableLength(destChannels, numDestChannels, startOffsetInDestBuffer,
+                                          startSampleInFile, numSamples, lengthInSamples);
+
+        if (numSamples <= 0)
+        {
+            return true;
+        }
+
+        // copy the part of the block which has already been decoded
+        juce::int64 numDecoded = entry->numSamplesDecoded.load(std::memory_order_acquire);
+        int numResident = (int) juce::jlimit((juce::int64) 0, (juce::int64) numSamples, numDecoded - startSampleInFile);
+
+        if (numResident > 0)
+        {
+            copyToDestination(entry->samples, (int) startSampleInFile, destChannels, numDestChannels, startOffsetInDestBuffer, numResident);
+        }
+
+        // decode the rest from the file
+        if (numResident < numSamples)
+        {
+            int numToRead = numSamples - numResident;
+            scratchBuffer.setSize((int) numChannels, numToRead, false, false, true);
+
+            if (fileReader->read(&scratchBuffer, 0, numToRead, startSampleInFile + numResident, true, true) == false)
+            {
+                return false;
+            }
+
+            copyToDestination(scratchBuffer, 0, destChannels, numDestChannels, startOffsetInDestBuffer + numResident, numToRead);
+        }
+
+        return true;
+    }
+
+private:
+    void copyToDestination(const juce::AudioBuffer<float>& source, int sourceStart, int* const* destChannels,
+                           int numDestChannels, int destStart, int numSamples)
+    {
+        for (int channel = 0; channel < numDestChannels; ++channel)
+        {
+            if (auto* dest = reinterpret_cast<float*>(destChannels[channel]))
+            {
+                if (channel < source.getNumChannels())
+                {
+                    juce::FloatVectorOperations::copy(dest + destStart, source.getReadPointer(channel, sourceStart), numSamples);
+                }
+
+                else
+                {
+                    juce::FloatVectorOperations::clear(dest + destStart, numSamples);
+                }
+            }
+        }
+    }
+
+    std::shared_ptr<Entry> entry;
+    std::unique_ptr<juce::AudioFormatReader> fileReader;
+    juce::AudioBuffer<float> scratchBuffer;
+};
+
+juce::int64 TrackCache::Entry::getSizeInBytes() const
+{
+    return (juce::int64) samples.getNumChannels() * samples.getNumSamples() * (juce::int64) sizeof(float);
+}
+
+bool TrackCache::Entry::isComplete() const
+{
+    return numSamplesDecoded.load() >= samples.getNumSamples();
+}
+
+TrackCache::TrackCache(juce::AudioFormatManager& _formatManager, juce::int64 _memoryBudget) :
+                       juce::Thread("Track cache fill"),
+                       formatManager(_formatManager),
+                       memoryBudget(_memoryBudget)
+{
+    startThread();
+}
+
+TrackCache::~TrackCache()
+{
+    signalThreadShouldExit();
+    fillRequested.signal();
+    stopThread(4000);
+}
+
+juce::AudioFormatReader* TrackCache::createReaderFor(const juce::File& file, juce::AudioFormatReader* fileReader)
+{
+    if (fileReader == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Entry> entry = findEntry(file);
+
+    if (entry != nullptr)
+    {
+        hitCount++;
+    }
+
+    else
+    {
+        // tracks too long to address in one buffer are always played from the file
+        if (fileReader->lengthInSamples <= 0 || fileReader->lengthInSamples > std::numeric_limits<int>::max())
+        {
+            missCount++;
+            return fileReader;
+        }
+
+        juce::int64 numBytes = fileReader->lengthInSamples * fileReader->numChannels * (juce::int64) sizeof(float);
+        const juce::ScopedLock sl(lock);
+
+        // look again with the lock held until the entry is added, since another deck may have missed on the same
+        // track since the first look and added it, and two copies would both be decoded and both use the budget
+        entry = findEntry(file);
+
+        if (entry != nullptr)
+        {
+            hitCount++;
+        }
+
+        else
+        {
+            missCount++;
+
+            // if nothing can be evicted to fit the track within the budget, play it from the file
+            if (makeRoomFor(numBytes) == false)
+            {
+                return fileReader;
+            }
+
+            residentBytes += numBytes;
+
+            entry = std::make_shared<Entry>();
+            entry->path = file.getFullPathName();
+            entry->modificationTime = file.getLastModificationTime();
+            entry->sampleRate = fileReader->sampleRate;
+            entry->samples.setSize((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
+            entry->lastUsed = ++useCounter;
+            entries.push_back(entry);
+            fillQueue.push_back(entry);
+            fillRequested.signal();
+        }
+    }
+
+    return new CachedReader(entry, fileReader);
+}
+
+juce::AudioFormatReader* TrackCache::createResidentReaderFor(const juce::File& file, juce::AudioFormatReader* fileReader)
+{
+    if (fileReader == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Entry> entry = findEntry(file);
+
+    if (entry == nullptr)
+    {
+        return fileReader;
+    }
+
+    return new CachedReader(entry, fileReader);
+}
+
+bool TrackCache::isFullyResident(const juce::File& file)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto& entry : entries)
+    {
+        if (entry->path == file.getFullPathName() && entry->modificationTime == file.getLastModificationTime())
+        {
+            return entry->isComplete();
+        }
+    }
+
+    return false;
+}
+
+void TrackCache::setMemoryBudget(juce::int64 numBytes)
+{
+    const juce::ScopedLock sl(lock);
+    memoryBudget = numBytes;
+    makeRoomFor(0);
+}
+
+juce::int64 TrackCache::getMemoryBudget()
+{
+    const juce::ScopedLock sl(lock);
+    return memoryBudget;
+}
+
+juce::int64 TrackCache::getResidentBytes()
+{
+    const juce::ScopedLock sl(lock);
+    return residentBytes;
+}
+
+int TrackCache::getNumTracks()
+{
+    const juce::ScopedLock sl(lock);
+    return (int) entries.size();
+}
+
+int TrackCache::getHitCount()
+{
+    return hitCount;
+}
+
+int TrackCache::getMissCount()
+{
+    return missCount;
+}
+
+// decode queued tracks one after another in the background
+void TrackCache::run()
+{
+    while (threadShouldExit() == false)
+    {
+        std::shared_ptr<Entry> entry;
+
+        {
+            const juce::ScopedLock sl(lock);
+
+            if (fillQueue.empty() == false)
+            {
+                entry = fillQueue.front();
+                fillQueue.erase(fillQueue.begin());
+            }
+        }
+
+        if (entry == nullptr)
+        {
+            fillRequested.wait(500);
+        }
+
+        else
+        {
+            fillEntry(*entry);
+        }
+    }
+}
+
+void TrackCache::fillEntry(Entry& entry)
+{
+    // decode MP3 files through their frame index too, so that cached samples line up with the ones played from the file
+    std::unique_ptr<juce::AudioFormatReader> reader(SeekIndexedReader::createFor(juce::File(entry.path), formatManager));
+
+    if (reader == nullptr)
+    {
+        reader.reset(formatManager.createReaderFor(juce::File(entry.path)));
+    }
+
+    if (reader == nullptr)
+    {
+        return;
+    }
+
+    const int chunkSize = 65536;
+    juce::int64 length = entry.samples.getNumSamples();
+
+    // publish each chunk as soon as it is decoded so readers can use it straight away
+    for (juce::int64 start = 0; start < length; start += chunkSize)
+    {
+        if (threadShouldExit() || entry.evicted)
+        {
+            return;
+        }
+
+        int numToRead = (int) juce::jmin((juce::int64) chunkSize, length - start);
+        reader->read(&entry.samples, (int) start, numToRead, start, true, true);
+        entry.numSamplesDecoded.store(start + numToRead, std::memory_order_release);
+    }
+}
+
+// find the entry for a file and mark it as most recently used, lock is taken here
+std::shared_ptr<TrackCache::Entry> TrackCache::findEntry(const juce::File& file)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = entries.begin(); it != entries.end(); it++)
+    {
+        std::shared_ptr<Entry> entry = *it;
+
+        if (entry->path == file.getFullPathName())
+        {
+            // the file has changed on disk since it was cached, so drop the stale copy rather than keep it beside
+            // the new one, a deck still reading it keeps it alive and reads the rest from its own file
+            if (entry->modificationTime != file.getLastModificationTime())
+            {
+                entry->evicted = true;
+                residentBytes -= entry->getSizeInBytes();
+                entries.erase(it);
+                return nullptr;
+            }
+
+            entry->lastUsed = ++useCounter;
+            return entry;
+        }
+    }
+
+    return nullptr;
+}
+
+// evict least recently used tracks that no deck is playing until numBytes more fit in the budget,
+// must be called with the lock held
+bool TrackCache::makeRoomFor(juce::int64 numBytes)
+{
+    if (numBytes > memoryBudget)
+    {
+        return false;
+    }
+
+    while (residentBytes + numBytes > memoryBudget)
+    {
+        auto leastRecentlyUsed = entries.end();
+
+        for (auto it = entries.begin(); it != entries.end(); it++)
+        {
+            // an entry shared with a reader or the fill queue is still in use
+            bool inUse = it->use_count() > 1;
+
+            if (inUse == false && (leastRecentlyUsed == entries.end() || (*it)->lastUsed < (*leastRecentlyUsed)->lastUsed))
+            {
+                leastRecentlyUsed = it;
+            }
+        }
+
+        if (leastRecentlyUsed == entries.end())
+        {
+            return false;
+        }
+
+        (*leastRecentlyUsed)->evicted = true;
+        residentBytes -= (*leastRecentlyUsed)->getSizeInBytes();
+        entries.erase(leastRecentlyUsed);
+    }
+
+    return true;
+}
\ No newline at end of file
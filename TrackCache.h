@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    TrackCache.h
+    Created: 17 Oct 2026 10:12:41am
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class TrackCache : private juce::Thread
+{
+public:
+    TrackCache(juce::AudioFormatManager& _formatManager, juce::int64 _memoryBudget = defaultMemoryBudget);
+    ~TrackCache() override;
+
+    // wrap a reader for the file so that reads are served from decoded RAM once resident,
+    // queueing the file to be decoded in the background if it is not cached yet
+    juce::AudioFormatReader* createReaderFor(const juce::File& file, juce::AudioFormatReader* fileReader);
+
+    // wrap a reader for the file over whatever of it is already cached, without counting a hit or miss or
+    // queueing a decode, for extra readers of a track that is already loaded, returns fileReader if there is none
+    juce::AudioFormatReader* createResidentReaderFor(const juce::File& file, juce::AudioFormatReader* fileReader);
+
+    bool isFullyResident(const juce::File& file);
+
+    void setMemoryBudget(juce::int64 numBytes);
+    juce::int64 getMemoryBudget();
+    juce::int64 getResidentBytes();
+    int getNumTracks();
+    int getHitCount();
+    int getMissCount();
+
+    static constexpr juce::int64 defaultMemoryBudget = (juce::int64) 1024 * 1024 * 1024;
+
+private:
+    struct Entry
+    {
+        juce::String path;
+        juce::Time modificationTime;
+        double sampleRate = 0;
+        juce::AudioBuffer<float> samples;
+        std::atomic<juce::int64> numSamplesDecoded{ 0 };
+        std::atomic<bool> evicted{ false };
+        juce::uint32 lastUsed = 0;
+
+        juce::int64 getSizeInBytes() const;
+        bool isComplete() const;
+    };
+
+    class CachedReader;
+
+    void run() override;
+    void fillEntry(Entry& entry);
+    std::shared_ptr<Entry> findEntry(const juce::File& file);
+    bool makeRoomFor(juce::int64 numBytes);
+
+    juce::AudioFormatManager& formatManager;
+    juce::CriticalSection lock;
+    std::vector<std::shared_ptr<Entry>> entries;
+    std::vector<std::shared_ptr<Entry>> fillQueue;
+    juce::WaitableEvent fillRequested;
+    juce::int64 memoryBudget;
+    juce::int64 residentBytes = 0;
+    juce::uint32 useCounter = 0;
+    std::atomic<int> hitCount{ 0 };
+    std::atomic<int> missCount{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackCache)
+};
\ No newline at end of file
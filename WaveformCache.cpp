@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    WaveformCache.cpp
+    Created: 17 Oct 2026 10:58:40pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "WaveformCache.h"
+
+namespace
+{
+    // "OTWC" at the start of each cache file, followed by the format version
+    const int cacheMagic = 0x4357544f;
+    const int cacheVersion = 1;
+}
+
+WaveformCache::WaveformCache(juce::int64 _sizeLimit, const juce::File& _directory) :
+                             sizeLimit(_sizeLimit),
+                             directory(_directory)
+{
+
+}
+
+WaveformCache::~WaveformCache()
+{
+
+}
+
+std::shared_ptr<WaveformPyramid> WaveformCache::load(const juce::File& track)
+{
+    juce::File cacheFile = getCacheFileFor(track);
+    juce::FileInputStream stream(cacheFile);
+
+    // the cheap checks come first, so that a changed track is turned away before its contents are read
+    bool valid = stream.openedOk() && stream.readInt() == cacheMagic && stream.readInt() == cacheVersion
+                 && stream.readString() == track.getFullPathName() && stream.readInt64() == track.getSize()
+                 && stream.readInt64() == track.getLastModificationTime().toMilliseconds()
+                 && stream.readString() == hashContents(track);
+
+    auto pyramid = std::make_shared<WaveformPyramid>();
+
+    if (valid == false || pyramid->readFrom(stream) == false)
+    {
+        missCount++;
+        return nullptr;
+    }
+
+    hitCount++;
+    touch(cacheFile, cacheFile.getSize());
+
+    return pyramid;
+}
+
+bool WaveformCache::store(const juce::File& track, const WaveformPyramid& pyramid)
+{
+    juce::File cacheFile = getCacheFileFor(track);
+    directory.createDirectory();
+
+    // write beside the entry and move it into place, so that a reader never sees half a file
+    juce::TemporaryFile temporary(cacheFile);
+
+    {
+        juce::FileOutputStream stream(temporary.getFile());
+
+        if (stream.openedOk() == false)
+        {
+            DBG("WaveformCache::store could not write " << temporary.getFile().getFullPathName());
+            return false;
+        }
+
+        stream.writeInt(cacheMagic);
+        stream.writeInt(cacheVersion);
+        stream.writeString(track.getFullPathName());
+        stream.writeInt64(track.getSize());
+        stream.writeInt64(track.getLastModificationTime().toMilliseconds());
+        stream.writeString(hashContents(track));
+
+        if (pyramid.writeTo(stream) == false)
+        {
+            DBG("WaveformCache::store could not write " << temporary.getFile().getFullPathName());
+            return false;
+        }
+    }
+
+    if (temporary.overwriteTargetFileWithTemporary() == false)
+    {
+        return false;
+    }
+
+    const juce::ScopedLock sl(lock);
+    scanDirectory();
+    touch(cacheFile, cacheFile.getSize());
+    evict(cacheFile);
+
+    return true;
+}
+
+void WaveformCache::setSizeLimit(juce::int64 numBytes)
+{
+    const juce::ScopedLock sl(lock);
+    sizeLimit = numBytes;
+    scanDirectory();
+    evict(juce::File());
+}
+
+juce::int64 WaveformCache::getSizeLimit()
+{
+    const juce::ScopedLock sl(lock);
+    return sizeLimit;
+}
+
+juce::int64 WaveformCache::getCachedBytes()
+{
+    const juce::ScopedLock sl(lock);
+    scanDirectory();
+    return cachedBytes;
+}
+
+int WaveformCache::getNumEntries()
+{
+    const juce::ScopedLock sl(lock);
+    scanDirectory();
+    return (int) entries.size();
+}
+
+int WaveformCache::getHitCount()
+{
+    return hitCount;
+}
+
+int WaveformCache::getMissCount()
+{
+    return missCount;
+}
+
+juce::File WaveformCache::getDefaultDirectory()
+{
+    return juce::File::getCurrentWorkingDirectory().getChildFile("waveforms");
+}
+
+juce::String WaveformCache::hashContents(const juce::File& track)
+{
+    juce::FileInputStream stream(track);
+
+    if (stream.openedOk() == false)
+    {
+        return {};
+    }
+
+    juce::int64 size = stream.getTotalLength();
+    juce::MemoryOutputStream sampled;
+    sampled.writeInt64(size);
+
+    for (juce::int64 start : { (juce::int64) 0, size / 2 - hashBlockSize / 2, size - hashBlockSize })
+    {
+        stream.setPosition(juce::jmax((juce::int64) 0, start));
+        sampled.writeFromInputStream(stream, hashBlockSize);
+    }
+
+    return juce::MD5(sampled.getMemoryBlock()).toHexString();
+}
+
+juce::File WaveformCache::getCacheFileFor(const juce::File& track)
+{
+    return directory.getChildFile(juce::String::toHexString(track.getFullPathName().hashCode64()) + ".wave");
+}
+
+// called with the lock held, lists the entries already on disk with their last use kept as the file's time
+void WaveformCache::scanDirectory()
+{
+    if (scanned)
+    {
+        return;
+    }
+
+    scanned = true;
+
+    for (auto& file : directory.findChildFiles(juce::File::findFiles, false, "*.wave"))
+    {
+        Entry entry;
+        entry.file = file;
+        entry.size = file.getSize();
+        entry.lastUsed = file.getLastModificationTime().toMilliseconds();
+        entries.push_back(entry);
+        cachedBytes += entry.size;
+    }
+}
+
+// mark the entry as just used, on disk as well so that the order survives a restart
+void WaveformCache::touch(const juce::File& cacheFile, juce::int64 size)
+{
+    juce::Time now = juce::Time::getCurrentTime();
+    cacheFile.setLastModificationTime(now);
+
+    const juce::ScopedLock sl(lock);
+
+    // until the directory has been listed there is nothing in memory to update
+    if (scanned == false)
+    {
+        return;
+    }
+
+    for (auto& entry : entries)
+    {
+        if (entry.file == cacheFile)
+        {
+            cachedBytes += size - entry.size;
+            entry.size = size;
+            entry.lastUsed = now.toMilliseconds();
+            return;
+        }
+    }
+
+    entries.push_back({ cacheFile, size, now.toMilliseconds() });
+    cachedBytes += size;
+}
+
+// called with the lock held, deletes the least recently used entries other than keep until the cache fits its limit
+void WaveformCache::evict(const juce::File& keep)
+{
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed > b.lastUsed; });
+
+    while (cachedBytes > sizeLimit && entries.empty() == false && entries.back().file != keep)
+    {
+        entries.back().file.deleteFile();
+        cachedBytes -= entries.back().size;
+        entries.pop_back();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    WaveformCache.h
+    Created: 17 Oct 2026 10:58:40pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WaveformPyramid.h"
+
+// keeps each track's waveform pyramid on disk between runs, so that a track seen before is drawn without decoding
+// it again. an entry is only used while the track's path, size, modification time and a hash of samples of its
+// contents all still match, and once the cache grows past its size limit the least recently used entries go first
+class WaveformCache
+{
+public:
+    WaveformCache(juce::int64 _sizeLimit = defaultSizeLimit, const juce::File& _directory = getDefaultDirectory());
+    ~WaveformCache();
+
+    // the saved pyramid for the track, or nullptr if there is none or the track has changed since, safe on any thread
+    std::shared_ptr<WaveformPyramid> load(const juce::File& track);
+
+    // save the pyramid for the track, evicting older entries if that takes the cache over its limit
+    bool store(const juce::File& track, const WaveformPyramid& pyramid);
+
+    void setSizeLimit(juce::int64 numBytes);
+    juce::int64 getSizeLimit();
+    juce::int64 getCachedBytes();
+    int getNumEntries();
+    int getHitCount();
+    int getMissCount();
+
+    static juce::File getDefaultDirectory();
+
+    // an MD5 of the track's size and a block from its start, middle and end, which catches a track rewritten
+    // with the same size and time without reading all of it
+    static juce::String hashContents(const juce::File& track);
+
+    static constexpr juce::int64 defaultSizeLimit = (juce::int64) 1024 * 1024 * 1024;
+    static constexpr int hashBlockSize = 65536;
+
+private:
+    struct Entry
+    {
+        juce::File file;
+        juce::int64 size = 0;
+        juce::int64 lastUsed = 0;
+    };
+
+    juce::File getCacheFileFor(const juce::File& track);
+    void scanDirectory();
+    void touch(const juce::File& cacheFile, juce::int64 size);
+    void evict(const juce::File& keep);
+
+    juce::int64 sizeLimit;
+    juce::File directory;
+
+    // the entries are listed from the directory the first time they are needed, rather than at startup
+    juce::CriticalSection lock;
+    std::vector<Entry> entries;
+    bool scanned = false;
+    juce::int64 cachedBytes = 0;
+    std::atomic<int> hitCount{ 0 };
+    std::atomic<int> missCount{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformCache)
+};
\ No newline at end of file
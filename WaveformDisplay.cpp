@@ -1,83 +1,187 @@
-/*
-  ==============================================================================
-
-    WaveformDisplay.cpp
-    Created: 4 Feb 2023 8:29:34pm
-    Author:  cheng
-
-  ==============================================================================
-*/
-
-#include "WaveformDisplay.h"
-
-WaveformDisplay::WaveformDisplay(juce::AudioFormatManager & formatManagerToUse,
-                                 juce::AudioThumbnailCache & cacheToUse) :
-                                 audioThumb(1000, formatManagerToUse, cacheToUse),
-                                 fileLoaded(false),
-                                 position(0)
-{
-    // add change listener to audio thumbnail
-    audioThumb.addChangeListener(this);
-}
-
-WaveformDisplay::~WaveformDisplay()
-{
-
-}
-
-void WaveformDisplay::paint(juce::Graphics& g)
-{
-    // set background colour
-    g.fillAll(juce::Colour(35, 47, 52));
-
-    // draw border around waveform display
-    g.setColour(juce::Colours::grey);
-    g.drawRect(getLocalBounds(), 1);
-
-    // set waveform colour
-    g.setColour(juce::Colour(167, 172, 174));
-
-    // if file loaded, draw waveform
-    if (fileLoaded)
-    {
-        audioThumb.drawChannel(g, getLocalBounds(), 0, audioThumb.getTotalLength(), 0, 1.0f);
-        g.drawImageWithin(markerImage, position * getWidth(), -20, 10, getHeight() + 40, juce::RectanglePlacement::fillDestination);
-    }
-
-    // else, display "NO TRACK LOADED"
-    else
-    {
-        g.setColour(juce::Colours::white);
-        g.setFont(17);
-        g.drawText("NO TRACK LOADED", getLocalBounds(),
-            juce::Justification::centred, true);
-    }
-}
-
-void WaveformDisplay::resized()
-{
-
-}
-
-// load waveform display
-void WaveformDisplay::loadURL(juce::URL audioURL)
-{
-    audioThumb.clear();
-    fileLoaded = audioThumb.setSource(new juce::URLInputSource(audioURL));
-}
-
-// update waveform display when new track is loaded
-void WaveformDisplay::changeListenerCallback(juce::ChangeBroadcaster* source)
-{
-    repaint();
-}
-
-// set position relative of waveform display
-void WaveformDisplay::setPositionRelative(double pos)
-{
-    if (pos != position)
-    {
-        position = pos;
-        repaint();
-    }
+/*
+  ==============================================================================
+
+    WaveformDisplay.cpp
+    Created: 4 Feb 2023 8:29:34pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "WaveformDisplay.h"
+
+WaveformDisplay::WaveformDisplay(juce::AudioFormatManager & formatManagerToUse,
+                                 WaveformCache & cacheToUse) :
+                                 fileLoaded(false),
+                                 fileLoading(false),
+                                 formatManager(formatManagerToUse),
+                                 cache(cacheToUse),
+                                 position(0),
+                                 loadGeneration(0)
+{
+    overview.setMarkerImage(juce::ImageFileFormat::loadFrom(BinaryData::marker2_png, BinaryData::marker2_pngSize));
+}
+
+WaveformDisplay::~WaveformDisplay()
+{
+    // stop a build part way through rather than wait for the whole track to be decoded
+    ++loadGeneration;
+    readerPool.removeAllJobs(true, 10000);
+}
+
+void WaveformDisplay::paint(juce::Graphics& g)
+{
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+    // if file loaded, copy the rendered waveform, which is only drawn again when it has been thrown away, and
+    // draw the marker over it
+    if (fileLoaded && overview.getPyramid() != nullptr)
+    {
+        overview.draw(g, getLocalBounds(), g.getInternalContext().getPhysicalPixelScaleFactor(), position);
+    }
+
+    // while the reader is being created, display "LOADING..."
+    else if (fileLoading)
+    {
+        g.fillAll(juce::Colour(35, 47, 52));
+        g.setColour(juce::Colours::grey);
+        g.drawRect(getLocalBounds(), 1);
+
+        g.setColour(juce::Colours::white);
+        g.setFont(17);
+        g.drawText("LOADING...", getLocalBounds(),
+            juce::Justification::centred, true);
+    }
+
+    // else, display "NO TRACK LOADED"
+    else
+    {
+        g.fillAll(juce::Colour(35, 47, 52));
+        g.setColour(juce::Colours::grey);
+        g.drawRect(getLocalBounds(), 1);
+
+        g.setColour(juce::Colours::white);
+        g.setFont(17);
+        g.drawText("NO TRACK LOADED", getLocalBounds(),
+            juce::Justification::centred, true);
+    }
+
+    lastPaintMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    averagePaintMs += (lastPaintMs - averagePaintMs) * 0.05;
+}
+
+// the waveform is rendered again at the new size on the next paint
+void WaveformDisplay::resized()
+{
+    overview.invalidate();
+}
+
+// load waveform display on a background thread, from the disk cache for a track seen before, otherwise by
+// decoding the track once into a pyramid of peaks, so that neither ever blocks the UI
+void WaveformDisplay::loadURL(juce::URL audioURL)
+{
+    overview.setPyramid(nullptr);
+    fileLoaded = false;
+    fileLoading = true;
+    repaint();
+
+    if (onPyramidChanged != nullptr)
+    {
+        onPyramidChanged(nullptr);
+    }
+
+    int generation = ++loadGeneration;
+    juce::Component::SafePointer<WaveformDisplay> safeThis(this);
+
+    readerPool.addJob([this, safeThis, audioURL, generation]
+    {
+        double startTime = juce::Time::getMillisecondCounterHiRes();
+        juce::File file = audioURL.isLocalFile() ? audioURL.getLocalFile() : juce::File();
+        auto newPyramid = file.existsAsFile() ? cache.load(file) : nullptr;
+        bool cached = newPyramid != nullptr;
+        bool built = cached;
+
+        if (cached == false)
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(audioURL.createInputStream(false)));
+            newPyramid = std::make_shared<WaveformPyramid>();
+
+            // give up as soon as another track is loaded into the deck, or the pool asks the job to stop
+            auto* job = juce::ThreadPoolJob::getCurrentThreadPoolJob();
+
+            built = reader != nullptr && newPyramid->build(*reader, [this, generation, job]
+            {
+                return generation != loadGeneration || (job != nullptr && job->shouldExit());
+            });
+
+            if (built && file.existsAsFile())
+            {
+                cache.store(file, *newPyramid);
+            }
+        }
+
+        if (built)
+        {
+            DBG("WaveformDisplay::loadURL " << (cached ? "read " : "built ") << audioURL.getFileName() << " in "
+                << juce::Time::getMillisecondCounterHiRes() - startTime << " ms");
+        }
+
+        juce::MessageManager::callAsync([safeThis, newPyramid, built, generation]
+        {
+            if (safeThis == nullptr || generation != safeThis->loadGeneration || safeThis->fileLoading == false)
+            {
+                return;
+            }
+
+            safeThis->fileLoading = false;
+            safeThis->fileLoaded = built;
+
+            if (built)
+            {
+                safeThis->overview.setPyramid(newPyramid);
+
+                if (safeThis->onPyramidChanged != nullptr)
+                {
+                    safeThis->onPyramidChanged(newPyramid);
+                }
+            }
+
+            safeThis->repaint();
+        });
+    });
+}
+
+// set position relative of waveform display
+void WaveformDisplay::setPositionRelative(double pos)
+{
+    if (pos == position)
+    {
+        return;
+    }
+
+    auto oldArea = overview.getMarkerArea(getLocalBounds(), position);
+    auto newArea = overview.getMarkerArea(getLocalBounds(), pos);
+    position = pos;
+
+    // only the strips the marker leaves and enters need painting, and nothing at all until it moves a whole pixel
+    if (fileLoaded && oldArea != newArea)
+    {
+        repaint(oldArea);
+        repaint(newArea);
+    }
+}
+
+double WaveformDisplay::getLastPaintMs()
+{
+    return lastPaintMs;
+}
+
+double WaveformDisplay::getAveragePaintMs()
+{
+    return averagePaintMs;
+}
+
+int WaveformDisplay::getNumImageRenders()
+{
+    return overview.getNumImageRenders();
 }
\ No newline at end of file
@@ -1,40 +1,58 @@
-/*
-  ==============================================================================
-
-    WaveformDisplay.h
-    Created: 4 Feb 2023 8:29:34pm
-    Author:  cheng
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-class WaveformDisplay : public juce::Component,
-                        public juce::ChangeListener
-{
-public:
-    WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
-                    juce::AudioThumbnailCache& cacheToUse);
-    ~WaveformDisplay() override;
-
-    void paint(juce::Graphics&) override;
-    void resized() override;
-
-    void loadURL(juce::URL audioURL);
-
-    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
-
-    void setPositionRelative(double pos);
-
-    bool fileLoaded;
-
-private:
-    juce::AudioThumbnail audioThumb;
-    double position;
-    juce::Image markerImage{ juce::ImageFileFormat::loadFrom(BinaryData::marker2_png, BinaryData::marker2_pngSize) };
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformDisplay)
+/*
+  ==============================================================================
+
+    WaveformDisplay.h
+    Created: 4 Feb 2023 8:29:34pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WaveformCache.h"
+#include "WaveformOverviewRenderer.h"
+
+// the whole track's waveform, rendered once into an image whenever the track or the size changes, with the
+// playhead marker drawn over it so that moving the marker only repaints the strips it leaves and enters
+class WaveformDisplay : public juce::Component
+{
+public:
+    WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
+                    WaveformCache& cacheToUse);
+    ~WaveformDisplay() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+    void loadURL(juce::URL audioURL);
+
+    void setPositionRelative(double pos);
+
+    // how long paint took, last time and on average, and how many times the waveform image has been rendered
+    double getLastPaintMs();
+    double getAveragePaintMs();
+    int getNumImageRenders();
+
+    // called on the message thread with the pyramid of each track once it is ready, and with nullptr when it is dropped
+    std::function<void(std::shared_ptr<WaveformPyramid>)> onPyramidChanged;
+
+    bool fileLoaded;
+    bool fileLoading;
+
+private:
+    juce::AudioFormatManager& formatManager;
+    WaveformCache& cache;
+    double position;
+
+    // holds the pyramid, built on the reader pool and only swapped in on the message thread, and the waveform
+    // image at the display's physical pixel scale
+    WaveformOverviewRenderer overview;
+    double lastPaintMs = 0;
+    double averagePaintMs = 0;
+    std::atomic<int> loadGeneration;
+    juce::ThreadPool readerPool{ 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformDisplay)
 };
\ No newline at end of file
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    WaveformOverviewRenderer.cpp
+    Created: 17 Oct 2026 11:52:27pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "WaveformOverviewRenderer.h"
+
+WaveformOverviewRenderer::WaveformOverviewRenderer()
+{
+
+}
+
+WaveformOverviewRenderer::~WaveformOverviewRenderer()
+{
+
+}
+
+void WaveformOverviewRenderer::setPyramid(std::shared_ptr<WaveformPyramid> newPyramid)
+{
+    pyramid = newPyramid;
+    waveformImage = juce::Image();
+}
+
+std::shared_ptr<WaveformPyramid> WaveformOverviewRenderer::getPyramid()
+{
+    return pyramid;
+}
+
+void WaveformOverviewRenderer::setMarkerImage(const juce::Image& image)
+{
+    markerImage = image;
+}
+
+void WaveformOverviewRenderer::invalidate()
+{
+    waveformImage = juce::Image();
+}
+
+void WaveformOverviewRenderer::draw(juce::Graphics& g, juce::Rectangle<int> bounds, float scale, double position)
+{
+    if (pyramid == nullptr)
+    {
+        return;
+    }
+
+    int width = juce::jmax(1, juce::roundToInt(bounds.getWidth() * scale));
+    int height = juce::jmax(1, juce::roundToInt(bounds.getHeight() * scale));
+
+    if (waveformImage.isNull() || waveformImage.getWidth() != width || waveformImage.getHeight() != height || scale != imageScale)
+    {
+        render(bounds, scale);
+    }
+
+    g.drawImage(waveformImage, bounds.toFloat());
+    g.drawImageWithin(markerImage, bounds.getX() + (int) (position * bounds.getWidth()), bounds.getY() - markerOverhang,
+                      markerWidth, bounds.getHeight() + markerOverhang * 2, juce::RectanglePlacement::fillDestination);
+}
+
+juce::Rectangle<int> WaveformOverviewRenderer::getMarkerArea(juce::Rectangle<int> bounds, double position) const
+{
+    return juce::Rectangle<int>(bounds.getX() + (int) std::floor(position * bounds.getWidth()) - 1, bounds.getY(),
+                                markerWidth + 2, bounds.getHeight());
+}
+
+int WaveformOverviewRenderer::getNumImageRenders()
+{
+    return numImageRenders;
+}
+
+// set background colour, draw border and draw waveform into the image, each column coloured by how much
+// low, mid and high it has, with the RMS brighter on top
+void WaveformOverviewRenderer::render(juce::Rectangle<int> bounds, float scale)
+{
+    waveformImage = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(bounds.getWidth() * scale)),
+                                juce::jmax(1, juce::roundToInt(bounds.getHeight() * scale)), false);
+    imageScale = scale;
+    numImageRenders++;
+
+    // draw in physical pixels, so that there is one waveform column per pixel of the screen rather than per logical one
+    juce::Graphics g(waveformImage);
+    int border = juce::jmax(1, juce::roundToInt(scale));
+    g.fillAll(juce::Colour(35, 47, 52));
+    g.setColour(juce::Colours::grey);
+    g.drawRect(waveformImage.getBounds(), border);
+
+    pyramid->draw(g, waveformImage.getBounds().reduced(0, border), 0, pyramid->getLengthInSamples(),
+                  juce::Colour(167, 172, 174), juce::Colour(215, 219, 221), true);
+}
\ No newline at end of file
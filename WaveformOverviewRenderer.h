@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    WaveformOverviewRenderer.h
+    Created: 17 Oct 2026 11:52:27pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WaveformPyramid.h"
+
+// draws the whole track's waveform into an image once per track and size, and composites the playhead marker
+// over it on every paint. it holds no component, so the same frames can be drawn off screen
+class WaveformOverviewRenderer
+{
+public:
+    WaveformOverviewRenderer();
+    ~WaveformOverviewRenderer();
+
+    // the pyramid of the loaded track, nullptr while there is none
+    void setPyramid(std::shared_ptr<WaveformPyramid> newPyramid);
+    std::shared_ptr<WaveformPyramid> getPyramid();
+
+    // drawn at the playhead, stretched to markerWidth and overhanging the top and bottom by markerOverhang
+    void setMarkerImage(const juce::Image& image);
+
+    // throw the waveform image away, so that it is rendered again on the next draw
+    void invalidate();
+
+    // copy the waveform image into bounds, rendering it first at scale physical pixels per logical one if the
+    // size or scale has changed, and draw the marker at position, from 0 to 1, over it
+    void draw(juce::Graphics& g, juce::Rectangle<int> bounds, float scale, double position);
+
+    // the strip covered by the marker at a position, with a pixel either side for its antialiased edges
+    juce::Rectangle<int> getMarkerArea(juce::Rectangle<int> bounds, double position) const;
+
+    int getNumImageRenders();
+
+    static constexpr int markerWidth = 10;
+    static constexpr int markerOverhang = 20;
+
+private:
+    void render(juce::Rectangle<int> bounds, float scale);
+
+    std::shared_ptr<WaveformPyramid> pyramid;
+
+    // the background, border and waveform at the physical pixel scale, empty until next drawn
+    juce::Image waveformImage;
+    float imageScale = 0;
+    int numImageRenders = 0;
+    juce::Image markerImage;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformOverviewRenderer)
+};
\ No newline at end of file
@@ -0,0 +1,509 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.cpp
+    Created: 17 Oct 2026 10:31:06pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#include "WaveformPyramid.h"
+#include "DeckEqualiser.h"
+
+namespace
+{
+    // "OTWP" at the start of the binary form, followed by the format version
+    const int magic = 0x5057544f;
+    const int version = 2;
+
+    // scale to the stored bytes, rounding outwards so that a quantised peak never looks smaller than it was
+    juce::int8 toPeakByte(float value, bool roundUp)
+    {
+        float scaled = juce::jlimit(-1.0f, 1.0f, value) * 127.0f;
+        return (juce::int8) (roundUp ? std::ceil(scaled) : std::floor(scaled));
+    }
+
+    juce::uint8 toRmsByte(float meanSquare)
+    {
+        return (juce::uint8) juce::jlimit(0, 255, juce::roundToInt(std::sqrt(meanSquare) * 255.0f));
+    }
+
+    // a byte of 1 is still about -96 dB, where the RMS byte would have reached 0 at -48 dB
+    juce::uint8 toBandByte(float meanSquare)
+    {
+        return (juce::uint8) juce::jlimit(0, 255, juce::roundToInt(std::sqrt(std::sqrt(meanSquare)) * 255.0f));
+    }
+
+    float fromBandByte(float value)
+    {
+        float root = value / 255.0f;
+        return root * root;
+    }
+
+    const juce::Colour lowColour(229, 57, 53);
+    const juce::Colour midColour(8, 227, 169);
+    const juce::Colour highColour(11, 174, 244);
+}
+
+WaveformPyramid::WaveformPyramid()
+{
+
+}
+
+WaveformPyramid::~WaveformPyramid()
+{
+
+}
+
+bool WaveformPyramid::build(juce::AudioFormatReader& reader, const std::function<bool()>& shouldStop, bool withBands)
+{
+    levels.clear();
+    lengthInSamples = reader.lengthInSamples;
+    sampleRate = reader.sampleRate;
+
+    if (lengthInSamples <= 0 || reader.numChannels == 0)
+    {
+        return false;
+    }
+
+    // the finest level is worked out in floats first, with the mean square rather than the RMS, so that the
+    // coarser levels can be reduced from it exactly before everything is quantised
+    int numChannels = juce::jmin(2, (int) reader.numChannels);
+    size_t numBins = (size_t) ((lengthInSamples + baseBinSize - 1) / baseBinSize);
+    std::vector<float> mins(numBins), maxs(numBins), meanSquares(numBins);
+    juce::AudioBuffer<float> buffer(numChannels, chunkSize);
+    size_t bin = 0;
+
+    // each band's power per sample, from the same crossovers the EQ uses, then its mean square per bin
+    std::vector<float> bandMeanSquares[3];
+    juce::AudioBuffer<float> bandPower(3, withBands ? chunkSize : 0);
+    DeckEqualiser::BandSplitter splitter;
+
+    if (withBands)
+    {
+        splitter.prepare(sampleRate);
+
+        for (auto& band : bandMeanSquares)
+        {
+            band.resize(numBins);
+        }
+    }
+
+    for (juce::int64 start = 0; start < lengthInSamples; start += chunkSize)
+    {
+        if (shouldStop != nullptr && shouldStop())
+        {
+            levels.clear();
+            return false;
+        }
+
+        int numSamples = (int) juce::jmin((juce::int64) chunkSize, lengthInSamples - start);
+
+        if (reader.read(&buffer, 0, numSamples, start, true, numChannels > 1) == false)
+        {
+            levels.clear();
+            return false;
+        }
+
+        if (withBands)
+        {
+            splitter.process(buffer.getReadPointer(0), numChannels > 1 ? buffer.getReadPointer(1) : nullptr, numSamples,
+                             bandPower.getWritePointer(0), bandPower.getWritePointer(1), bandPower.getWritePointer(2));
+        }
+
+        for (int offset = 0; offset < numSamples; offset += baseBinSize, ++bin)
+        {
+            int binLength = juce::jmin(baseBinSize, numSamples - offset);
+            float binMin = 1.0f;
+            float binMax = -1.0f;
+            float sumSquares = 0;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const float* samples = buffer.getReadPointer(channel, offset);
+                auto range = juce::FloatVectorOperations::findMinAndMax(samples, binLength);
+                binMin = juce::jmin(binMin, range.getStart());
+                binMax = juce::jmax(binMax, range.getEnd());
+
+                for (int i = 0; i < binLength; ++i)
+                {
+                    sumSquares += samples[i] * samples[i];
+                }
+            }
+
+            mins[bin] = binMin;
+            maxs[bin] = binMax;
+            meanSquares[bin] = sumSquares / (float) (binLength * numChannels);
+
+            if (withBands)
+            {
+                for (int band = 0; band < 3; ++band)
+                {
+                    const float* power = bandPower.getReadPointer(band, offset);
+                    float sum = 0;
+
+                    for (int i = 0; i < binLength; ++i)
+                    {
+                        sum += power[i];
+                    }
+
+                    bandMeanSquares[band][bin] = sum / (float) (binLength * numChannels);
+                }
+            }
+        }
+    }
+
+    // quantise each level, then reduce it by levelFactor into the next until the whole track is one bin
+    while (true)
+    {
+        std::vector<Bin> level(mins.size());
+
+        for (size_t i = 0; i < mins.size(); ++i)
+        {
+            level[i].min = toPeakByte(mins[i], false);
+            level[i].max = toPeakByte(maxs[i], true);
+            level[i].rms = toRmsByte(meanSquares[i]);
+
+            if (withBands)
+            {
+                level[i].low = toBandByte(bandMeanSquares[0][i]);
+                level[i].mid = toBandByte(bandMeanSquares[1][i]);
+                level[i].high = toBandByte(bandMeanSquares[2][i]);
+            }
+        }
+
+        levels.push_back(std::move(level));
+
+        if (mins.size() <= 1)
+        {
+            break;
+        }
+
+        size_t numCoarseBins = (mins.size() + levelFactor - 1) / levelFactor;
+
+        for (size_t i = 0; i < numCoarseBins; ++i)
+        {
+            size_t first = i * levelFactor;
+            size_t last = juce::jmin(first + levelFactor, mins.size());
+            float coarseMin = mins[first];
+            float coarseMax = maxs[first];
+            float sum = 0;
+            float bandSums[3] = {};
+
+            for (size_t j = first; j < last; ++j)
+            {
+                coarseMin = juce::jmin(coarseMin, mins[j]);
+                coarseMax = juce::jmax(coarseMax, maxs[j]);
+                sum += meanSquares[j];
+
+                for (int band = 0; band < 3 && withBands; ++band)
+                {
+                    bandSums[band] += bandMeanSquares[band][j];
+                }
+            }
+
+            mins[i] = coarseMin;
+            maxs[i] = coarseMax;
+            meanSquares[i] = sum / (float) (last - first);
+
+            for (int band = 0; band < 3 && withBands; ++band)
+            {
+                bandMeanSquares[band][i] = bandSums[band] / (float) (last - first);
+            }
+        }
+
+        mins.resize(numCoarseBins);
+        maxs.resize(numCoarseBins);
+        meanSquares.resize(numCoarseBins);
+
+        for (auto& band : bandMeanSquares)
+        {
+            band.resize(withBands ? numCoarseBins : 0);
+        }
+    }
+
+    return true;
+}
+
+bool WaveformPyramid::writeTo(juce::OutputStream& stream) const
+{
+    stream.writeInt(magic);
+    stream.writeInt(version);
+    stream.writeDouble(sampleRate);
+    stream.writeInt64(lengthInSamples);
+    stream.writeInt(baseBinSize);
+    stream.writeInt(levelFactor);
+    stream.writeInt((int) levels.size());
+
+    for (auto& level : levels)
+    {
+        stream.writeInt((int) level.size());
+
+        if (stream.write(level.data(), level.size() * sizeof(Bin)) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// only reads pyramids built with the same bin sizes, anything else is treated as missing
+bool WaveformPyramid::readFrom(juce::InputStream& stream)
+{
+    levels.clear();
+
+    if (stream.readInt() != magic || stream.readInt() != version)
+    {
+        return false;
+    }
+
+    sampleRate = stream.readDouble();
+    lengthInSamples = stream.readInt64();
+
+    if (stream.readInt() != baseBinSize || stream.readInt() != levelFactor)
+    {
+        return false;
+    }
+
+    int numLevels = stream.readInt();
+
+    if (numLevels <= 0 || numLevels > 64 || lengthInSamples <= 0)
+    {
+        return false;
+    }
+
+    juce::int64 expectedBins = (lengthInSamples + baseBinSize - 1) / baseBinSize;
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+        int numBins = stream.readInt();
+
+        if (numBins != expectedBins)
+        {
+            levels.clear();
+            return false;
+        }
+
+        std::vector<Bin> level((size_t) numBins);
+
+        if (stream.read(level.data(), (int) (level.size() * sizeof(Bin))) != (int) (level.size() * sizeof(Bin)))
+        {
+            levels.clear();
+            return false;
+        }
+
+        levels.push_back(std::move(level));
+        expectedBins = (expectedBins + levelFactor - 1) / levelFactor;
+    }
+
+    return true;
+}
+
+int WaveformPyramid::getNumLevels() const
+{
+    return (int) levels.size();
+}
+
+int WaveformPyramid::getNumBins(int level) const
+{
+    return juce::isPositiveAndBelow(level, (int) levels.size()) ? (int) levels[(size_t) level].size() : 0;
+}
+
+const WaveformPyramid::Bin* WaveformPyramid::getBins(int level) const
+{
+    return juce::isPositiveAndBelow(level, (int) levels.size()) ? levels[(size_t) level].data() : nullptr;
+}
+
+juce::int64 WaveformPyramid::getBinSize(int level) const
+{
+    juce::int64 binSize = baseBinSize;
+
+    for (int i = 0; i < level; ++i)
+    {
+        binSize *= levelFactor;
+    }
+
+    return binSize;
+}
+
+juce::int64 WaveformPyramid::getLengthInSamples() const
+{
+    return lengthInSamples;
+}
+
+double WaveformPyramid::getSampleRate() const
+{
+    return sampleRate;
+}
+
+size_t WaveformPyramid::getSizeInBytes() const
+{
+    size_t numBytes = 0;
+
+    for (auto& level : levels)
+    {
+        numBytes += level.size() * sizeof(Bin);
+    }
+
+    return numBytes;
+}
+
+int WaveformPyramid::chooseLevel(double samplesPerPixel) const
+{
+    int level = 0;
+
+    while (level + 1 < (int) levels.size() && (double) getBinSize(level + 1) <= samplesPerPixel)
+    {
+        level++;
+    }
+
+    return level;
+}
+
+void WaveformPyramid::getRange(int level, juce::int64 startSample, juce::int64 endSample, float& min, float& max, float& rms) const
+{
+    min = 0;
+    max = 0;
+    rms = 0;
+
+    if (juce::isPositiveAndBelow(level, (int) levels.size()) == false)
+    {
+        return;
+    }
+
+    auto& bins = levels[(size_t) level];
+    juce::int64 binSize = getBinSize(level);
+    juce::int64 first = juce::jlimit((juce::int64) 0, (juce::int64) bins.size(), startSample / binSize);
+    juce::int64 last = juce::jlimit(first, (juce::int64) bins.size(), (endSample + binSize - 1) / binSize);
+
+    // a range narrower than a bin still shows the bin it falls in
+    if (last == first && first < (juce::int64) bins.size())
+    {
+        last = first + 1;
+    }
+
+    if (last <= first)
+    {
+        return;
+    }
+
+    int binMin = 127;
+    int binMax = -127;
+    float sumSquares = 0;
+
+    for (juce::int64 i = first; i < last; ++i)
+    {
+        const Bin& bin = bins[(size_t) i];
+        binMin = juce::jmin(binMin, (int) bin.min);
+        binMax = juce::jmax(binMax, (int) bin.max);
+        sumSquares += (float) bin.rms * (float) bin.rms;
+    }
+
+    min = binMin / 127.0f;
+    max = binMax / 127.0f;
+    rms = std::sqrt(sumSquares / (float) (last - first)) / 255.0f;
+}
+
+void WaveformPyramid::getBands(int level, juce::int64 startSample, juce::int64 endSample, float& low, float& mid, float& high) const
+{
+    low = 0;
+    mid = 0;
+    high = 0;
+
+    if (juce::isPositiveAndBelow(level, (int) levels.size()) == false)
+    {
+        return;
+    }
+
+    auto& bins = levels[(size_t) level];
+    juce::int64 binSize = getBinSize(level);
+    juce::int64 first = juce::jlimit((juce::int64) 0, (juce::int64) bins.size(), startSample / binSize);
+    juce::int64 last = juce::jlimit(first, (juce::int64) bins.size(), (endSample + binSize - 1) / binSize);
+
+    if (last == first && first < (juce::int64) bins.size())
+    {
+        last = first + 1;
+    }
+
+    if (last <= first)
+    {
+        return;
+    }
+
+    // average the mean squares rather than the stored roots
+    for (juce::int64 i = first; i < last; ++i)
+    {
+        const Bin& bin = bins[(size_t) i];
+        float lowRms = fromBandByte(bin.low);
+        float midRms = fromBandByte(bin.mid);
+        float highRms = fromBandByte(bin.high);
+        low += lowRms * lowRms;
+        mid += midRms * midRms;
+        high += highRms * highRms;
+    }
+
+    low = std::sqrt(low / (float) (last - first));
+    mid = std::sqrt(mid / (float) (last - first));
+    high = std::sqrt(high / (float) (last - first));
+}
+
+juce::Colour WaveformPyramid::getBandColour(float low, float mid, float high)
+{
+    float total = low + mid + high;
+
+    if (total <= 0)
+    {
+        return juce::Colour(167, 172, 174);
+    }
+
+    return juce::Colour::fromFloatRGBA((lowColour.getFloatRed() * low + midColour.getFloatRed() * mid + highColour.getFloatRed() * high) / total,
+                                       (lowColour.getFloatGreen() * low + midColour.getFloatGreen() * mid + highColour.getFloatGreen() * high) / total,
+                                       (lowColour.getFloatBlue() * low + midColour.getFloatBlue() * mid + highColour.getFloatBlue() * high) / total,
+                                       1.0f);
+}
+
+void WaveformPyramid::draw(juce::Graphics& g, juce::Rectangle<int> area, juce::int64 startSample, juce::int64 endSample,
+                           juce::Colour peakColour, juce::Colour rmsColour, bool byBand) const
+{
+    if (levels.empty() || area.getWidth() <= 0 || endSample <= startSample)
+    {
+        return;
+    }
+
+    double samplesPerPixel = (double) (endSample - startSample) / area.getWidth();
+    int level = chooseLevel(samplesPerPixel);
+    float centre = (float) area.getCentreY();
+    float halfHeight = area.getHeight() * 0.5f;
+
+    for (int x = 0; x < area.getWidth(); ++x)
+    {
+        juce::int64 columnStart = startSample + (juce::int64) (x * samplesPerPixel);
+        juce::int64 columnEnd = startSample + (juce::int64) ((x + 1) * samplesPerPixel);
+
+        if (columnStart >= lengthInSamples || columnEnd <= 0)
+        {
+            continue;
+        }
+
+        float min, max, rms;
+        getRange(level, columnStart, columnEnd, min, max, rms);
+
+        if (byBand)
+        {
+            float low, mid, high;
+            getBands(level, columnStart, columnEnd, low, mid, high);
+
+            // mixed by the square root of each band's RMS, or the bass would colour nearly every column
+            peakColour = getBandColour(std::sqrt(low), std::sqrt(mid), std::sqrt(high));
+            rmsColour = peakColour.brighter(0.6f);
+        }
+
+        float column = (float) (area.getX() + x);
+        g.setColour(peakColour);
+        g.drawVerticalLine((int) column, centre - max * halfHeight, centre - min * halfHeight + 1.0f);
+        g.setColour(rmsColour);
+        g.drawVerticalLine((int) column, centre - rms * halfHeight, centre + rms * halfHeight + 1.0f);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.h
+    Created: 17 Oct 2026 10:31:06pm
+    Author:  cheng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// the min, max and RMS of a track at every zoom level, from baseBinSize samples per bin up to a single bin for
+// the whole track, each level levelFactor times coarser than the one below. it is built from one decode of the
+// track and then drawn at any zoom by reading a handful of bins per pixel, without touching the audio again.
+// each bin also keeps how much low, mid and high it has, split at the EQ's crossovers, to colour it by
+class WaveformPyramid
+{
+public:
+    // one bin, with min and max scaled to -127..127 and RMS to 0..255 of full scale, across all channels, and
+    // the RMS of each band as the fourth root of its mean square so that quiet highs still register
+    struct Bin
+    {
+        juce::int8 min = 0;
+        juce::int8 max = 0;
+        juce::uint8 rms = 0;
+        juce::uint8 low = 0;
+        juce::uint8 mid = 0;
+        juce::uint8 high = 0;
+    };
+
+    WaveformPyramid();
+    ~WaveformPyramid();
+
+    // decode the whole track in chunks and build every level, safe to call on any thread, returns false if the track
+    // could not be read or shouldStop returned true part way through, and leaves the bands empty without withBands
+    bool build(juce::AudioFormatReader& reader, const std::function<bool()>& shouldStop = nullptr, bool withBands = true);
+
+    // the compact binary form, a short header followed by the raw bins of each level
+    bool writeTo(juce::OutputStream& stream) const;
+    bool readFrom(juce::InputStream& stream);
+
+    int getNumLevels() const;
+    int getNumBins(int level) const;
+    const Bin* getBins(int level) const;
+    juce::int64 getBinSize(int level) const;
+
+    juce::int64 getLengthInSamples() const;
+    double getSampleRate() const;
+    size_t getSizeInBytes() const;
+
+    // the coarsest level whose bins are no wider than samplesPerPixel, so a pixel never reads more than levelFactor bins
+    int chooseLevel(double samplesPerPixel) const;
+
+    // min, max and RMS from -1 to 1 of the samples from startSample up to endSample, read from the given level,
+    // and the RMS of the low, mid and high bands
+    void getRange(int level, juce::int64 startSample, juce::int64 endSample, float& min, float& max, float& rms) const;
+    void getBands(int level, juce::int64 startSample, juce::int64 endSample, float& low, float& mid, float& high) const;
+
+    // the band colours mixed in proportion to each band's share of the column's level
+    static juce::Colour getBandColour(float low, float mid, float high);
+
+    // draw the samples from startSample to endSample across the area, one column per pixel, with the peaks
+    // in peakColour and the RMS on top of them in rmsColour, or with byBand in each column's band colour
+    // and a brighter shade of it
+    void draw(juce::Graphics& g, juce::Rectangle<int> area, juce::int64 startSample, juce::int64 endSample,
+              juce::Colour peakColour, juce::Colour rmsColour, bool byBand = false) const;
+
+    static constexpr int baseBinSize = 32;
+    static constexpr int levelFactor = 4;
+
+    // samples decoded at a time while building, a whole number of base bins
+    static constexpr int chunkSize = 65536;
+
+private:
+    std::vector<std::vector<Bin>> levels;
+    juce::int64 lengthInSamples = 0;
+    double sampleRate = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPyramid)
+};
\ No newline at end of file